@@ -23,15 +23,21 @@ Dissemination::~Dissemination() {
 /**
  * Takes only the information about requested edges
  */
-vector<Data> Dissemination::getTrafficInformationToSend(Knowledge & knowledge, vector<string> edges) {
+vector<Data> Dissemination::getTrafficInformationToSend(Knowledge & knowledge, const vector<string> & edges) {
 	vector<Data> trafficData;
-	if (knowledge.getRecords().size() > 0) {
-		for (vector<string>::iterator it = edges.begin(); it != edges.end(); ++it) {
-			if (knowledge.getRecords().find(*it) != knowledge.getRecords().end()) {
+	const KnowledgeStore & records = knowledge.getRecords();
+	if (records.size() > 0) {
+		for (vector<string>::const_iterator it = edges.begin(); it != edges.end(); ++it) {
+			StringId edgeId;
+			if (!StringInterner::getInstance().find(*it, edgeId)) {
+				continue; // never heard of
+			}
+			const RecordEntry * record = records.find(edgeId);
+			if (record != 0) {
 				Data data;
-				data.edgeId = *it;
-				data.date = knowledge.getRecords()[*it].getLatestTime();
-				data.travelTime = knowledge.getRecords()[*it].getLatestValue();
+				data.edgeId = edgeId;
+				data.date = record->getLatestTime();
+				data.travelTime = record->getLatestValue();
 				trafficData.push_back(data);
 			}
 		}
@@ -35,7 +35,7 @@ public:
 	Dissemination();
 	virtual ~Dissemination();
 
-	vector<Data> getTrafficInformationToSend(Knowledge &knowledge, std::vector<std::string> edges);
+	vector<Data> getTrafficInformationToSend(Knowledge &knowledge, const std::vector<std::string> & edges);
 	void TryRebroadcast(OvnisPacket packet, double packetDate, std::string vehicleId);
 };
 }
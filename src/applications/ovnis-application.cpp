@@ -48,6 +48,8 @@
 
 #include "ns3/udp-socket-factory.h"
 #include "ns3/inet-socket-address.h"
+#include "ns3/packet-socket-factory.h"
+#include "ns3/packet-socket-address.h"
 
 #include "ns3/wifi-net-device.h"
 
@@ -109,11 +111,33 @@ void OvnisApplication::StopApplication(void) {
 	cout << "OvnisApplication::StopApplication" << endl;
 }
 
-void OvnisApplication::SetParams(std::map <string,string> params) {
+void OvnisApplication::SetParams(const std::map <string,string> & params) {
 	_applicationParams = params;
 }
 
 void OvnisApplication::ReceiveData(Ptr<Socket> x) {
 }
 
+Ptr<Socket> OvnisApplication::CreateBroadcastSocket(uint16_t port) {
+	Ptr<Node> node = GetNode();
+	if (node->GetObject<Ipv4>() != 0) {
+		Ptr<Socket> socket = Socket::CreateSocket(node, UdpSocketFactory::GetTypeId());
+		socket->SetAllowBroadcast(true);
+		socket->Bind(InetSocketAddress(Ipv4Address::GetAny(), port));
+		socket->Connect(InetSocketAddress(Ipv4Address::GetBroadcast(), port));
+		return socket;
+	}
+	// no IP, UDP, ARP headers: the packet goes to the LLC of the device as it is
+	Ptr<NetDevice> device = node->GetDevice(0);
+	PacketSocketAddress local;
+	local.SetSingleDevice(device->GetIfIndex());
+	local.SetProtocol(OVNIS_PROTOCOL_NUMBER);
+	PacketSocketAddress broadcast = local;
+	broadcast.SetPhysicalAddress(device->GetBroadcast());
+	Ptr<Socket> socket = Socket::CreateSocket(node, PacketSocketFactory::GetTypeId());
+	socket->Bind(local);
+	socket->Connect(broadcast);
+	return socket;
+}
+
 }
@@ -72,7 +72,16 @@ namespace ns3
 
     void SetStopTime (Time stop);
 
-    virtual void SetParams(std::map <string,string> params);
+    virtual void SetParams(const std::map <string,string> & params);
+
+    /**
+     * Socket broadcasting to the one-hop neighbors, through UDP on port when the
+     * node has the internet stack, else straight on its wifi device (see
+     * OVNIS_PROTOCOL_NUMBER). The socket is bound and connected: Send broadcasts
+     * and RecvFrom gives the packets of the neighbors, with the MAC address of the
+     * sender in a PacketSocketAddress in the second case.
+     */
+    Ptr<Socket> CreateBroadcastSocket(uint16_t port);
 
   private:
 
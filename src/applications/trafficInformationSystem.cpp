@@ -19,6 +19,7 @@ TIS & TIS::getInstance() {
 
 TIS::TIS() {
 	congestion = false;
+	customizationDate = -ROUTING_CUSTOMIZATION_INTERVAL;
 	traci = Names::Find<ovnis::SumoTraciConnection>("SumoTraci");
 }
 
@@ -26,8 +27,8 @@ TIS::~TIS() {
 }
 
 
-void TIS::reportStartingRoute(string vehicleId, string currentEdgeId, string currentRouteId, string newEdgeId, string newRouteId,
-		string originEdgeId, string destinationEdgeId, bool isCheater, bool isCongested,
+void TIS::reportStartingRoute(const string & vehicleId, const string & currentEdgeId, const string & currentRouteId, const string & newEdgeId, const string & newRouteId,
+		const string & originEdgeId, const string & destinationEdgeId, bool isCheater, bool isCongested,
 		double expectedTravelTime, double shortestExpectedTravelTime) {
 	// xxx only one entering on route - no need for subtract
 	++vehiclesOnRoute[newRouteId];
@@ -37,22 +38,51 @@ void TIS::reportStartingRoute(string vehicleId, string currentEdgeId, string cur
 	Log::getInstance().getStream("routing_start") << endl;
 }
 
-void TIS::reportEndingEdge(string vehicleId, string edgeId, double travelTime) {
-	perfectTravelTimes[edgeId].add(0, "", Simulator::Now().GetSeconds(), travelTime);
+void TIS::reportEndingEdge(const string & vehicleId, const string & edgeId, double travelTime) {
+	perfectTravelTimes[intern(edgeId)].add(0, NO_STRING_ID, Simulator::Now().GetSeconds(), travelTime);
 }
 
-std::map<std::string, RecordEntry> TIS::getPerfectTravelTimes() {
+const KnowledgeStore & TIS::getPerfectTravelTimes() {
 	return perfectTravelTimes;
 }
 
-void TIS::reportEndingRoute(string vehicleId, string routeId, string startEdgeId, string endEdgeId,
+void TIS::getEdgeWeights(const RoadGraph & graph, vector<double> & weights) {
+	graph.getStaticCosts(weights);
+	double now = Simulator::Now().GetSeconds();
+	const vector<StringId> & edges = perfectTravelTimes.getEdges();
+	for (vector<StringId>::const_iterator it = edges.begin(); it != edges.end(); ++it) {
+		uint32_t edge = graph.getEdge(*it);
+		const RecordEntry * entry = perfectTravelTimes.find(*it);
+		if (edge != RoadGraph::NOT_FOUND && entry->getLatestValue() > 0 && now - entry->getLatestTime() < CENTRALISED_INFORMATION_TTL) {
+			weights[edge] = entry->getLatestValue();
+		}
+	}
+}
+
+const RoutingEngine & TIS::getRoutingEngine() {
+	double now = Simulator::Now().GetSeconds();
+	if (routingEngine == 0) {
+		// not by Create(), which would pass a copy of the graph
+		routingEngine = Ptr<RoutingEngine>(new RoutingEngine(traci->GetRoadGraph()), false);
+	}
+	if (now - customizationDate >= ROUTING_CUSTOMIZATION_INTERVAL) {
+		vector<double> weights;
+		getEdgeWeights(routingEngine->getGraph(), weights);
+		routingEngine->customize(weights);
+		customizationDate = now;
+	}
+	return *routingEngine;
+}
+
+void TIS::reportEndingRoute(const string & vehicleId, const string & routeId, const string & startEdgeId, const string & endEdgeId,
 		double startReroute, double travelTime, bool isCheater, double selfishExpectedTravelTime, double expectedTravelTime, bool wasCongested,
-		string routingStrategy, double start) {
+		const string & routingStrategy, double start, double drivenStaticCost) {
 	--vehiclesOnRoute[routeId];
 	travelTimeDateOnRoute[routeId] = Simulator::Now().GetSeconds();
 	travelTimesOnRoute[routeId] = travelTime;
 //	travelTimesOnRoute[routeId] = alfa*travelTime + (1-alfa)*travelTimesOnRoute[routeId]; // smooth
-	double delayTime = travelTime - computeStaticCostExcludingMargins(routeId, startEdgeId, endEdgeId);
+	double staticCost = routeIndex.getRow(routeId) == RouteIndex::NOT_FOUND ? drivenStaticCost : computeStaticCostExcludingMargins(routeId, startEdgeId, endEdgeId);
+	double delayTime = travelTime - staticCost;
 //	cout << "logging" << endl;
 	double now = Simulator::Now().GetSeconds();
 	Log::getInstance().getStream("routing_end") << now << "\t" << routeId << "\t" << vehicleId << "\t" << startReroute << "\t"
@@ -61,31 +91,37 @@ void TIS::reportEndingRoute(string vehicleId, string routeId, string startEdgeId
 	Log::getInstance().getStream("routing_end") << "\t" << routingStrategy << "\t" << start << "\t" << (now-start) << endl;
 }
 
-int TIS::getVehiclesOnRoute(string routeId) {
+int TIS::getVehiclesOnRoute(const string & routeId) {
 	map<string,int>::iterator it = vehiclesOnRoute.find(routeId);
 	if (it != vehiclesOnRoute.end()) {
-		return vehiclesOnRoute[routeId];
+		return it->second;
 	}
 	return 0;
 }
 
-void TIS::initializeStaticTravelTimes(map<string, Route> routes) {
-	for (map<string, Route>::iterator it = routes.begin(); it != routes.end(); ++it) {
+void TIS::initializeStaticTravelTimes(const map<string, Route> & routes) {
+	for (map<string, Route>::const_iterator it = routes.begin(); it != routes.end(); ++it) {
 		if (this->staticRoutes.find(it->first) == this->staticRoutes.end()) {
-			this->staticRoutes[it->first] = it->second;
-			Route route = it->second;
+			Route & route = this->staticRoutes[it->first] = it->second;
 			vehiclesOnRoute[it->first] = 0;
 			travelTimeDateOnRoute[it->first] = 0;
 			travelTimesOnRoute[it->first] = 0;
-			for (vector<string>::iterator it2 = route.getEdgeIds().begin(); it2 != route.getEdgeIds().end(); ++it2) {
-				if (staticRecords.find(*it2) == staticRecords.end()) {
+			const vector<StringId> & edges = route.getEdgeHandles();
+			for (size_t i = 0; i < edges.size(); ++i) {
+				if (staticRecords.find(edges[i]) == staticRecords.end()) {
 					// add info about the edge
-					staticRecords[*it2] = route.getEdgeInfo(*it2);
+					staticRecords[edges[i]] = route.getEdgeInfos()[i];
 				}
 			}
+			routeIndex.addRoute(it->first, edges);
+			for (uint32_t column = staticEdgeCosts.size(); column < routeIndex.getNumberOfColumns(); ++column) {
+				staticEdgeCosts.push_back(staticRecords[routeIndex.getEdge(column)].getStaticCost());
+			}
+			// the selections do not have the new row
+			selectedRoutes.clear();
 			// print route to file
 			Log::getInstance().getStream("routes_info") << it->first << "\t";
-			for (vector<EdgeInfo>::iterator edges_it = it->second.getEdgeInfos().begin(); edges_it != it->second.getEdgeInfos().end(); ++edges_it) {
+			for (vector<EdgeInfo>::iterator edges_it = route.getEdgeInfos().begin(); edges_it != route.getEdgeInfos().end(); ++edges_it) {
 				Log::getInstance().getStream("routes_info") << edges_it->getId() << "," << edges_it->getLength() << "," << edges_it->getMaxSpeed() << "\t";
 			}
 			Log::getInstance().getStream("routes_info") << endl;
@@ -93,35 +129,50 @@ void TIS::initializeStaticTravelTimes(map<string, Route> routes) {
 	}
 }
 
-std::map<std::string, EdgeInfo> & TIS::getStaticRecords() {
+std::map<StringId, EdgeInfo> & TIS::getStaticRecords() {
 	return staticRecords;
 }
 
-double TIS::computeStaticCostExcludingMargins(string routeId, string startEdgeId, string endEdgeId) {
-	double staticCost = 0;
-		if (staticRoutes.find(routeId) != staticRoutes.end()) {
-			bool isMonitored = false;
-			vector<string> edgeIds = staticRoutes[routeId].getEdgeIds();
-			for (vector<string>::iterator it = edgeIds.begin(); it != edgeIds.end(); ++it) {
-				if (*it == endEdgeId) {
-					isMonitored = false;
-				}
-				if (isMonitored) {
-					staticCost += staticRecords[*it].getStaticCost();
-				}
-				if (*it == startEdgeId) {
-					isMonitored = true;
-				}
-			}
-		}
-		return staticCost;
+double TIS::computeStaticCostExcludingMargins(const string & routeId, const string & startEdgeId, const string & endEdgeId) {
+	uint32_t row = routeIndex.getRow(routeId);
+	if (row == RouteIndex::NOT_FOUND) {
+		return 0;
+	}
+	return getStaticRouteCosts(intern(startEdgeId), intern(endEdgeId))[row];
+}
+
+const RouteIndex & TIS::getRouteIndex() {
+	return routeIndex;
 }
 
-map<string, double> TIS::getCosts(map<string, Route> routes, string startEdgeId, string endEdgeId) {
+TIS::SelectedRoutes & TIS::selectRoutes(StringId startEdge, StringId endEdge) {
+	pair<StringId,StringId> key(startEdge, endEdge);
+	map<pair<StringId,StringId>, SelectedRoutes>::iterator it = selectedRoutes.find(key);
+	if (it == selectedRoutes.end()) {
+		it = selectedRoutes.insert(make_pair(key, SelectedRoutes())).first;
+		routeIndex.select(startEdge, endEdge, it->second.selection);
+		routeIndex.multiply(it->second.selection, staticEdgeCosts, it->second.staticCosts);
+	}
+	return it->second;
+}
+
+const RouteIndex::Selection & TIS::getSelection(StringId startEdge, StringId endEdge) {
+	return selectRoutes(startEdge, endEdge).selection;
+}
+
+const vector<double> & TIS::getStaticRouteCosts(StringId startEdge, StringId endEdge) {
+	return selectRoutes(startEdge, endEdge).staticCosts;
+}
+
+const vector<double> & TIS::getStaticEdgeCosts() {
+	return staticEdgeCosts;
+}
+
+map<string, double> TIS::getCosts(const map<string, Route> & routes, const string & startEdgeId, const string & endEdgeId) {
 	map<string, double> costs;
 	map<string, double> packetAges;
 	double now = Simulator::Now().GetSeconds();
-	for (map<string, Route>::iterator it = routes.begin(); it != routes.end(); ++it) {
+	for (map<string, Route>::const_iterator it = routes.begin(); it != routes.end(); ++it) {
 		costs[it->first] = computeStaticCostExcludingMargins(it->first, startEdgeId, endEdgeId);
 	}
 	for (map<string,double>::iterator it = travelTimesOnRoute.begin(); it != travelTimesOnRoute.end(); ++it) {
@@ -140,19 +191,16 @@ map<string, double> TIS::getCosts(map<string, Route> routes, string startEdgeId,
 		packetAges[it->first] = informationAge;
 	}
 	Log::getInstance().getStream("global_costs") << now << "\t";
-	for (map<string, Route>::iterator it = routes.begin(); it != routes.end(); ++it) {
+	for (map<string, Route>::const_iterator it = routes.begin(); it != routes.end(); ++it) {
 		Log::getInstance().getStream("global_costs") << it->first << "," << costs[it->first] << "," << packetAges[it->first] << "," << vehiclesOnRoute[it->first] << "\t";
 	}
 	Log::getInstance().getStream("global_costs") << endl;
 	return costs;
 }
 
-string TIS::getEvent(map<string, double> probabilities) {
+string TIS::getEvent(const map<string, double> & probabilities) {
 	// sort probabilities
-	vector<pair<string, double> > sortedProbabilities = vector<pair<string, double> >();
-	for (map<string, double>::iterator it = probabilities.begin(); it != probabilities.end(); ++it) {
-		sortedProbabilities.push_back(pair<string,double>(it->first, it->second));
-	}
+	vector<pair<string, double> > sortedProbabilities(probabilities.begin(), probabilities.end());
 	for (vector<pair<string, double> >::iterator it = sortedProbabilities.begin(); it != sortedProbabilities.end(); ++it) {
 		Log::getInstance().getStream("probabilities") << "route: " << it->first << ", prob: " << it->second << "\t";
 	}
@@ -174,10 +222,10 @@ string TIS::getEvent(map<string, double> probabilities) {
     return lastChoice;
 }
 
-string TIS::chooseMinCostRoute(map<string,double> costs) {
+string TIS::chooseMinCostRoute(const map<string,double> & costs) {
 	double minCost = numeric_limits<double>::max();
 	string chosenRouteId = "";
-	for (map<string, double>::iterator it = costs.begin(); it != costs.end(); ++it) {
+	for (map<string, double>::const_iterator it = costs.begin(); it != costs.end(); ++it) {
 		double value = it->second;
 		if (value >= 0 && value < minCost) {
 			minCost = value;
@@ -234,22 +282,27 @@ bool comp_prob(const pair<string,double>& v1, const pair<string,double>& v2)
 	return v1.second < v2.second;
 }
 
-string TIS::chooseProbTravelTimeRoute(map<string,double> costs) {
-	map<string, double> correlated;
-	return chooseProbTravelTimeRoute(costs, correlated);
+string TIS::chooseProbTravelTimeRoute(const map<string,double> & costs) {
+	return chooseProbTravelTimeRoute(costs, map<string, double>());
 }
 
-string TIS::chooseProbTravelTimeRoute(map<string,double> costs, map<string, double> correlated) {
+string TIS::chooseProbTravelTimeRoute(const map<string,double> & routeCosts, const map<string, double> & correlated) {
 	double minCost = numeric_limits<double>::max();
 	double sumCost = 0;
 	string chosenRouteId = "";
 	int costsSize = 0;
 
-	for (map<string, double>::iterator it = correlated.begin(); it != correlated.end(); ++it) {
-		costs[it->first] = costs[it->first] + costs[it->first]*it->second;
+	// the costs are only copied to be weighted by the correlation
+	map<string, double> correlatedCosts;
+	if (!correlated.empty()) {
+		correlatedCosts = routeCosts;
+		for (map<string, double>::const_iterator it = correlated.begin(); it != correlated.end(); ++it) {
+			correlatedCosts[it->first] = correlatedCosts[it->first] + correlatedCosts[it->first]*it->second;
+		}
 	}
+	const map<string, double> & costs = correlated.empty() ? routeCosts : correlatedCosts;
 
-	for (map<string, double>::iterator it = costs.begin(); it != costs.end(); ++it) {
+	for (map<string, double>::const_iterator it = costs.begin(); it != costs.end(); ++it) {
 		sumCost += it->second;
 		costsSize += it->second > 0 ? 1 : 0;
 	}
@@ -259,7 +312,7 @@ string TIS::chooseProbTravelTimeRoute(map<string,double> costs, map<string, doub
 
 	Log::getInstance().getStream("probabilities") << Simulator::Now().GetSeconds() << "\t" << costsSize << "/" << costs.size() << "\t";
 	map<string, double> probabilities;
-	for (map<string, double>::iterator it = costs.begin(); it != costs.end(); ++it) {
+	for (map<string, double>::const_iterator it = costs.begin(); it != costs.end(); ++it) {
 		double probability = 0;
 		if (it->second == 0) { // there are routes with no cost!
 			// take only them into probabilities, skip the rest of routes
@@ -290,16 +343,28 @@ string TIS::chooseProbTravelTimeRoute(map<string,double> costs, map<string, doub
 }
 
 double TIS::getEdgeLength(std::string edgeId) {
-	if (this->staticRecords.find(edgeId) != this->staticRecords.end()) {
-		return this->staticRecords[edgeId].getLength();
+	StringId edge;
+	return StringInterner::getInstance().find(edgeId, edge) ? getEdgeLength(edge) : 0;
+}
+
+double TIS::getEdgeLength(StringId edgeId) {
+	map<StringId,EdgeInfo>::iterator it = this->staticRecords.find(edgeId);
+	if (it != this->staticRecords.end()) {
+		return it->second.getLength();
 	}
 	return 0;
 }
 
 double TIS::getEdgeStaticCost(std::string edgeId) {
-	if (this->staticRecords.find(edgeId) != this->staticRecords.end()) {
-			return this->staticRecords[edgeId].getStaticCost();
-		}
+	StringId edge;
+	return StringInterner::getInstance().find(edgeId, edge) ? getEdgeStaticCost(edge) : 0;
+}
+
+double TIS::getEdgeStaticCost(StringId edgeId) {
+	map<StringId,EdgeInfo>::iterator it = this->staticRecords.find(edgeId);
+	if (it != this->staticRecords.end()) {
+		return it->second.getStaticCost();
+	}
 	return 0;
 }
 
@@ -307,6 +372,10 @@ double TIS::getEdgePerfectCost(std::string edgeId) {
 	return traci->GetEdgeTravelTime(edgeId);
 }
 
+double TIS::getEdgePerfectCost(StringId edgeId) {
+	return traci->GetEdgeTravelTime(lookup(edgeId));
+}
+
 bool TIS::isCongestion()
 {
 	return congestion;
@@ -25,6 +25,10 @@
 #include "ovnisPacket.h"
 #include "itinerary.h"
 #include "recordEntry.h"
+#include "knowledgeStore.h"
+#include "routeIndex.h"
+#include "roadGraph.h"
+#include "routingEngine.h"
 #include "traci/sumoTraciConnection.h"
 #include <traci-server/TraCIConstants.h>
 
@@ -39,39 +43,76 @@ public:
 	virtual ~TIS();
 	static TIS & getInstance(); // Guaranteed to be destroyed. Instantiated on first use.
 
-	void reportStartingRoute(string vehicleId, string currentEdgeId, string currentRouteId, string newEdgeId, string newRouteId,
-			string originEdgeId, string destinationEdgeId, bool isCheater, bool isCongested,
+	void reportStartingRoute(const string & vehicleId, const string & currentEdgeId, const string & currentRouteId, const string & newEdgeId, const string & newRouteId,
+			const string & originEdgeId, const string & destinationEdgeId, bool isCheater, bool isCongested,
 			double expectedTravelTime, double shortestExpectedTravelTime);
-	void reportEndingRoute(string vehicleId, std::string routeId, std::string startEdgeId, std::string endEdgeId,
+	/**
+	 * @param drivenStaticCost static cost of the edges driven between startEdgeId and
+	 * endEdgeId, from which the delay is computed when routeId is not a static route, as
+	 * a dynamic one.
+	 */
+	void reportEndingRoute(const string & vehicleId, const std::string & routeId, const std::string & startEdgeId, const std::string & endEdgeId,
 			double startReroute, double travelTime, bool isCheater, double selfishExpectedTravelTime, double expectedTravelTime, bool wasCongested,
-			string routingStrategy, double start);
-	void reportEndingEdge(string vehicleId, string edgeId, double travelTime);
+			const string & routingStrategy, double start, double drivenStaticCost);
+	void reportEndingEdge(const string & vehicleId, const string & edgeId, double travelTime);
 
-    int getVehiclesOnRoute(std::string routeId);
+    int getVehiclesOnRoute(const std::string & routeId);
 	std::map<std::string,double> & getTravelTimesOnRoute();
 	std::map<std::string,double> & getTravelTimeDateOnRoute();
 
 	double getEdgePerfectCost(std::string edgeId);
+	double getEdgePerfectCost(StringId edgeId);
 	void vehicleOnRoadsInitialize(std::string routeId);
 
-	void initializeStaticTravelTimes(map<string, Route> routes);
-	map<string, double> getCosts(map<string, Route> routes, string startEdgeId, string endEdgeId);
-	double computeStaticCostExcludingMargins(string routeId, string startEdgeId, string endEdgeId);
-	std::map<std::string, EdgeInfo> & getStaticRecords();
+	void initializeStaticTravelTimes(const map<string, Route> & routes);
+	map<string, double> getCosts(const map<string, Route> & routes, const string & startEdgeId, const string & endEdgeId);
+	double computeStaticCostExcludingMargins(const string & routeId, const string & startEdgeId, const string & endEdgeId);
+	/**
+	 * Edges of the static routes.
+	 */
+	const RouteIndex & getRouteIndex();
+	/**
+	 * @return the parts of the static routes between startEdge and endEdge, margins
+	 * excluded, computed once for the vehicles deciding at startEdge.
+	 */
+	const RouteIndex::Selection & getSelection(StringId startEdge, StringId endEdge);
+	/**
+	 * @return the static cost of the selected part of each row of the route index.
+	 */
+	const std::vector<double> & getStaticRouteCosts(StringId startEdge, StringId endEdge);
+	/**
+	 * @return the static cost of each column of the route index.
+	 */
+	const std::vector<double> & getStaticEdgeCosts();
+	std::map<StringId, EdgeInfo> & getStaticRecords();
 	double getEdgeLength(std::string edgeId);
+	double getEdgeLength(StringId edgeId);
 	double getEdgeStaticCost(std::string edgeId);
+	double getEdgeStaticCost(StringId edgeId);
 	bool isCongestion();
 	void setCongestion(bool congestion, bool ifDense, bool ifCongested);
 
-	std::string chooseMinCostRoute(std::map<std::string,double> costs);
-	std::string chooseProbTravelTimeRoute(std::map<std::string,double> costs);
-	std::string chooseProbTravelTimeRoute(std::map<std::string,double> costs, std::map<std::string, double> correlated);
-	std::string chooseFlowAwareRoute(double flow, std::map<std::string,double> costs);
+	std::string chooseMinCostRoute(const std::map<std::string,double> & costs);
+	std::string chooseProbTravelTimeRoute(const std::map<std::string,double> & costs);
+	std::string chooseProbTravelTimeRoute(const std::map<std::string,double> & costs, const std::map<std::string, double> & correlated);
+	std::string chooseFlowAwareRoute(double flow, const std::map<std::string,double> & costs);
 	std::string chooseRandomRoute();
-	std::string getEvent(std::map<std::string, double> probabilities);
-    std::map<std::string, RecordEntry> getPerfectTravelTimes();
+	std::string getEvent(const std::map<std::string, double> & probabilities);
+	/**
+	 * Travel times reported by the vehicles, see reportEndingEdge().
+	 */
+    const KnowledgeStore & getPerfectTravelTimes();
+    /**
+     * Fills weights with the travel time last reported on each edge of graph, its
+     * static cost if none was reported for CENTRALISED_INFORMATION_TTL.
+     */
+    void getEdgeWeights(const RoadGraph & graph, std::vector<double> & weights);
+    /**
+     * Routing engine over the network of SUMO, built at the first call and customized
+     * with getEdgeWeights() at most every ROUTING_CUSTOMIZATION_INTERVAL.
+     */
+    const RoutingEngine & getRoutingEngine();
 
-    bool executeOnce;
     //	void DetectJam(double currentSpeed, double maxSpeed, std::string currentEdge);
 private:
     TIS();
@@ -80,13 +121,24 @@ private:
     static TIS *instance;
     Ptr<ovnis::SumoTraciConnection> traci;
 
-    std::map<std::string,EdgeInfo> staticRecords; // info about expected travel times on routes (whith max speed)
+    std::map<StringId,EdgeInfo> staticRecords; // info about expected travel times on routes (whith max speed)
+
+    struct SelectedRoutes {
+    	RouteIndex::Selection selection;
+    	std::vector<double> staticCosts;
+    };
+    SelectedRoutes & selectRoutes(StringId startEdge, StringId endEdge);
+    RouteIndex routeIndex;
+    std::vector<double> staticEdgeCosts;
+    std::map<std::pair<StringId,StringId>, SelectedRoutes> selectedRoutes; // by start and end edge
 
     std::map<std::string,Route> staticRoutes;
     std::map<std::string,int> vehiclesOnRoute;
     std::map<std::string,double> travelTimesOnRoute;
     std::map<std::string,double> travelTimeDateOnRoute;
-	std::map<std::string, RecordEntry> perfectTravelTimes; // info about travel times on routes
+	KnowledgeStore perfectTravelTimes; // info about travel times on routes
+	Ptr<RoutingEngine> routingEngine;
+	double customizationDate;
 
     bool congestion;
     bool comp_prob(const pair<string,double> & v1, const pair<string,double> & v2);
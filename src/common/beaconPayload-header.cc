@@ -0,0 +1,239 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ *
+ * Copyright (c) 2010-2011 University of Luxembourg
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * @file beaconPayload-header.cc
+ */
+
+#include <cstring>
+#include <algorithm>
+#include "beaconPayload-header.h"
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (BeaconPayloadHeader);
+
+// first byte of the payload, to tell it from other beacon bodies
+static const uint8_t BEACON_PAYLOAD_VERSION = 1;
+static const uint32_t MAX_STRING_SIZE = 255;
+static const uint32_t MAX_RECORDS = 255;
+
+BeaconPayloadHeader::BeaconPayloadHeader ()
+  : m_x (0),
+    m_y (0),
+    m_speed (0),
+    m_time (0)
+{
+}
+
+BeaconPayloadHeader::~BeaconPayloadHeader ()
+{
+}
+
+void
+BeaconPayloadHeader::SetSenderId (std::string senderId)
+{
+  m_senderId = senderId.substr (0, MAX_STRING_SIZE);
+}
+std::string
+BeaconPayloadHeader::GetSenderId (void) const
+{
+  return m_senderId;
+}
+void
+BeaconPayloadHeader::SetPosition (double x, double y)
+{
+  m_x = x;
+  m_y = y;
+}
+double
+BeaconPayloadHeader::GetX (void) const
+{
+  return m_x;
+}
+double
+BeaconPayloadHeader::GetY (void) const
+{
+  return m_y;
+}
+void
+BeaconPayloadHeader::SetEdgeId (std::string edgeId)
+{
+  m_edgeId = edgeId.substr (0, MAX_STRING_SIZE);
+}
+std::string
+BeaconPayloadHeader::GetEdgeId (void) const
+{
+  return m_edgeId;
+}
+void
+BeaconPayloadHeader::SetSpeed (double speed)
+{
+  m_speed = speed;
+}
+double
+BeaconPayloadHeader::GetSpeed (void) const
+{
+  return m_speed;
+}
+void
+BeaconPayloadHeader::SetTime (double time)
+{
+  m_time = time;
+}
+double
+BeaconPayloadHeader::GetTime (void) const
+{
+  return m_time;
+}
+void
+BeaconPayloadHeader::AddRecord (const Record &record)
+{
+  if (m_records.size () < MAX_RECORDS)
+    {
+      m_records.push_back (record);
+      m_records.back ().edgeId = record.edgeId.substr (0, MAX_STRING_SIZE);
+    }
+}
+const std::vector<BeaconPayloadHeader::Record> &
+BeaconPayloadHeader::GetRecords (void) const
+{
+  return m_records;
+}
+
+TypeId
+BeaconPayloadHeader::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::BeaconPayloadHeader")
+    .SetParent<Header> ()
+    .AddConstructor<BeaconPayloadHeader> ()
+    ;
+  return tid;
+}
+TypeId
+BeaconPayloadHeader::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+void
+BeaconPayloadHeader::Print (std::ostream &os) const
+{
+  os << "sender=" << m_senderId << " pos=(" << m_x << "," << m_y << ") edge=" << m_edgeId
+     << " speed=" << m_speed << " records=" << m_records.size ();
+}
+
+uint32_t
+BeaconPayloadHeader::GetSerializedSize (void) const
+{
+  // version, sender, position, speed, time (ms), edge, number of records
+  uint32_t size = 1 + 1 + m_senderId.size () + 4 + 4 + 4 + 4 + 1 + m_edgeId.size () + 1;
+  for (std::vector<Record>::const_iterator it = m_records.begin (); it != m_records.end (); ++it)
+    {
+      size += 1 + it->edgeId.size () + 2 + 2;
+    }
+  return size;
+}
+
+void
+BeaconPayloadHeader::Serialize (Buffer::Iterator start) const
+{
+  Buffer::Iterator i = start;
+  i.WriteU8 (BEACON_PAYLOAD_VERSION);
+  WriteString (i, m_senderId);
+  WriteFloat (i, m_x);
+  WriteFloat (i, m_y);
+  WriteFloat (i, m_speed);
+  i.WriteHtonU32 ((uint32_t) (m_time * 1000 + 0.5));
+  WriteString (i, m_edgeId);
+  i.WriteU8 (m_records.size ());
+  for (std::vector<Record>::const_iterator it = m_records.begin (); it != m_records.end (); ++it)
+    {
+      WriteString (i, it->edgeId);
+      i.WriteHtonU16 (ToDeciseconds (it->travelTime));
+      i.WriteHtonU16 (ToDeciseconds (m_time - it->date));
+    }
+}
+
+uint32_t
+BeaconPayloadHeader::Deserialize (Buffer::Iterator start)
+{
+  Buffer::Iterator i = start;
+  uint8_t version = i.ReadU8 ();
+  NS_ASSERT (version == BEACON_PAYLOAD_VERSION);
+  m_senderId = ReadString (i);
+  m_x = ReadFloat (i);
+  m_y = ReadFloat (i);
+  m_speed = ReadFloat (i);
+  m_time = i.ReadNtohU32 () / 1000.0;
+  m_edgeId = ReadString (i);
+  uint8_t nRecords = i.ReadU8 ();
+  m_records.clear ();
+  for (uint8_t k = 0; k < nRecords; k++)
+    {
+      Record record;
+      record.edgeId = ReadString (i);
+      record.travelTime = i.ReadNtohU16 () / 10.0;
+      record.date = m_time - i.ReadNtohU16 () / 10.0;
+      m_records.push_back (record);
+    }
+  return i.GetDistanceFrom (start);
+}
+
+void
+BeaconPayloadHeader::WriteString (Buffer::Iterator &i, const std::string &s)
+{
+  i.WriteU8 (s.size ());
+  i.Write ((const uint8_t *) s.data (), s.size ());
+}
+
+std::string
+BeaconPayloadHeader::ReadString (Buffer::Iterator &i)
+{
+  uint8_t size = i.ReadU8 ();
+  std::string s (size, ' ');
+  for (uint8_t k = 0; k < size; k++)
+    {
+      s[k] = i.ReadU8 ();
+    }
+  return s;
+}
+
+void
+BeaconPayloadHeader::WriteFloat (Buffer::Iterator &i, double value)
+{
+  float f = value;
+  uint32_t bits;
+  std::memcpy (&bits, &f, sizeof (bits));
+  i.WriteHtonU32 (bits);
+}
+
+double
+BeaconPayloadHeader::ReadFloat (Buffer::Iterator &i)
+{
+  uint32_t bits = i.ReadNtohU32 ();
+  float f;
+  std::memcpy (&f, &bits, sizeof (f));
+  return f;
+}
+
+uint16_t
+BeaconPayloadHeader::ToDeciseconds (double seconds)
+{
+  return (uint16_t) std::min (65535.0, std::max (0.0, seconds * 10 + 0.5));
+}
+
+} // namespace ns3
@@ -0,0 +1,95 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ *
+ * Copyright (c) 2010-2011 University of Luxembourg
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * @file beaconPayload-header.h
+ */
+
+#ifndef BEACON_PAYLOAD_HEADER_H
+#define BEACON_PAYLOAD_HEADER_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "ns3/header.h"
+
+namespace ns3 {
+
+/**
+ * \brief Application state carried in the body of the beacons of ns3::BeaconingAdhocWifiMac.
+ *
+ * Position, edge and speed of the sender, plus optional traffic records. Records
+ * are compressed: travel time and age (relative to the time of the beacon) are
+ * sent in tenths of seconds on 16 bits, saturated at 6553.5 s. Strings are limited
+ * to 255 characters and a beacon carries at most 255 records.
+ */
+class BeaconPayloadHeader : public Header
+{
+public:
+  struct Record
+  {
+    std::string edgeId;
+    double travelTime;
+    double date;
+  };
+
+  BeaconPayloadHeader ();
+  virtual ~BeaconPayloadHeader ();
+
+  void SetSenderId (std::string senderId);
+  std::string GetSenderId (void) const;
+  void SetPosition (double x, double y);
+  double GetX (void) const;
+  double GetY (void) const;
+  void SetEdgeId (std::string edgeId);
+  std::string GetEdgeId (void) const;
+  void SetSpeed (double speed);
+  double GetSpeed (void) const;
+  /**
+   * \param time date of the beacon (s), the reference of the record dates.
+   */
+  void SetTime (double time);
+  double GetTime (void) const;
+  void AddRecord (const Record &record);
+  const std::vector<Record> & GetRecords (void) const;
+
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual void Print (std::ostream &os) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+
+private:
+  static void WriteString (Buffer::Iterator &i, const std::string &s);
+  static std::string ReadString (Buffer::Iterator &i);
+  static void WriteFloat (Buffer::Iterator &i, double value);
+  static double ReadFloat (Buffer::Iterator &i);
+  static uint16_t ToDeciseconds (double seconds);
+
+  std::string m_senderId;
+  double m_x;
+  double m_y;
+  std::string m_edgeId;
+  double m_speed;
+  double m_time;
+  std::vector<Record> m_records;
+};
+
+} // namespace ns3
+
+#endif /* BEACON_PAYLOAD_HEADER_H */
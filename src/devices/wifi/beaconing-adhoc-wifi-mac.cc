@@ -26,6 +26,8 @@
 #include "ns3/boolean.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/simulator.h"
+#include "ns3/wifi-net-device.h"
+#include <algorithm>
 
 #include "ns3/qos-tag.h"
 //#include "my-mac-low.h"
@@ -35,7 +37,7 @@
 #include "ns3/msdu-aggregator.h"
 #include "ns3/amsdu-subframe-header.h"
 #include "ns3/mgt-headers.h"
-#include "common/myEnergy-tag.h"
+#include "common/myTxEnergy-tag.h"
 
 #include "log.h"
 
@@ -61,11 +63,11 @@ BeaconingAdhocWifiMac::GetTypeId (void)
                    UintegerValue (BEACON_LOST_RATIO),
                    MakeUintegerAccessor (&BeaconingAdhocWifiMac::m_numberBeaconLost),
                    MakeUintegerChecker<uint32_t> (1))
-//%    .AddAttribute ("BeaconInterval", "Delay between two beacons",
-//                       TimeValue (Seconds (1)),
-//                       MakeTimeAccessor (&BeaconingAdhocWifiMac::GetBeaconInterval,
-//                                         &BeaconingAdhocWifiMac::SetBeaconInterval),
-//                       MakeTimeChecker ())
+    .AddAttribute ("BeaconInterval", "Delay between two beacons",
+                   TimeValue (Seconds (BEACON_INTERVAL)),
+                   MakeTimeAccessor (&BeaconingAdhocWifiMac::GetBeaconInterval,
+                                     &BeaconingAdhocWifiMac::SetBeaconInterval),
+                   MakeTimeChecker ())
 //    .AddAttribute ("BeaconGeneration", "Whether or not beacons are generated.",
 //                       BooleanValue (true),
 //                       MakeBooleanAccessor (&BeaconingAdhocWifiMac::SetBeaconGeneration,
@@ -85,13 +87,17 @@ BeaconingAdhocWifiMac::BeaconingAdhocWifiMac ()
 
   // Let the lower layers know that we are acting in an IBSS
   SetTypeOfStation (ADHOC_STA);
-  Time t1 = Seconds(BEACON_INTERVAL);// m_beaconInterval;
+  m_beaconInterval = Seconds (BEACON_INTERVAL);
+  m_txPowerControl = false;
+  m_txPowerDbm = 0;
+  Time t1 = m_beaconInterval;
   Time t2;
   // Random value to start the devices at different moments
   UniformVariable randomRange (0.01, 0.2);
   double randomRangeDouble = randomRange.GetValue();
   t2 = Seconds (randomRangeDouble);
   Time t3 = t1 + t2;
+  m_beaconTick = 0;
 
 //  m_beaconEvent = Simulator::Schedule (t3, &BeaconingAdhocWifiMac::SendOneBeacon, this);
 
@@ -182,16 +188,82 @@ BeaconingAdhocWifiMac::Enqueue (Ptr<const Packet> packet, Mac48Address to)
       // Sanity check that the TID is valid
       NS_ASSERT (tid < 8);
 //      std::cout << "a" << std::endl;
-      m_edca[QosUtilsMapTidToAc (tid)]->Queue (packet, hdr);
+      m_edca[QosUtilsMapTidToAc (tid)]->Queue (AddTxPowerTag (packet), hdr);
     }
   else
     {
 //	  std::cout << "b" << std::endl;
 //	  ovnis::Log::getInstance().packetSent(packet->GetSize());
-      m_dca->Queue (packet, hdr);
+      m_dca->Queue (AddTxPowerTag (packet), hdr);
     }
 }
 
+void
+BeaconingAdhocWifiMac::SetWifiPhy (Ptr<WifiPhy> phy)
+{
+  NS_LOG_FUNCTION (this << phy);
+  RegularWifiMac::SetWifiPhy (phy);
+  m_ovnisPhy = DynamicCast<OvnisWifiPhy> (phy);
+}
+
+void
+BeaconingAdhocWifiMac::ConnectNeighborTraces (NewNeighborCallback found, NeighborLostCallback lost)
+{
+  NS_LOG_FUNCTION (this);
+  TraceConnectWithoutContext ("NewNeighbor", found);
+  TraceConnectWithoutContext ("NeighborLost", lost);
+}
+
+void
+BeaconingAdhocWifiMac::DisconnectNeighborTraces (NewNeighborCallback found, NeighborLostCallback lost)
+{
+  NS_LOG_FUNCTION (this);
+  TraceDisconnectWithoutContext ("NewNeighbor", found);
+  TraceDisconnectWithoutContext ("NeighborLost", lost);
+}
+
+uint32_t
+BeaconingAdhocWifiMac::ConnectNeighborTraces (Ptr<Node> node, NewNeighborCallback found, NeighborLostCallback lost)
+{
+  uint32_t connected = 0;
+  for (uint32_t i = 0; i < node->GetNDevices (); i++)
+    {
+      Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> (node->GetDevice (i));
+      if (device == 0)
+        {
+          continue;
+        }
+      Ptr<BeaconingAdhocWifiMac> mac = DynamicCast<BeaconingAdhocWifiMac> (device->GetMac ());
+      if (mac != 0)
+        {
+          mac->ConnectNeighborTraces (found, lost);
+          connected++;
+        }
+    }
+  return connected;
+}
+
+uint32_t
+BeaconingAdhocWifiMac::DisconnectNeighborTraces (Ptr<Node> node, NewNeighborCallback found, NeighborLostCallback lost)
+{
+  uint32_t disconnected = 0;
+  for (uint32_t i = 0; i < node->GetNDevices (); i++)
+    {
+      Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> (node->GetDevice (i));
+      if (device == 0)
+        {
+          continue;
+        }
+      Ptr<BeaconingAdhocWifiMac> mac = DynamicCast<BeaconingAdhocWifiMac> (device->GetMac ());
+      if (mac != 0)
+        {
+          mac->DisconnectNeighborTraces (found, lost);
+          disconnected++;
+        }
+    }
+  return disconnected;
+}
+
 void
 BeaconingAdhocWifiMac::SetLinkUpCallback (Callback<void> linkUp)
 {
@@ -273,7 +345,7 @@ BeaconingAdhocWifiMac::GetBeaconGeneration (void) const
 void
 BeaconingAdhocWifiMac::SendOneBeacon (void)
 {
-  DecreaseBeaconCount();
+  ExpireNeighbors();
   NS_LOG_FUNCTION (this);
   WifiMacHeader hdr;
   hdr.SetBeacon ();
@@ -284,78 +356,123 @@ BeaconingAdhocWifiMac::SendOneBeacon (void)
   beacon.SetSsid (GetSsid ());
   beacon.SetSupportedRates (GetSupportedRates ());
   Ptr<Packet> packet = Create<Packet> ();
+  if (!m_beaconPayloadCallback.IsNull ())
+    {
+      BeaconPayloadHeader payload;
+      payload.SetTime (Simulator::Now ().GetSeconds ());
+      m_beaconPayloadCallback (payload);
+      packet->AddHeader (payload);
+    }
   packet->AddHeader (beacon);
 //  Mac48Address aaa= GetAddress();
 //  std::cout<<Simulator::Now()<<" envio beacon "<<aaa<<std::endl;
-  m_dca->Queue (packet, hdr);
-  m_beaconEvent = Simulator::Schedule (Seconds(BEACON_INTERVAL), &BeaconingAdhocWifiMac::SendOneBeacon, this);
+  m_dca->Queue (AddTxPowerTag (packet), hdr);
+  m_beaconEvent = Simulator::Schedule (m_beaconInterval, &BeaconingAdhocWifiMac::SendOneBeacon, this);
 }
 
 void BeaconingAdhocWifiMac::ProcessBeacon( Ptr<Packet> packet, Mac48Address addrFrom){
 
-	if ( m_neighborList.find (addrFrom)== m_neighborList.end ()){
-		// update the beacon index
-		m_neighborList[addrFrom] = m_numberBeaconLost;
+	ResizeWheel();
+	MacAddrMapIterator i = m_neighborList.find (addrFrom);
+	if (i == m_neighborList.end ()){
+		Neighbor neighbor;
+		neighbor.lastHeard = m_beaconTick;
+		m_neighborList[addrFrom] = neighbor;
+		m_wheel[GetExpiry(neighbor) % m_wheel.size()].push_back(addrFrom);
 		//std::cout<<addrFrom<<" Addd en beaconing wifi mac " << m_neighborList.size() <<std::endl;
 	}
-	  //Added by Patricia Ruiz (for changing the tx power)
-	  	MyEnergyTag neighborPower=MyEnergyTag();
-	  	Ptr<Packet> packet2 = packet->Copy();
-	  	bool aux =packet2->RemovePacketTag (neighborPower);
-	  	double rxPowerDbm=-95;
-	  	if (aux){
-	  		rxPowerDbm = neighborPower.GetTagDouble();
-	  	}
+	else {
+		// its entry in the wheel is moved when its slot comes up
+		i->second.lastHeard = m_beaconTick;
+	}
 
+	//Added by Patricia Ruiz (for changing the tx power)
+	// The beacon is forwarded up while the phy is still on it, so the phy
+	// gives the power it has been received with.
+	const OvnisRxContext & context = GetRxContext();
 
-	m_neighborList[addrFrom] = m_numberBeaconLost;
 	//Call back every beacon to be able to update the rxEg otherwise inside the if!!
-//	m_newNeighborTraceSource (packet, addrFrom,rxPowerDbm);
-
-	m_rxPwDbm = TX_POWER_START;
+	m_rxPwDbm = context.rxPowerDbm;
 	m_newNeighborTraceSource (packet, addrFrom,m_rxPwDbm);
 
-	//std::cout<<Simulator::Now()<<GetAddress()<<" Incremento contador de  "<<addrFrom<<" a "<<m_neighborList[addrFrom]<<" con potencia "<<rxPowerDbm<<std::endl;
+	// application state piggybacked by the sender, see RegisterBeaconPayload
+	if (packet->GetSize() > 0 && !m_beaconPayloadReceiveCallback.IsNull()){
+		BeaconPayloadHeader payload;
+		packet->RemoveHeader(payload);
+		m_beaconPayloadReceiveCallback(addrFrom, payload, context);
+	}
+
+	//std::cout<<Simulator::Now()<<GetAddress()<<" Incremento contador de  "<<addrFrom<<" con potencia "<<rxPowerDbm<<std::endl;
+
+}
 
+uint64_t BeaconingAdhocWifiMac::GetExpiry(const Neighbor &neighbor) const{
+	// heard during interval t, lost at the beginning of interval t + BeaconLost + 1
+	return neighbor.lastHeard + m_numberBeaconLost + 1;
 }
 
-void BeaconingAdhocWifiMac::DecreaseBeaconCount(){
-	//std::cout<<GetAddress()<<" Decremento contador de "<<std::endl;
-
-	if (!m_neighborList.empty()){
-		//Create a vector to store the neighbors gone
-		std::vector <Mac48Address> arrayToErase;
-
-		for (MacAddrMapIterator i = m_neighborList.begin (); i != m_neighborList.end (); i++) {
-
-			uint16_t index = i->second;
-			//Insert the decreased value of the beacon index
-			if (index !=0){
-				index--;
-				i->second = index;
-			}
-			//When arrive to 0 the node consider the neighbor is lost
-			else{
-				//Store the neighbors to delete in a vector
-				Mac48Address addrFrom = i->first;
-				arrayToErase.push_back(addrFrom);
-           }
+void BeaconingAdhocWifiMac::ResizeWheel(){
+	if (m_wheel.size() == m_numberBeaconLost + 1u){
+		return;
+	}
+	// BeaconLost has changed: schedule every neighbor again
+	TimingWheel wheel(m_numberBeaconLost + 1);
+	for (MacAddrMapIterator i = m_neighborList.begin (); i != m_neighborList.end (); i++) {
+		uint64_t expiry = std::max(GetExpiry(i->second), m_beaconTick + 1);
+		wheel[expiry % wheel.size()].push_back(i->first);
+	}
+	m_wheel.swap(wheel);
+}
+
+void BeaconingAdhocWifiMac::ExpireNeighbors(){
+	m_beaconTick++;
+	ResizeWheel();
+
+	std::list<Mac48Address> due;
+	due.swap(m_wheel[m_beaconTick % m_wheel.size()]);
+	std::list<Mac48Address>::iterator it = due.begin();
+	while (it != due.end()){
+		std::list<Mac48Address>::iterator next = it;
+		next++;
+		MacAddrMapIterator i = m_neighborList.find (*it);
+		NS_ASSERT (i != m_neighborList.end ());
+		uint64_t expiry = GetExpiry(i->second);
+		if (expiry > m_beaconTick){
+			// heard again since it was scheduled
+			std::list<Mac48Address> & slot = m_wheel[expiry % m_wheel.size()];
+			slot.splice(slot.end(), due, it);
 		}
-		if (!arrayToErase.empty()){
-			// remove the neighbors gone from the list they were stored
-			std::vector<Mac48Address>::iterator it;
-			for ( it=arrayToErase.begin() ; it <= arrayToErase.end(); it++ ){
-				Mac48Address addr = arrayToErase.back();
-				arrayToErase.pop_back();
-				m_neighborList.erase(addr);
-				Ptr<Packet> packet =  Create<Packet> ();
-			//	ForwardNeighborLostList (packet, addr);
-				m_neighborLostTraceSource(packet, addr);
-		    }
+		else{
+			//When no beacon has been heard for BeaconLost intervals the neighbor is lost
+			Mac48Address addr = *it;
+			m_neighborList.erase(i);
+			Ptr<Packet> packet =  Create<Packet> ();
+			m_neighborLostTraceSource(packet, addr);
 		}
-   }
+		it = next;
+	}
+}
+
+const OvnisRxContext &
+BeaconingAdhocWifiMac::GetRxContext (void) const
+{
+  if (m_ovnisPhy != 0)
+    {
+      return m_ovnisPhy->GetRxContext ();
+    }
+  // another phy gives nothing on its frames
+  static OvnisRxContext unknown;
+  unknown.rxPowerDbm = -95;
+  unknown.txTime = Simulator::Now ();
+  return unknown;
+}
 
+uint32_t
+BeaconingAdhocWifiMac::GetNNeighbors (void) const
+{
+  return m_neighborList.size ();
 }
+
 SupportedRates
 BeaconingAdhocWifiMac::GetSupportedRates (void) const
 {
@@ -381,4 +498,85 @@ BeaconingAdhocWifiMac::StopBeaconing()
 {
     m_beaconEvent.Cancel();
 }
+
+void
+BeaconingAdhocWifiMac::StartBeaconing()
+{
+  if (m_beaconEvent.IsRunning ())
+    {
+      return;
+    }
+  // Random value to start the devices at different moments
+  UniformVariable randomRange (0, m_beaconInterval.GetSeconds ());
+  m_beaconEvent = Simulator::Schedule (Seconds (randomRange.GetValue ()), &BeaconingAdhocWifiMac::SendOneBeacon, this);
+}
+
+void
+BeaconingAdhocWifiMac::RegisterBeaconPayload (BeaconPayloadCallback fill, BeaconPayloadReceiveCallback receive)
+{
+  NS_LOG_FUNCTION (this);
+  m_beaconPayloadCallback = fill;
+  m_beaconPayloadReceiveCallback = receive;
+  StartBeaconing ();
+}
+
+void
+BeaconingAdhocWifiMac::UnregisterBeaconPayload (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_beaconPayloadCallback = BeaconPayloadCallback ();
+  m_beaconPayloadReceiveCallback = BeaconPayloadReceiveCallback ();
+}
+
+Time
+BeaconingAdhocWifiMac::GetBeaconInterval (void) const
+{
+  return m_beaconInterval;
+}
+
+void
+BeaconingAdhocWifiMac::SetBeaconInterval (Time interval)
+{
+  NS_LOG_FUNCTION (this << interval);
+  // the next beacon already scheduled keeps the previous interval
+  m_beaconInterval = interval;
+}
+
+void
+BeaconingAdhocWifiMac::SetTxPowerDbm (double txPowerDbm)
+{
+  NS_LOG_FUNCTION (this << txPowerDbm);
+  m_txPowerControl = true;
+  m_txPowerDbm = txPowerDbm;
+}
+
+double
+BeaconingAdhocWifiMac::GetTxPowerDbm (void) const
+{
+  if (!m_txPowerControl && m_phy != 0)
+    {
+      return m_phy->GetTxPowerEnd ();
+    }
+  return m_txPowerDbm;
+}
+
+Ptr<const Packet>
+BeaconingAdhocWifiMac::AddTxPowerTag (Ptr<const Packet> packet) const
+{
+  if (!m_txPowerControl)
+    {
+      return packet;
+    }
+  MyTxEnergyTag tag;
+  if (packet->PeekPacketTag (tag))
+    {
+      // forwarded frame, still tagged by its previous sender
+      Ptr<Packet> copy = packet->Copy ();
+      copy->RemovePacketTag (tag);
+      packet = copy;
+    }
+  tag.SetTagDouble (m_txPowerDbm);
+  packet->AddPacketTag (tag);
+  return packet;
+}
 } // namespace ns3
@@ -28,6 +28,12 @@
 #include "ns3/mac-rx-middle.h"
 #include "ns3/mac-low.h"
 #include "ns3/mac48-address.h"
+#include "ns3/node.h"
+#include "ovnis-wifi-phy.h"
+#include "common/beaconPayload-header.h"
+#include <list>
+#include <map>
+#include <vector>
 
 
 namespace ns3 {
@@ -72,29 +78,139 @@ public:
    * \param interval the interval between two beacon transmissions.
    */
   void SetBeaconInterval (Time interval);
+  /**
+   * \param txPowerDbm the power at which the beacons and data frames are sent
+   * from now on, within the power range of the phy.
+   */
+  void SetTxPowerDbm (double txPowerDbm);
+  /**
+   * \returns the power set by SetTxPowerDbm, or the maximum power of the phy.
+   */
+  double GetTxPowerDbm (void) const;
 
   //Added by Patricia Ruiz
   void StopBeaconing(void);
+  /**
+   * Starts sending a beacon every beacon interval, the first one at a random
+   * time within the interval. Does nothing if already beaconing.
+   */
+  void StartBeaconing(void);
+
+  /**
+   * Called before each beacon, to fill the application payload it carries.
+   */
+  typedef Callback<void, BeaconPayloadHeader &> BeaconPayloadCallback;
+  /**
+   * Called for each beacon received with an application payload, with the
+   * address of the sender and the receive context of the beacon.
+   */
+  typedef Callback<void, Mac48Address, const BeaconPayloadHeader &, const OvnisRxContext &> BeaconPayloadReceiveCallback;
+
+  /**
+   * \param fill the callback filling the payload of the beacons sent.
+   * \param receive the callback given the payloads of the beacons received.
+   *
+   * Lets an application piggyback its state on the beacons instead of sending
+   * packets of its own. Starts beaconing.
+   */
+  void RegisterBeaconPayload (BeaconPayloadCallback fill, BeaconPayloadReceiveCallback receive);
+  void UnregisterBeaconPayload (void);
+
+  /**
+   * Called when a neighbor is heard for the first time or again, with the
+   * beacon, the address of the neighbor and the rx power (dBm) of the beacon.
+   */
+  typedef Callback<void, Ptr<const Packet>, Mac48Address, double> NewNeighborCallback;
+  /**
+   * Called when a neighbor has not been heard for BeaconLost beacon intervals.
+   */
+  typedef Callback<void, Ptr<const Packet>, Mac48Address> NeighborLostCallback;
+
+  /**
+   * \param found the callback connected to the NewNeighbor trace source.
+   * \param lost the callback connected to the NeighborLost trace source.
+   *
+   * Connects the neighbor trace sources of this MAC without a context, for
+   * applications to bind to the MAC of their own node instead of resolving a
+   * Config path.
+   */
+  void ConnectNeighborTraces (NewNeighborCallback found, NeighborLostCallback lost);
+  void DisconnectNeighborTraces (NewNeighborCallback found, NeighborLostCallback lost);
+  /**
+   * \returns the number of ns3::BeaconingAdhocWifiMac of the node the callbacks
+   * were connected to.
+   */
+  static uint32_t ConnectNeighborTraces (Ptr<Node> node, NewNeighborCallback found, NeighborLostCallback lost);
+  static uint32_t DisconnectNeighborTraces (Ptr<Node> node, NewNeighborCallback found, NeighborLostCallback lost);
+
+  /**
+   * \param phy the phy layer attached to this MAC.
+   *
+   * Keeps the phy as a ns3::OvnisWifiPhy when it is one, to read the power of
+   * received beacons.
+   */
+  virtual void SetWifiPhy (Ptr<WifiPhy> phy);
+
+  /**
+   * \returns the receive context of the frame being forwarded up, see
+   * OvnisWifiPhy::GetRxContext. Valid in the receive callbacks of the MAC and
+   * of the sockets of the applications.
+   */
+  const OvnisRxContext & GetRxContext (void) const;
+
+  /**
+   * \returns the number of neighbors heard within the last BeaconLost beacon intervals.
+   */
+  uint32_t GetNNeighbors (void) const;
 
 private:
   virtual void Receive (Ptr<Packet> packet, const WifiMacHeader *hdr);
 
   // My own vbles (Patricia Ruiz)
     void ProcessBeacon( Ptr<Packet> packet, Mac48Address addrFrom);
-    void DecreaseBeaconCount();
+    void ExpireNeighbors();
     void SendOneBeacon (void);
     SupportedRates GetSupportedRates (void) const;
     EventId m_beaconEvent;
     double m_rxPwDbm;
 
 //    Ptr<DcaTxop> m_beaconDca;
-//    Time m_beaconInterval;
-
+    Time m_beaconInterval;
+    bool m_txPowerControl;
+    double m_txPowerDbm;
+    /**
+     * Tags the frame with the power set by SetTxPowerDbm, read by ns3::OvnisWifiPhy.
+     */
+    Ptr<const Packet> AddTxPowerTag (Ptr<const Packet> packet) const;
+
+
+    /**
+     * Neighbor liveness is kept in a timing wheel of BeaconLost + 1 slots, one
+     * slot per beacon interval. A neighbor sits in the slot of the interval in
+     * which it expires if it is not heard again. A beacon only updates the
+     * interval in which the neighbor was last heard; when the slot comes up,
+     * the neighbors heard since are moved to the slot of their new expiry and
+     * the others are lost. Each beacon interval only visits the neighbors of
+     * one slot instead of the whole list.
+     */
+    struct Neighbor
+    {
+      uint64_t lastHeard; // beacon interval in which the neighbor was last heard
+    };
+    typedef	std::map <Mac48Address,Neighbor> MacAddrMap;
+    typedef   std::map<Mac48Address, Neighbor>::iterator MacAddrMapIterator;
+    typedef std::vector<std::list<Mac48Address> > TimingWheel;
+
+    uint64_t GetExpiry (const Neighbor &neighbor) const;
+    void ResizeWheel (void);
 
-    typedef	std::map <Mac48Address,uint16_t> MacAddrMap;
-    typedef   std::map<Mac48Address, uint16_t>::iterator MacAddrMapIterator;
     uint16_t      m_numberBeaconLost;
     MacAddrMap    m_neighborList;
+    TimingWheel   m_wheel;
+    uint64_t      m_beaconTick; // beacon intervals elapsed
+    Ptr<OvnisWifiPhy> m_ovnisPhy;
+    BeaconPayloadCallback m_beaconPayloadCallback;
+    BeaconPayloadReceiveCallback m_beaconPayloadReceiveCallback;
     Callback<void,Ptr<Packet>, Mac48Address, double> m_neighborCallback;
     Callback<void,Ptr<Packet>, Mac48Address> m_neighborLostCallback;
     TracedCallback<Ptr<const Packet>, Mac48Address > m_neighborLostTraceSource;
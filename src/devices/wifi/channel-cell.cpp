@@ -8,6 +8,7 @@
  * @author Yoann Pigné
  */
 
+#include <algorithm>
 #include "channel-cell.h"
 #include "ovnis-wifi-phy.h"
 
@@ -35,4 +36,69 @@ namespace ns3
   {
   }
 
+  void
+  ChannelCell::Add(Ptr<OvnisWifiPhy> phy)
+  {
+    content[phy->GetChannelNumber()].push_back(phy);
+  }
+
+  bool
+  ChannelCell::Remove(Ptr<OvnisWifiPhy> phy)
+  {
+    // look first in the partition of the current channel, it is where the phy should be.
+    ChannelMap::iterator c = content.find(phy->GetChannelNumber());
+    if (c != content.end())
+    {
+      PhyList::iterator it = std::find(c->second.begin(), c->second.end(), phy);
+      if (it != c->second.end())
+      {
+        c->second.erase(it);
+        return true;
+      }
+    }
+    for (c = content.begin(); c != content.end(); ++c)
+    {
+      PhyList::iterator it = std::find(c->second.begin(), c->second.end(), phy);
+      if (it != c->second.end())
+      {
+        c->second.erase(it);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void
+  ChannelCell::UpdateChannelNumber(Ptr<OvnisWifiPhy> phy, uint16_t previous)
+  {
+    if (previous == phy->GetChannelNumber())
+      return;
+    ChannelMap::iterator c = content.find(previous);
+    if (c == content.end())
+      return;
+    PhyList::iterator it = std::find(c->second.begin(), c->second.end(), phy);
+    if (it == c->second.end())
+      return;
+    c->second.erase(it);
+    Add(phy);
+  }
+
+  const ChannelCell::PhyList *
+  ChannelCell::GetPhys(uint16_t channelNumber) const
+  {
+    ChannelMap::const_iterator c = content.find(channelNumber);
+    if (c == content.end())
+      return 0;
+    return &(c->second);
+  }
+
+  uint32_t
+  ChannelCell::GetNPhys() const
+  {
+    uint32_t n = 0;
+    for (ChannelMap::const_iterator c = content.begin(); c != content.end(); ++c)
+      n += c->second.size();
+    return n;
+  }
+
 }
@@ -15,6 +15,9 @@
  *
  */
 
+#include <map>
+#include <vector>
+#include <stdint.h>
 #include <ns3/ptr.h>
 #include "ns3/object.h"
 
@@ -28,11 +31,39 @@ class OvnisWifiPhy;
    public:
      static TypeId GetTypeId (void);
 
+     typedef std::vector<Ptr<OvnisWifiPhy> > PhyList;
+     typedef std::map<uint16_t, PhyList> ChannelMap;
+
      int i;
      int j;
-     std::vector<Ptr<OvnisWifiPhy> > content;
+     /**
+      * Phys located in this cell, partitioned by the channel number they are tuned to.
+      */
+     ChannelMap content;
      ChannelCell();
      virtual ~ChannelCell();
+
+     /**
+      * Adds the phy to the partition of its current channel number.
+      */
+     void Add(Ptr<OvnisWifiPhy> phy);
+     /**
+      * Removes the phy from the cell whatever partition it is in.
+      * \returns false if the phy was not in the cell.
+      */
+     bool Remove(Ptr<OvnisWifiPhy> phy);
+     /**
+      * Moves the phy from the partition of channel previous to the one of its current channel number.
+      */
+     void UpdateChannelNumber(Ptr<OvnisWifiPhy> phy, uint16_t previous);
+     /**
+      * \returns the phys of this cell tuned to channelNumber, or 0 if there is none.
+      */
+     const PhyList * GetPhys(uint16_t channelNumber) const;
+     /**
+      * \returns the number of phys in the cell, all channels included.
+      */
+     uint32_t GetNPhys() const;
    };
 
 
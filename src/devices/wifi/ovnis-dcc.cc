@@ -0,0 +1,290 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ *
+ * Copyright (c) 2010-2011 University of Luxembourg
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * @file ovnis-dcc.cc
+ */
+
+#include <algorithm>
+#include "ovnis-dcc.h"
+#include "beaconing-adhoc-wifi-mac.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+#include "ns3/pointer.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/log.h"
+
+NS_LOG_COMPONENT_DEFINE ("OvnisDcc");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (OvnisDcc);
+
+TypeId
+OvnisDcc::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::OvnisDcc")
+    .SetParent<Object> ()
+    .AddConstructor<OvnisDcc> ()
+    .AddAttribute ("Window",
+                   "Duration over which the channel busy ratio is measured.",
+                   TimeValue (Seconds (1)),
+                   MakeTimeAccessor (&OvnisDcc::m_window),
+                   MakeTimeChecker ())
+    .AddAttribute ("ActiveCbr",
+                   "Channel busy ratio from which the ACTIVE state is entered.",
+                   DoubleValue (0.3),
+                   MakeDoubleAccessor (&OvnisDcc::m_activeCbr),
+                   MakeDoubleChecker<double> (0.0, 1.0))
+    .AddAttribute ("RestrictiveCbr",
+                   "Channel busy ratio from which the RESTRICTIVE state is entered.",
+                   DoubleValue (0.4),
+                   MakeDoubleAccessor (&OvnisDcc::m_restrictiveCbr),
+                   MakeDoubleChecker<double> (0.0, 1.0))
+    .AddAttribute ("RelaxWindows",
+                   "Number of windows below its threshold before leaving a state for a less restrictive one.",
+                   UintegerValue (5),
+                   MakeUintegerAccessor (&OvnisDcc::m_relaxWindows),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("BaseBeaconInterval",
+                   "Beacon interval in the RELAXED state.",
+                   TimeValue (Seconds (1)),
+                   MakeTimeAccessor (&OvnisDcc::m_baseBeaconInterval),
+                   MakeTimeChecker ())
+    .AddAttribute ("BaseAppInterval",
+                   "Application sending interval in the RELAXED state.",
+                   TimeValue (Seconds (1)),
+                   MakeTimeAccessor (&OvnisDcc::m_baseAppInterval),
+                   MakeTimeChecker ())
+    .AddAttribute ("ActiveIntervalFactor",
+                   "Factor applied to the base intervals in the ACTIVE state.",
+                   DoubleValue (2),
+                   MakeDoubleAccessor (&OvnisDcc::m_activeIntervalFactor),
+                   MakeDoubleChecker<double> (1.0))
+    .AddAttribute ("RestrictiveIntervalFactor",
+                   "Factor applied to the base intervals in the RESTRICTIVE state.",
+                   DoubleValue (4),
+                   MakeDoubleAccessor (&OvnisDcc::m_restrictiveIntervalFactor),
+                   MakeDoubleChecker<double> (1.0))
+    .AddAttribute ("ActivePowerReduction",
+                   "Reduction (dB) of the tx power in the ACTIVE state.",
+                   DoubleValue (3),
+                   MakeDoubleAccessor (&OvnisDcc::m_activePowerReduction),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("RestrictivePowerReduction",
+                   "Reduction (dB) of the tx power in the RESTRICTIVE state.",
+                   DoubleValue (6),
+                   MakeDoubleAccessor (&OvnisDcc::m_restrictivePowerReduction),
+                   MakeDoubleChecker<double> (0.0))
+    .AddTraceSource ("ChannelBusyRatio", "The channel busy ratio measured over a window.",
+                     MakeTraceSourceAccessor (&OvnisDcc::m_cbrTrace))
+    .AddTraceSource ("OperatingPoint", "State, beacon interval, application interval and tx power (dBm) chosen.",
+                     MakeTraceSourceAccessor (&OvnisDcc::m_operatingPointTrace))
+  ;
+  return tid;
+}
+
+OvnisDcc::OvnisDcc ()
+  : m_cbr (0),
+    m_state (RELAXED),
+    m_windowsBelow (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+OvnisDcc::~OvnisDcc ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+OvnisDcc::DoDispose (void)
+{
+  m_windowEvent.Cancel ();
+  m_phy = 0;
+  m_mac = 0;
+  Object::DoDispose ();
+}
+
+void
+OvnisDcc::Install (Ptr<WifiNetDevice> device)
+{
+  NS_LOG_FUNCTION (this << device);
+  m_phy = device->GetPhy ();
+  m_mac = DynamicCast<BeaconingAdhocWifiMac> (device->GetMac ());
+  PointerValue state;
+  m_phy->GetAttribute ("State", state);
+  state.GetObject ()->TraceConnectWithoutContext ("State", MakeCallback (&OvnisDcc::PhyStateChanged, this));
+  device->GetNode ()->AggregateObject (this);
+  Start ();
+}
+
+void
+OvnisDcc::Start (void)
+{
+  m_windowEvent.Cancel ();
+  m_windowStart = Simulator::Now ();
+  m_busy = Seconds (0);
+  m_busyUntil = m_windowStart;
+  m_late = Seconds (0);
+  m_windowEvent = Simulator::Schedule (m_window, &OvnisDcc::EndWindow, this);
+  Apply ();
+}
+
+void
+OvnisDcc::Stop (void)
+{
+  m_windowEvent.Cancel ();
+}
+
+void
+OvnisDcc::PhyStateChanged (Time start, Time duration, WifiPhy::State state)
+{
+  NotifyPhyState (start, duration, state);
+}
+
+void
+OvnisDcc::NotifyPhyState (Time start, Time duration, WifiPhy::State state)
+{
+  if (state == WifiPhy::IDLE)
+    {
+      return;
+    }
+  // periods may overlap, only count the new time
+  Time end = start + duration;
+  Time from = std::max (start, m_busyUntil);
+  if (end <= from)
+    {
+      return;
+    }
+  if (from < m_windowStart)
+    {
+      // the windows ended before the period was reported
+      m_late += std::min (end, m_windowStart) - from;
+      from = m_windowStart;
+    }
+  if (end > from)
+    {
+      m_busy += end - from;
+    }
+  m_busyUntil = end;
+}
+
+void
+OvnisDcc::EndWindow (void)
+{
+  Time now = Simulator::Now ();
+  // the end of a period that goes on after the window belongs to the next one
+  Time carry = m_busyUntil > now ? m_busyUntil - now : Seconds (0);
+  m_cbr = std::min (1.0, (m_busy - carry + m_late).GetSeconds () / (now - m_windowStart).GetSeconds ());
+  m_busy = carry;
+  m_late = Seconds (0);
+  m_windowStart = now;
+  m_cbrTrace (m_cbr);
+
+  State target = m_cbr >= m_restrictiveCbr ? RESTRICTIVE : (m_cbr >= m_activeCbr ? ACTIVE : RELAXED);
+  if (target > m_state)
+    {
+      m_state = target;
+      m_windowsBelow = 0;
+      Apply ();
+    }
+  else if (target < m_state)
+    {
+      if (++m_windowsBelow >= m_relaxWindows)
+        {
+          m_state = (State) (m_state - 1);
+          m_windowsBelow = 0;
+          Apply ();
+        }
+    }
+  else
+    {
+      m_windowsBelow = 0;
+    }
+  m_windowEvent = Simulator::Schedule (m_window, &OvnisDcc::EndWindow, this);
+}
+
+void
+OvnisDcc::Apply (void)
+{
+  NS_LOG_FUNCTION (this << m_state << m_cbr);
+  if (m_mac != 0)
+    {
+      m_mac->SetBeaconInterval (GetBeaconInterval ());
+      m_mac->SetTxPowerDbm (GetTxPowerDbm ());
+    }
+  m_operatingPointTrace (m_state, GetBeaconInterval (), GetAppInterval (), GetTxPowerDbm ());
+}
+
+OvnisDcc::State
+OvnisDcc::GetState (void) const
+{
+  return m_state;
+}
+
+double
+OvnisDcc::GetChannelBusyRatio (void) const
+{
+  return m_cbr;
+}
+
+double
+OvnisDcc::GetIntervalFactor (void) const
+{
+  switch (m_state)
+    {
+    case ACTIVE:
+      return m_activeIntervalFactor;
+    case RESTRICTIVE:
+      return m_restrictiveIntervalFactor;
+    default:
+      return 1;
+    }
+}
+
+Time
+OvnisDcc::GetBeaconInterval (void) const
+{
+  return Seconds (m_baseBeaconInterval.GetSeconds () * GetIntervalFactor ());
+}
+
+Time
+OvnisDcc::GetAppInterval (void) const
+{
+  return Seconds (m_baseAppInterval.GetSeconds () * GetIntervalFactor ());
+}
+
+double
+OvnisDcc::GetTxPowerDbm (void) const
+{
+  double maxPowerDbm = m_phy != 0 ? m_phy->GetTxPowerEnd () : 0;
+  switch (m_state)
+    {
+    case ACTIVE:
+      return maxPowerDbm - m_activePowerReduction;
+    case RESTRICTIVE:
+      return maxPowerDbm - m_restrictivePowerReduction;
+    default:
+      return maxPowerDbm;
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,152 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ *
+ * Copyright (c) 2010-2011 University of Luxembourg
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * @file ovnis-dcc.h
+ */
+
+#ifndef OVNIS_DCC_H
+#define OVNIS_DCC_H
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/traced-callback.h"
+#include "ns3/wifi-phy.h"
+
+namespace ns3 {
+
+class WifiNetDevice;
+class BeaconingAdhocWifiMac;
+
+/**
+ * \brief Decentralized congestion control, after the reactive DCC of ETSI TS 102 687.
+ *
+ * The channel busy ratio (CBR) is the fraction of time the phy is not idle (Tx,
+ * Rx, CCA busy or switching), measured over windows of Window from the State
+ * trace of the phy. The vehicle is in one of three states:
+ *  - RELAXED: the beacon and application intervals are the base ones and the
+ *    frames are sent at the maximum power of the phy;
+ *  - ACTIVE: intervals multiplied by ActiveIntervalFactor, power lowered by
+ *    ActivePowerReduction;
+ *  - RESTRICTIVE: intervals multiplied by RestrictiveIntervalFactor, power lowered
+ *    by RestrictivePowerReduction.
+ * It goes to a more restrictive state as soon as the CBR of a window reaches the
+ * threshold of that state, and to a less restrictive one after RelaxWindows windows
+ * below the threshold.
+ *
+ * The phy reports a reception or a CCA busy period when it ends, so that the part
+ * of a period before the end of a window is only known during the next window: it
+ * is then counted in the next window, one window late, rather than lost.
+ *
+ * The beacon interval and the tx power are applied to the ns3::BeaconingAdhocWifiMac
+ * of the device, the power being carried to the phy by a ns3::MyTxEnergyTag.
+ * Applications read GetAppInterval. Aggregated to the node by Install.
+ */
+class OvnisDcc : public Object
+{
+public:
+  enum State
+  {
+    RELAXED = 0,
+    ACTIVE = 1,
+    RESTRICTIVE = 2
+  };
+
+  static TypeId GetTypeId (void);
+
+  OvnisDcc ();
+  virtual ~OvnisDcc ();
+
+  /**
+   * \param device the device whose phy is measured and whose MAC is controlled.
+   *
+   * Aggregates the object to the node of the device and starts measuring.
+   */
+  void Install (Ptr<WifiNetDevice> device);
+  /**
+   * Starts a new window, without a device when the phy states are notified
+   * through NotifyPhyState.
+   */
+  void Start (void);
+  /**
+   * Stops measuring, eg. when the vehicle has left the simulation.
+   */
+  void Stop (void);
+  /**
+   * The phy has been in state from start for duration, as by its State trace.
+   */
+  void NotifyPhyState (Time start, Time duration, WifiPhy::State state);
+
+  State GetState (void) const;
+  /**
+   * \returns the channel busy ratio of the last complete window.
+   */
+  double GetChannelBusyRatio (void) const;
+  /**
+   * \returns the factor applied to the intervals in the current state, for
+   * applications sending at intervals of their own.
+   */
+  double GetIntervalFactor (void) const;
+  Time GetBeaconInterval (void) const;
+  Time GetAppInterval (void) const;
+  double GetTxPowerDbm (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  void PhyStateChanged (Time start, Time duration, WifiPhy::State state);
+  void EndWindow (void);
+  void Apply (void);
+
+  Time m_window;
+  double m_activeCbr;
+  double m_restrictiveCbr;
+  uint32_t m_relaxWindows;
+  Time m_baseBeaconInterval;
+  Time m_baseAppInterval;
+  double m_activeIntervalFactor;
+  double m_restrictiveIntervalFactor;
+  double m_activePowerReduction;
+  double m_restrictivePowerReduction;
+
+  Ptr<WifiPhy> m_phy;
+  Ptr<BeaconingAdhocWifiMac> m_mac;
+  EventId m_windowEvent;
+  Time m_windowStart;
+  Time m_busy;      // busy time counted in the current window
+  Time m_busyUntil; // end of the last busy period counted
+  Time m_late;      // busy time of the windows ended, reported after their end
+  double m_cbr;
+  State m_state;
+  uint32_t m_windowsBelow;
+
+  /**
+   * Channel busy ratio of each window.
+   */
+  TracedCallback<double> m_cbrTrace;
+  /**
+   * Operating point after each change of state: state, beacon interval,
+   * application interval and tx power (dBm).
+   */
+  TracedCallback<uint32_t, Time, Time, double> m_operatingPointTrace;
+};
+
+} // namespace ns3
+
+#endif /* OVNIS_DCC_H */
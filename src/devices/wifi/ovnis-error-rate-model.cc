@@ -17,8 +17,11 @@
  *
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
+#include <cmath>
 #include "ovnis-error-rate-model.h"
 #include "ns3/wifi-phy.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
 #include "ns3/log.h"
 
 
@@ -30,7 +33,14 @@ namespace ns3 {
 
   NS_OBJECT_ENSURE_REGISTERED (OvnisErrorRateModel);
 
-
+// SNR range (dB) covered by the lookup tables, the analytic model is used outside.
+static const double TABLE_MIN_SNR_DB = -10.0;
+static const double TABLE_MAX_SNR_DB = 40.0;
+// Finest resolution the validation may refine a table to.
+static const double TABLE_MIN_STEP_DB = 0.001;
+// Bounds of the stored exponent, for per-bit success rates of exactly 1 and 0.
+static const double TABLE_MIN_EXPONENT = -700.0;
+static const double TABLE_MAX_EXPONENT = 700.0;
 
 TypeId 
 OvnisErrorRateModel::GetTypeId (void)
@@ -38,6 +48,22 @@ OvnisErrorRateModel::GetTypeId (void)
   static TypeId tid = TypeId ("ns3::OvnisErrorRateModel")
     .SetParent<ErrorRateModel> ()
     .AddConstructor<OvnisErrorRateModel> ()
+    .AddAttribute ("UseLookupTable",
+                   "Read the success rate of OFDM modes from precomputed tables instead of the analytic model.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&OvnisErrorRateModel::m_useLookupTable),
+                   MakeBooleanChecker ())
+    .AddAttribute ("TableResolution",
+                   "Initial SNR step (dB) between two points of the lookup tables.",
+                   DoubleValue (0.1),
+                   MakeDoubleAccessor (&OvnisErrorRateModel::m_tableResolutionDb),
+                   MakeDoubleChecker<double> (TABLE_MIN_STEP_DB))
+    .AddAttribute ("TableMaxError",
+                   "Largest absolute error on a chunk success rate tolerated for the lookup tables. "
+                   "Tables are refined until they meet it.",
+                   DoubleValue (1e-3),
+                   MakeDoubleAccessor (&OvnisErrorRateModel::m_tableMaxError),
+                   MakeDoubleChecker<double> (0.0))
     ;
   return tid;
 }
@@ -47,6 +73,9 @@ OvnisErrorRateModel::GetTypeId (void)
 
 
 OvnisErrorRateModel::OvnisErrorRateModel ()
+  : m_useLookupTable (false),
+    m_tableResolutionDb (0.1),
+    m_tableMaxError (1e-3)
 {}
 
 double 
@@ -177,8 +206,108 @@ OvnisErrorRateModel::GetFecQamBer (double snr, uint32_t nbits,
   return pms;
 }
 
-double 
+double
 OvnisErrorRateModel::GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const
+{
+  if (m_useLookupTable
+      && (mode.GetModulationClass () == WIFI_MOD_CLASS_ERP_OFDM
+          || mode.GetModulationClass () == WIFI_MOD_CLASS_OFDM)
+      && snr > 0)
+    {
+      double snrDb = 10.0 * std::log10 (snr);
+      if (snrDb >= TABLE_MIN_SNR_DB && snrDb < TABLE_MAX_SNR_DB)
+        {
+          return GetTabulatedChunkSuccessRate (GetTable (mode), snrDb, nbits);
+        }
+    }
+  return GetAnalyticChunkSuccessRate (mode, snr, nbits);
+}
+
+double
+OvnisErrorRateModel::GetTableErrorBound (WifiMode mode) const
+{
+  std::map<uint32_t, SuccessRateTable>::const_iterator it = m_tables.find (mode.GetUid ());
+  if (it == m_tables.end ())
+    {
+      return -1;
+    }
+  return it->second.errorBound;
+}
+
+double
+OvnisErrorRateModel::GetTabulatedChunkSuccessRate (const SuccessRateTable &table, double snrDb, uint32_t nbits) const
+{
+  double position = (snrDb - TABLE_MIN_SNR_DB) / table.stepDb;
+  uint32_t index = (uint32_t) position;
+  if (index + 1 >= table.exponent.size ())
+    {
+      index = table.exponent.size () - 2;
+    }
+  double ratio = position - index;
+  double exponent = table.exponent[index] + ratio * (table.exponent[index + 1] - table.exponent[index]);
+  // s^nbits accumulated in the log domain: ln(s^nbits) = -nbits * exp(exponent)
+  return std::exp (-(double) nbits * std::exp (exponent));
+}
+
+const OvnisErrorRateModel::SuccessRateTable &
+OvnisErrorRateModel::GetTable (WifiMode mode) const
+{
+  std::map<uint32_t, SuccessRateTable>::iterator it = m_tables.find (mode.GetUid ());
+  if (it != m_tables.end ())
+    {
+      return it->second;
+    }
+  SuccessRateTable &table = m_tables[mode.GetUid ()];
+  double stepDb = m_tableResolutionDb;
+  double error = BuildTable (mode, stepDb, table);
+  while (error > m_tableMaxError && stepDb / 2 >= TABLE_MIN_STEP_DB)
+    {
+      stepDb /= 2;
+      error = BuildTable (mode, stepDb, table);
+    }
+  if (error > m_tableMaxError)
+    {
+      NS_LOG_WARN ("lookup table of mode " << mode << " does not meet the error bound: " << error << " > " << m_tableMaxError);
+    }
+  NS_LOG_INFO ("lookup table of mode " << mode << ": " << table.exponent.size () << " points, step=" << stepDb << "dB, error bound=" << error);
+  return table;
+}
+
+double
+OvnisErrorRateModel::BuildTable (WifiMode mode, double stepDb, SuccessRateTable &table) const
+{
+  uint32_t size = (uint32_t) std::ceil ((TABLE_MAX_SNR_DB - TABLE_MIN_SNR_DB) / stepDb) + 1;
+  table.stepDb = stepDb;
+  table.exponent.resize (size);
+  for (uint32_t i = 0; i < size; i++)
+    {
+      double snr = std::pow (10.0, (TABLE_MIN_SNR_DB + i * stepDb) / 10.0);
+      double perBit = GetAnalyticChunkSuccessRate (mode, snr, 1);
+      double exponent = perBit > 0 ? std::log (-std::log (perBit)) : TABLE_MAX_EXPONENT;
+      table.exponent[i] = std::max (TABLE_MIN_EXPONENT, std::min (TABLE_MAX_EXPONENT, exponent));
+    }
+
+  // Validation half-way between the sampled points, where the interpolation is the worst,
+  // for chunk sizes from a single symbol to a full frame.
+  static const uint32_t checkedBits[] = { 1, 24, 400, 12000 };
+  double error = 0;
+  for (uint32_t i = 0; i + 1 < size; i++)
+    {
+      double snrDb = TABLE_MIN_SNR_DB + (i + 0.5) * stepDb;
+      double snr = std::pow (10.0, snrDb / 10.0);
+      for (uint32_t k = 0; k < sizeof (checkedBits) / sizeof (checkedBits[0]); k++)
+        {
+          double analytic = GetAnalyticChunkSuccessRate (mode, snr, checkedBits[k]);
+          double tabulated = GetTabulatedChunkSuccessRate (table, snrDb, checkedBits[k]);
+          error = std::max (error, std::fabs (analytic - tabulated));
+        }
+    }
+  table.errorBound = error;
+  return error;
+}
+
+double 
+OvnisErrorRateModel::GetAnalyticChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const
 {
   if (mode.GetModulationClass () == WIFI_MOD_CLASS_ERP_OFDM ||
       mode.GetModulationClass () == WIFI_MOD_CLASS_OFDM)
@@ -21,6 +21,8 @@
 #define OVNIS_ERROR_RATE_MODEL_H
 
 #include <stdint.h>
+#include <map>
+#include <vector>
 #include "ns3/wifi-mode.h"
 #include "ns3/error-rate-model.h"
 #include "ns3/dsss-error-rate-model.h"
@@ -52,6 +54,14 @@ namespace ns3 {
  *      57(2):440-449, February 2009.
  *    - More detailed description and validation can be found in 
  *      http://www.nsnam.org/~pei/80211b.pdf
+ *
+ * When the UseLookupTable attribute is set, the OFDM success rates are read from
+ * per-mode tables built on the first reception with that mode. For a given SNR the
+ * analytic model gives a per-bit success rate s, and a chunk of n bits succeeds with
+ * probability s^n. The tables store ln(-ln(s)) against the SNR in dB, which is close
+ * to linear, and the chunk success rate is then exp(-n * exp(interpolated value)).
+ * After a table is built it is checked against the analytic model half-way between
+ * the sampled points. Its resolution is halved until the error is within TableMaxError.
  */
 class OvnisErrorRateModel : public ErrorRateModel
 {
@@ -64,7 +74,26 @@ public:
 
   virtual double GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const;
 
+  /**
+   * \param mode an OFDM mode
+   * \returns the largest absolute difference between the tabulated and the analytic chunk
+   * success rate measured when the table of this mode was built, or -1 if there is no table yet.
+   */
+  double GetTableErrorBound (WifiMode mode) const;
+
 private:
+  struct SuccessRateTable
+  {
+    double stepDb;
+    double errorBound;
+    std::vector<double> exponent; // ln(-ln(per bit success rate)) every stepDb from the minimum SNR
+  };
+
+  double GetAnalyticChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const;
+  double GetTabulatedChunkSuccessRate (const SuccessRateTable &table, double snrDb, uint32_t nbits) const;
+  const SuccessRateTable & GetTable (WifiMode mode) const;
+  double BuildTable (WifiMode mode, double stepDb, SuccessRateTable &table) const;
+
   double Log2 (double val) const;
   double GetBpskBer (double snr, uint32_t signalSpread, uint32_t phyRate) const;
   double GetQamBer (double snr, unsigned int m, uint32_t signalSpread, uint32_t phyRate) const;
@@ -81,6 +110,11 @@ private:
                        uint32_t phyRate,
                        uint32_t m, uint32_t dfree,
                        uint32_t adFree, uint32_t adFreePlusOne) const;
+
+  bool m_useLookupTable;
+  double m_tableResolutionDb;
+  double m_tableMaxError;
+  mutable std::map<uint32_t, SuccessRateTable> m_tables; // indexed by the uid of the mode
 };
 
 
@@ -0,0 +1,364 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ *
+ * Copyright (c) 2010-2011 University of Luxembourg
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * @file ovnis-interference-tracker.cc
+ */
+
+#include <algorithm>
+#include "ovnis-interference-tracker.h"
+#include "ns3/wifi-phy.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+
+NS_LOG_COMPONENT_DEFINE ("OvnisInterferenceTracker");
+
+namespace ns3 {
+
+/****************************************************************
+ *       Event
+ ****************************************************************/
+
+OvnisInterferenceTracker::Event::Event (uint32_t size, WifiMode payloadMode,
+                                        enum WifiPreamble preamble,
+                                        Time duration, double rxPower, WifiTxVector txVector)
+  : m_size (size),
+    m_payloadMode (payloadMode),
+    m_preamble (preamble),
+    m_startTime (Simulator::Now ()),
+    m_endTime (m_startTime + duration),
+    m_rxPowerW (rxPower),
+    m_txVector (txVector)
+{
+}
+OvnisInterferenceTracker::Event::~Event ()
+{
+}
+
+Time
+OvnisInterferenceTracker::Event::GetDuration (void) const
+{
+  return m_endTime - m_startTime;
+}
+Time
+OvnisInterferenceTracker::Event::GetStartTime (void) const
+{
+  return m_startTime;
+}
+Time
+OvnisInterferenceTracker::Event::GetEndTime (void) const
+{
+  return m_endTime;
+}
+double
+OvnisInterferenceTracker::Event::GetRxPowerW (void) const
+{
+  return m_rxPowerW;
+}
+uint32_t
+OvnisInterferenceTracker::Event::GetSize (void) const
+{
+  return m_size;
+}
+WifiMode
+OvnisInterferenceTracker::Event::GetPayloadMode (void) const
+{
+  return m_payloadMode;
+}
+enum WifiPreamble
+OvnisInterferenceTracker::Event::GetPreambleType (void) const
+{
+  return m_preamble;
+}
+WifiTxVector
+OvnisInterferenceTracker::Event::GetTxVector (void) const
+{
+  return m_txVector;
+}
+
+/****************************************************************
+ *       The actual OvnisInterferenceTracker
+ ****************************************************************/
+
+OvnisInterferenceTracker::OvnisInterferenceTracker ()
+  : m_firstActive (0),
+    m_prunedPowerW (0),
+    m_rxing (false),
+    m_noiseFigure (1),
+    m_errorRateModel (0)
+{
+}
+OvnisInterferenceTracker::~OvnisInterferenceTracker ()
+{
+  EraseEvents ();
+  m_errorRateModel = 0;
+}
+
+void
+OvnisInterferenceTracker::SetNoiseFigure (double value)
+{
+  m_noiseFigure = value;
+}
+double
+OvnisInterferenceTracker::GetNoiseFigure (void) const
+{
+  return m_noiseFigure;
+}
+void
+OvnisInterferenceTracker::SetErrorRateModel (Ptr<ErrorRateModel> rate)
+{
+  m_errorRateModel = rate;
+}
+Ptr<ErrorRateModel>
+OvnisInterferenceTracker::GetErrorRateModel (void) const
+{
+  return m_errorRateModel;
+}
+
+Ptr<OvnisInterferenceTracker::Event>
+OvnisInterferenceTracker::Add (uint32_t size, WifiMode payloadMode,
+                               enum WifiPreamble preamble,
+                               Time duration, double rxPowerW, WifiTxVector txVector)
+{
+  Prune ();
+  Slot slot;
+  slot.event = Create<Event> (size, payloadMode, preamble, duration, rxPowerW, txVector);
+  slot.end = slot.event->GetEndTime ();
+  // frames have close durations, a new signal almost always ends last
+  uint32_t pos = m_slots.size ();
+  while (pos > m_firstActive && m_slots[pos - 1].end > slot.end)
+    {
+      pos--;
+    }
+  m_slots.insert (m_slots.begin () + pos, slot);
+  for (uint32_t i = pos; i < m_slots.size (); i++)
+    {
+      m_slots[i].cumPowerW = GetPowerBefore (i) + m_slots[i].event->GetRxPowerW ();
+    }
+  return slot.event;
+}
+
+double
+OvnisInterferenceTracker::GetPowerBefore (uint32_t i) const
+{
+  return i == 0 ? m_prunedPowerW : m_slots[i - 1].cumPowerW;
+}
+
+void
+OvnisInterferenceTracker::Prune (void)
+{
+  Time now = Simulator::Now ();
+  while (m_firstActive < m_slots.size () && m_slots[m_firstActive].end <= now)
+    {
+      m_firstActive++;
+    }
+  // signals that overlap the frame being received are needed at its end
+  Time horizon = m_rxing ? m_rxStart : now;
+  while (m_firstActive > 0 && m_slots.front ().end <= horizon)
+    {
+      m_prunedPowerW = m_slots.front ().cumPowerW;
+      m_slots.pop_front ();
+      m_firstActive--;
+    }
+  if (m_slots.empty ())
+    {
+      // restart the running total, it does not grow for the whole simulation
+      m_prunedPowerW = 0;
+    }
+}
+
+double
+OvnisInterferenceTracker::GetEnergyW (void)
+{
+  Prune ();
+  double energyW = GetPowerBefore (m_slots.size ()) - GetPowerBefore (m_firstActive);
+  return std::max (energyW, 0.0);
+}
+
+Time
+OvnisInterferenceTracker::GetEnergyDuration (double energyW)
+{
+  double total = GetEnergyW ();
+  if (total < energyW)
+    {
+      return Seconds (0);
+    }
+  // first slot at whose end the remaining power is under energyW, the
+  // remaining power decreasing along the slots
+  double all = GetPowerBefore (m_slots.size ());
+  uint32_t low = m_firstActive;
+  uint32_t high = m_slots.size () - 1;
+  while (low < high)
+    {
+      uint32_t middle = low + (high - low) / 2;
+      if (all - m_slots[middle].cumPowerW < energyW)
+        {
+          high = middle;
+        }
+      else
+        {
+          low = middle + 1;
+        }
+    }
+  return m_slots[low].end - Simulator::Now ();
+}
+
+double
+OvnisInterferenceTracker::CalculateNoiseFloorW (WifiMode mode) const
+{
+  // thermal noise at 290K in J/s = W
+  static const double BOLTZMANN = 1.3803e-23;
+  double nbw = BOLTZMANN * 290.0 * mode.GetBandwidth ();
+  return m_noiseFigure * nbw;
+}
+
+void
+OvnisInterferenceTracker::GetSinrChunks (Ptr<const Event> event, SinrChunks &chunks) const
+{
+  chunks.clear ();
+  Time start = event->GetStartTime ();
+  Time end = event->GetEndTime ();
+
+  // slots are ordered by end time: the signals over before the frame are
+  // skipped at once
+  uint32_t low = 0;
+  uint32_t high = m_slots.size ();
+  while (low < high)
+    {
+      uint32_t middle = low + (high - low) / 2;
+      if (m_slots[middle].end <= start)
+        {
+          low = middle + 1;
+        }
+      else
+        {
+          high = middle;
+        }
+    }
+  std::vector<std::pair<Time, double> > changes;
+  for (uint32_t i = low; i < m_slots.size (); i++)
+    {
+      const Ptr<Event> &other = m_slots[i].event;
+      if (other == event || other->GetStartTime () >= end)
+        {
+          continue;
+        }
+      changes.push_back (std::make_pair (std::max (other->GetStartTime (), start), other->GetRxPowerW ()));
+      if (other->GetEndTime () < end)
+        {
+          changes.push_back (std::make_pair (other->GetEndTime (), -other->GetRxPowerW ()));
+        }
+    }
+  std::sort (changes.begin (), changes.end ());
+
+  double noiseW = CalculateNoiseFloorW (event->GetPayloadMode ());
+  double interferenceW = 0;
+  std::vector<std::pair<Time, double> >::const_iterator it = changes.begin ();
+  Time previous = start;
+  while (previous < end)
+    {
+      while (it != changes.end () && it->first <= previous)
+        {
+          interferenceW += it->second;
+          ++it;
+        }
+      SinrChunk chunk;
+      chunk.start = previous;
+      chunk.end = it != changes.end () ? it->first : end;
+      chunk.sinr = event->GetRxPowerW () / (noiseW + std::max (interferenceW, 0.0));
+      chunks.push_back (chunk);
+      previous = chunk.end;
+    }
+}
+
+double
+OvnisInterferenceTracker::CalculateChunkSuccessRate (double sinr, Time duration, WifiMode mode) const
+{
+  if (duration <= Seconds (0))
+    {
+      return 1.0;
+    }
+  uint64_t nbits = (uint64_t) (mode.GetDataRate () * duration.GetSeconds ());
+  return m_errorRateModel->GetChunkSuccessRate (mode, sinr, (uint32_t) nbits);
+}
+
+struct OvnisInterferenceTracker::SnrPer
+OvnisInterferenceTracker::CalculateSnrPer (Ptr<const Event> event) const
+{
+  SinrChunks chunks;
+  GetSinrChunks (event, chunks);
+  NS_ASSERT (!chunks.empty ());
+
+  // as in InterferenceHelper the preamble is not decoded, the HT-SIG and HT
+  // training fields are accounted with the PLCP header
+  WifiMode payloadMode = event->GetPayloadMode ();
+  WifiPreamble preamble = event->GetPreambleType ();
+  WifiMode headerMode = WifiPhy::GetPlcpHeaderMode (payloadMode, preamble);
+  Time headerStart = event->GetStartTime ()
+    + MicroSeconds (WifiPhy::GetPlcpPreambleDurationMicroSeconds (payloadMode, preamble));
+  Time payloadStart = headerStart
+    + MicroSeconds (WifiPhy::GetPlcpHeaderDurationMicroSeconds (payloadMode, preamble))
+    + MicroSeconds (WifiPhy::GetPlcpHtSigHeaderDurationMicroSeconds (payloadMode, preamble))
+    + MicroSeconds (WifiPhy::GetPlcpHtTrainingSymbolDurationMicroSeconds (payloadMode, preamble, event->GetTxVector ()));
+
+  double psr = 1.0;
+  for (SinrChunks::const_iterator it = chunks.begin (); it != chunks.end (); ++it)
+    {
+      psr *= CalculateChunkSuccessRate (it->sinr,
+                                        std::min (it->end, payloadStart) - std::max (it->start, headerStart),
+                                        headerMode);
+      psr *= CalculateChunkSuccessRate (it->sinr,
+                                        it->end - std::max (it->start, payloadStart),
+                                        payloadMode);
+    }
+
+  struct SnrPer snrPer;
+  snrPer.snr = chunks.front ().sinr;
+  snrPer.per = 1 - psr;
+  return snrPer;
+}
+
+void
+OvnisInterferenceTracker::NotifyRxStart (void)
+{
+  m_rxing = true;
+  m_rxStart = Simulator::Now ();
+}
+
+void
+OvnisInterferenceTracker::NotifyRxEnd (void)
+{
+  m_rxing = false;
+  Prune ();
+}
+
+void
+OvnisInterferenceTracker::EraseEvents (void)
+{
+  m_slots.clear ();
+  m_firstActive = 0;
+  m_prunedPowerW = 0;
+  m_rxing = false;
+}
+
+uint32_t
+OvnisInterferenceTracker::GetNEvents (void) const
+{
+  return m_slots.size ();
+}
+
+} // namespace ns3
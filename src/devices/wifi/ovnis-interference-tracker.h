@@ -0,0 +1,178 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ *
+ * Copyright (c) 2010-2011 University of Luxembourg
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * @file ovnis-interference-tracker.h
+ */
+
+#ifndef OVNIS_INTERFERENCE_TRACKER_H
+#define OVNIS_INTERFERENCE_TRACKER_H
+
+#include <deque>
+#include <vector>
+#include <stdint.h>
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/wifi-mode.h"
+#include "ns3/wifi-preamble.h"
+#include "ns3/wifi-tx-vector.h"
+#include "ns3/error-rate-model.h"
+
+namespace ns3 {
+
+/**
+ * \brief Signals on the medium of an ns3::OvnisWifiPhy.
+ *
+ * Replaces the ns3::InterferenceHelper of the phy, whose list of signals only
+ * shrinks on a channel switch. Signals are kept ordered by end time and are
+ * removed as soon as they are over, unless a frame is being received: then the
+ * signals that overlap it are kept until NotifyRxEnd, for CalculateSnrPer. Each
+ * slot also holds the running total of the powers up to it, so the power on the
+ * medium and the delay until it drops under a threshold (CCA) are read with a
+ * binary search instead of a walk over the past signals.
+ *
+ * The reception of a frame is described by its SINR chunks, the periods during
+ * which the interference on it is constant, from which the packet error rate is
+ * computed with the ns3::ErrorRateModel of the phy, as by InterferenceHelper.
+ */
+class OvnisInterferenceTracker
+{
+public:
+  class Event : public SimpleRefCount<Event>
+  {
+  public:
+    Event (uint32_t size, WifiMode payloadMode,
+           enum WifiPreamble preamble,
+           Time duration, double rxPower, WifiTxVector txVector);
+    ~Event ();
+
+    Time GetDuration (void) const;
+    Time GetStartTime (void) const;
+    Time GetEndTime (void) const;
+    double GetRxPowerW (void) const;
+    uint32_t GetSize (void) const;
+    WifiMode GetPayloadMode (void) const;
+    enum WifiPreamble GetPreambleType (void) const;
+    WifiTxVector GetTxVector (void) const;
+
+  private:
+    uint32_t m_size;
+    WifiMode m_payloadMode;
+    enum WifiPreamble m_preamble;
+    Time m_startTime;
+    Time m_endTime;
+    double m_rxPowerW;
+    WifiTxVector m_txVector;
+  };
+
+  struct SnrPer
+  {
+    double snr;
+    double per;
+  };
+
+  /**
+   * A period of a reception with a constant interference.
+   */
+  struct SinrChunk
+  {
+    Time start;
+    Time end;
+    double sinr;
+  };
+  typedef std::vector<SinrChunk> SinrChunks;
+
+  OvnisInterferenceTracker ();
+  ~OvnisInterferenceTracker ();
+
+  void SetNoiseFigure (double value);
+  void SetErrorRateModel (Ptr<ErrorRateModel> rate);
+  double GetNoiseFigure (void) const;
+  Ptr<ErrorRateModel> GetErrorRateModel (void) const;
+
+  /**
+   * Adds a signal starting now.
+   */
+  Ptr<Event> Add (uint32_t size, WifiMode payloadMode,
+                  enum WifiPreamble preamble,
+                  Time duration, double rxPower, WifiTxVector txVector);
+
+  /**
+   * \returns the power (W) of the signals on the medium.
+   */
+  double GetEnergyW (void);
+  /**
+   * \returns the delay until the power on the medium drops under energyW,
+   * zero if it is already under.
+   */
+  Time GetEnergyDuration (double energyW);
+
+  /**
+   * \param event a signal added to the tracker, whose reception is over.
+   * \param chunks filled with the chunks of event, in time order.
+   */
+  void GetSinrChunks (Ptr<const Event> event, SinrChunks &chunks) const;
+  /**
+   * \returns the SNR at the start of event and its packet error rate.
+   */
+  struct SnrPer CalculateSnrPer (Ptr<const Event> event) const;
+
+  /**
+   * The phy is synchronized on the signal added last.
+   */
+  void NotifyRxStart (void);
+  void NotifyRxEnd (void);
+  void EraseEvents (void);
+
+  /**
+   * \returns the number of signals kept.
+   */
+  uint32_t GetNEvents (void) const;
+
+private:
+  struct Slot
+  {
+    Time end;
+    double cumPowerW; // power of this slot and of all those before
+    Ptr<Event> event;
+  };
+
+  /**
+   * Moves the signals that are over out of the total power and drops those
+   * that are not needed for the reception in progress.
+   */
+  void Prune (void);
+  /**
+   * \returns the total power of the slots before i.
+   */
+  double GetPowerBefore (uint32_t i) const;
+  double CalculateNoiseFloorW (WifiMode mode) const;
+  double CalculateChunkSuccessRate (double sinr, Time duration, WifiMode mode) const;
+
+  std::deque<Slot> m_slots;
+  uint32_t m_firstActive;  // first slot not over
+  double m_prunedPowerW;   // running total of the slots dropped
+  bool m_rxing;
+  Time m_rxStart;
+  double m_noiseFigure;
+  Ptr<ErrorRateModel> m_errorRateModel;
+};
+
+} // namespace ns3
+
+#endif /* OVNIS_INTERFERENCE_TRACKER_H */
@@ -0,0 +1,221 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ *
+ * Copyright (c) 2010-2011 University of Luxembourg
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * @file ovnis-link-wifi-phy.cc
+ */
+
+#include <algorithm>
+#include "ovnis-link-wifi-phy.h"
+#include "wifi/model/wifi-phy-state-helper.h"
+#include "ns3/error-rate-model.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include "log.h"
+
+NS_LOG_COMPONENT_DEFINE ("OvnisLinkWifiPhy");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (OvnisLinkWifiPhy);
+
+TypeId
+OvnisLinkWifiPhy::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::OvnisLinkWifiPhy")
+    .SetParent<OvnisWifiPhy> ()
+    .AddConstructor<OvnisLinkWifiPhy> ()
+    ;
+  return tid;
+}
+
+OvnisLinkWifiPhy::OvnisLinkWifiPhy ()
+  : m_rxSignalW (0),
+    m_rxInterferenceW (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+OvnisLinkWifiPhy::~OvnisLinkWifiPhy ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+OvnisLinkWifiPhy::ResetMedium (void)
+{
+  m_signals.clear ();
+}
+
+double
+OvnisLinkWifiPhy::GetMediumPowerW (void)
+{
+  Time now = Simulator::Now ();
+  double powerW = 0;
+  std::vector<Signal>::iterator it = m_signals.begin ();
+  while (it != m_signals.end ())
+    {
+      if (it->end <= now)
+        {
+          *it = m_signals.back ();
+          m_signals.pop_back ();
+        }
+      else
+        {
+          powerW += it->powerW;
+          ++it;
+        }
+    }
+  return powerW;
+}
+
+Time
+OvnisLinkWifiPhy::GetDelayUntilBelow (double thresholdW) const
+{
+  Time now = Simulator::Now ();
+  std::vector<std::pair<Time, double> > ends;
+  double powerW = 0;
+  for (std::vector<Signal>::const_iterator it = m_signals.begin (); it != m_signals.end (); ++it)
+    {
+      if (it->end > now)
+        {
+          ends.push_back (std::make_pair (it->end, it->powerW));
+          powerW += it->powerW;
+        }
+    }
+  if (powerW <= thresholdW)
+    {
+      return Seconds (0);
+    }
+  std::sort (ends.begin (), ends.end ());
+  for (std::vector<std::pair<Time, double> >::const_iterator it = ends.begin (); it != ends.end (); ++it)
+    {
+      powerW -= it->second;
+      if (powerW <= thresholdW)
+        {
+          return it->first - now;
+        }
+    }
+  return ends.back ().first - now;
+}
+
+double
+OvnisLinkWifiPhy::GetNoisePowerW (WifiMode mode) const
+{
+  // thermal noise at 290K in J/s = W, as in InterferenceHelper
+  static const double BOLTZMANN = 1.3803e-23;
+  double nbw = BOLTZMANN * 290.0 * mode.GetBandwidth ();
+  return DbToRatio (GetRxNoiseFigure ()) * nbw;
+}
+
+void
+OvnisLinkWifiPhy::StartReceivePacket (Ptr<Packet> packet,
+                                      double rxPowerDbm,
+                                      WifiTxVector txVector,
+                                      enum WifiPreamble preamble,
+                                      Time rxDuration,
+                                      const OvnisRxContext &sender)
+{
+  NS_LOG_FUNCTION (this << packet << rxPowerDbm << txVector.GetMode () << preamble);
+  rxPowerDbm += m_rxGainDb;
+  double rxPowerW = DbmToW (rxPowerDbm);
+  Time endRx = Simulator::Now () + rxDuration;
+
+  double mediumW = GetMediumPowerW ();
+  Signal signal;
+  signal.end = endRx;
+  signal.powerW = rxPowerW;
+  m_signals.push_back (signal);
+
+  switch (m_state->GetState ())
+    {
+    case OvnisWifiPhy::SWITCHING:
+      NS_LOG_DEBUG ("drop packet because of channel switching");
+      NotifyRxDrop (packet);
+      ovnis::Log::getInstance ().packetDropped (OvnisWifiPhy::SWITCHING);
+      break;
+    case OvnisWifiPhy::RX:
+      NS_LOG_DEBUG ("drop packet because already in Rx (power=" << rxPowerW << "W)");
+      NotifyRxDrop (packet);
+      ovnis::Log::getInstance ().packetDropped (OvnisWifiPhy::RX);
+      // everything but the frame being received interferes with it
+      m_rxInterferenceW = std::max (m_rxInterferenceW, mediumW + rxPowerW - m_rxSignalW);
+      break;
+    case OvnisWifiPhy::TX:
+      NS_LOG_DEBUG ("drop packet because already in Tx (power=" << rxPowerW << "W)");
+      NotifyRxDrop (packet);
+      ovnis::Log::getInstance ().packetDropped (OvnisWifiPhy::TX);
+      break;
+    case OvnisWifiPhy::CCA_BUSY:
+    case OvnisWifiPhy::IDLE:
+      if (rxPowerW > m_edThresholdW)
+        {
+          m_rxContext = sender;
+          m_rxContext.rxPowerDbm = rxPowerDbm;
+
+          NS_LOG_DEBUG ("sync to signal (power=" << rxPowerW << "W)");
+          m_rxSignalW = rxPowerW;
+          m_rxInterferenceW = mediumW;
+          m_state->SwitchToRx (rxDuration);
+          NS_ASSERT (m_endRxEvent.IsExpired ());
+          NotifyRxBegin (packet);
+          m_endRxEvent = Simulator::Schedule (rxDuration, &OvnisLinkWifiPhy::EndLinkReceive, this,
+                                              packet, txVector.GetMode (), preamble);
+          return;
+        }
+      NS_LOG_DEBUG ("drop packet because signal power too Small (" <<
+                    rxPowerW << "<" << m_edThresholdW << ")");
+      NotifyRxDrop (packet);
+      break;
+    }
+
+  // CCA becomes busy when the aggregation of all signals on the medium
+  // is higher than the CcaBusyThreshold
+  if (m_state->GetDelayUntilIdle () < rxDuration)
+    {
+      Time delayUntilCcaEnd = GetDelayUntilBelow (m_ccaMode1ThresholdW);
+      if (!delayUntilCcaEnd.IsZero ())
+        {
+          m_state->SwitchMaybeToCcaBusy (delayUntilCcaEnd);
+        }
+    }
+}
+
+void
+OvnisLinkWifiPhy::EndLinkReceive (Ptr<Packet> packet, WifiMode mode, WifiPreamble preamble)
+{
+  NS_LOG_FUNCTION (this << packet << mode);
+  NS_ASSERT (IsStateRx ());
+
+  double snr = m_rxSignalW / (GetNoisePowerW (mode) + m_rxInterferenceW);
+  double per = 1 - GetErrorRateModel ()->GetChunkSuccessRate (mode, snr, packet->GetSize () * 8);
+
+  NS_LOG_DEBUG ("mode=" << mode.GetDataRate () << ", snr=" << snr << ", per=" << per << ", size=" << packet->GetSize ());
+  if (m_random->GetValue () > per)
+    {
+      NotifyRxEnd (packet);
+      m_rxContext.snr = snr;
+      m_state->SwitchFromRxEndOk (packet, snr, mode, preamble);
+    }
+  else
+    {
+      NotifyRxDrop (packet);
+      m_state->SwitchFromRxEndError (packet, snr);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,94 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ *
+ * Copyright (c) 2010-2011 University of Luxembourg
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * @file ovnis-link-wifi-phy.h
+ */
+
+#ifndef OVNIS_LINK_WIFI_PHY_H
+#define OVNIS_LINK_WIFI_PHY_H
+
+#include <vector>
+#include "ns3/nstime.h"
+#include "ovnis-wifi-phy.h"
+
+namespace ns3 {
+
+/**
+ * \brief Link level version of the ns3::OvnisWifiPhy.
+ *
+ * Reception is decided once per frame instead of once per interference chunk.
+ * The phy keeps the list of signals currently on the medium and, for the frame
+ * it is synchronized on, the highest interference power seen during the reception.
+ * At the end of the frame the packet error rate is read from the error rate model
+ * for that worst SINR and the whole frame size. The OvnisInterferenceTracker of
+ * the parent class is not used.
+ *
+ * CCA busy is derived from the same list of signals. States, traces, channel
+ * switching and transmission are those of ns3::OvnisWifiPhy, so the phy can
+ * replace it in OvnisWifiPhyHelper (see OvnisWifiPhyHelper::SetPhyType) without
+ * changes to the MAC or the applications.
+ *
+ * Combined with the lookup tables of ns3::OvnisErrorRateModel this is meant for
+ * large scale studies where symbol accuracy is not needed.
+ */
+class OvnisLinkWifiPhy : public OvnisWifiPhy
+{
+public:
+  static TypeId GetTypeId (void);
+
+  OvnisLinkWifiPhy ();
+  virtual ~OvnisLinkWifiPhy ();
+
+  using OvnisWifiPhy::StartReceivePacket;
+  virtual void StartReceivePacket (Ptr<Packet> packet,
+                                   double rxPowerDbm,
+                                   WifiTxVector txVector,
+                                   WifiPreamble preamble,
+                                   Time rxDuration,
+                                   const OvnisRxContext &sender);
+
+protected:
+  virtual void ResetMedium (void);
+
+private:
+  struct Signal
+  {
+    Time end;
+    double powerW;
+  };
+
+  /**
+   * Removes the signals that are over.
+   * \returns the total power of the signals still on the medium.
+   */
+  double GetMediumPowerW (void);
+  /**
+   * \returns the delay until the power on the medium drops under thresholdW.
+   */
+  Time GetDelayUntilBelow (double thresholdW) const;
+  double GetNoisePowerW (WifiMode mode) const;
+  void EndLinkReceive (Ptr<Packet> packet, WifiMode mode, WifiPreamble preamble);
+
+  std::vector<Signal> m_signals;
+  double m_rxSignalW;       // power of the frame being received
+  double m_rxInterferenceW; // highest interference power seen during its reception
+};
+
+} // namespace ns3
+
+#endif /* OVNIS_LINK_WIFI_PHY_H */
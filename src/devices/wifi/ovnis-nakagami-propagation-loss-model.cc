@@ -0,0 +1,237 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ *
+ * Copyright (c) 2010-2011 University of Luxembourg
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * @file ovnis-nakagami-propagation-loss-model.cc
+ */
+
+#include <cmath>
+#include <algorithm>
+#include "ovnis-nakagami-propagation-loss-model.h"
+#include "ns3/mobility-model.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/log.h"
+
+NS_LOG_COMPONENT_DEFINE ("OvnisNakagamiPropagationLossModel");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (OvnisNakagamiPropagationLossModel);
+
+// smallest linear gain stored in the pools, avoids -inf dB for a null variate
+static const double MIN_GAIN = 1e-30;
+
+TypeId
+OvnisNakagamiPropagationLossModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::OvnisNakagamiPropagationLossModel")
+    .SetParent<PropagationLossModel> ()
+    .AddConstructor<OvnisNakagamiPropagationLossModel> ()
+    .AddAttribute ("Distance1",
+                   "Beginning of the second distance field. Default is 80m.",
+                   DoubleValue (80.0),
+                   MakeDoubleAccessor (&OvnisNakagamiPropagationLossModel::m_distance1),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("Distance2",
+                   "Beginning of the third distance field. Default is 200m.",
+                   DoubleValue (200.0),
+                   MakeDoubleAccessor (&OvnisNakagamiPropagationLossModel::m_distance2),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("m0",
+                   "m0 for distances smaller than Distance1. Default is 1.5.",
+                   DoubleValue (1.5),
+                   MakeDoubleAccessor (&OvnisNakagamiPropagationLossModel::m_m0),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("m1",
+                   "m1 for distances smaller than Distance2. Default is 0.75.",
+                   DoubleValue (0.75),
+                   MakeDoubleAccessor (&OvnisNakagamiPropagationLossModel::m_m1),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("m2",
+                   "m2 for distances greater than Distance2. Default is 0.75.",
+                   DoubleValue (0.75),
+                   MakeDoubleAccessor (&OvnisNakagamiPropagationLossModel::m_m2),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("PoolSize",
+                   "Number of variates generated at once for each distance field.",
+                   UintegerValue (4096),
+                   MakeUintegerAccessor (&OvnisNakagamiPropagationLossModel::m_poolSize),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+OvnisNakagamiPropagationLossModel::OvnisNakagamiPropagationLossModel ()
+  : m_hasSpareNormal (false),
+    m_spareNormal (0)
+{
+  m_uniform = CreateObject<UniformRandomVariable> ();
+  for (int i = 0; i < 3; i++)
+    {
+      m_pools[i].m = 0;
+      m_pools[i].next = 0;
+    }
+}
+
+OvnisNakagamiPropagationLossModel::~OvnisNakagamiPropagationLossModel ()
+{
+}
+
+double
+OvnisNakagamiPropagationLossModel::DoCalcRxPower (double txPowerDbm,
+                                                  Ptr<MobilityModel> a,
+                                                  Ptr<MobilityModel> b) const
+{
+  double distance = a->GetDistanceFrom (b);
+  NS_ASSERT (distance >= 0);
+
+  int field;
+  double m;
+  if (distance < m_distance1)
+    {
+      field = 0;
+      m = m_m0;
+    }
+  else if (distance < m_distance2)
+    {
+      field = 1;
+      m = m_m1;
+    }
+  else
+    {
+      field = 2;
+      m = m_m2;
+    }
+
+  Pool &pool = m_pools[field];
+  if (pool.m != m || pool.next >= pool.gainsDb.size ())
+    {
+      pool.m = m;
+      Refill (pool);
+    }
+  return txPowerDbm + pool.gainsDb[pool.next++];
+}
+
+void
+OvnisNakagamiPropagationLossModel::Refill (Pool &pool) const
+{
+  NS_LOG_FUNCTION (this << pool.m);
+  pool.gainsDb.resize (m_poolSize);
+  pool.next = 0;
+  uint32_t intM = (uint32_t) std::floor (pool.m);
+  if (intM > 0 && intM == pool.m)
+    {
+      RefillInteger (pool, intM);
+    }
+  else
+    {
+      RefillGamma (pool, pool.m);
+    }
+}
+
+void
+OvnisNakagamiPropagationLossModel::RefillInteger (Pool &pool, uint32_t m) const
+{
+  // Erlang(m, 1/m): -ln(u1 * ... * um) / m. The uniforms are drawn first so that
+  // the transformation is a plain loop over a buffer.
+  uint32_t size = pool.gainsDb.size ();
+  std::vector<double> uniforms (size * m);
+  for (uint32_t i = 0; i < uniforms.size (); i++)
+    {
+      uniforms[i] = 1.0 - m_uniform->GetValue (); // in (0,1]
+    }
+  for (uint32_t i = 0; i < size; i++)
+    {
+      double product = 1.0;
+      for (uint32_t k = 0; k < m; k++)
+        {
+          product *= uniforms[i * m + k];
+        }
+      double gain = -std::log (product) / m;
+      pool.gainsDb[i] = 10.0 * std::log10 (std::max (gain, MIN_GAIN));
+    }
+}
+
+void
+OvnisNakagamiPropagationLossModel::RefillGamma (Pool &pool, double m) const
+{
+  // Marsaglia and Tsang, "A simple method for generating gamma variables", 2000.
+  // For m < 1, Gamma(m) = Gamma(m + 1) * U^(1/m).
+  double shape = m < 1 ? m + 1 : m;
+  double d = shape - 1.0 / 3.0;
+  double c = 1.0 / std::sqrt (9.0 * d);
+  uint32_t size = pool.gainsDb.size ();
+  for (uint32_t i = 0; i < size; i++)
+    {
+      double v;
+      while (true)
+        {
+          double x = GetNormal ();
+          v = 1.0 + c * x;
+          if (v <= 0)
+            {
+              continue;
+            }
+          v = v * v * v;
+          double u = 1.0 - m_uniform->GetValue ();
+          if (std::log (u) < 0.5 * x * x + d - d * v + d * std::log (v))
+            {
+              break;
+            }
+        }
+      double gamma = d * v;
+      if (m < 1)
+        {
+          gamma *= std::pow (1.0 - m_uniform->GetValue (), 1.0 / m);
+        }
+      pool.gainsDb[i] = 10.0 * std::log10 (std::max (gamma / m, MIN_GAIN));
+    }
+}
+
+double
+OvnisNakagamiPropagationLossModel::GetNormal (void) const
+{
+  if (m_hasSpareNormal)
+    {
+      m_hasSpareNormal = false;
+      return m_spareNormal;
+    }
+  double u1 = 1.0 - m_uniform->GetValue ();
+  double u2 = m_uniform->GetValue ();
+  double r = std::sqrt (-2.0 * std::log (u1));
+  double theta = 2.0 * M_PI * u2;
+  m_spareNormal = r * std::sin (theta);
+  m_hasSpareNormal = true;
+  return r * std::cos (theta);
+}
+
+int64_t
+OvnisNakagamiPropagationLossModel::DoAssignStreams (int64_t stream)
+{
+  m_uniform->SetStream (stream);
+  // variates already pooled come from the previous stream
+  for (int i = 0; i < 3; i++)
+    {
+      m_pools[i].gainsDb.clear ();
+      m_pools[i].next = 0;
+    }
+  m_hasSpareNormal = false;
+  return 1;
+}
+
+} // namespace ns3
@@ -0,0 +1,96 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ *
+ * Copyright (c) 2010-2011 University of Luxembourg
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * @file ovnis-nakagami-propagation-loss-model.h
+ */
+
+#ifndef OVNIS_NAKAGAMI_PROPAGATION_LOSS_MODEL_H
+#define OVNIS_NAKAGAMI_PROPAGATION_LOSS_MODEL_H
+
+#include <vector>
+#include <stdint.h>
+#include "ns3/propagation-loss-model.h"
+#include "ns3/random-variable-stream.h"
+
+namespace ns3 {
+
+/**
+ * \brief Nakagami-m fast fading drawn from pools of pre-generated variates.
+ *
+ * Same distribution and attributes as ns3::NakagamiPropagationLossModel: the
+ * received power is Gamma(m, P/m) distributed, m being chosen among m0, m1 and m2
+ * according to the distance. Since Gamma(m, P/m) = P * Gamma(m, 1/m), the model
+ * only needs unit mean variates, that are generated in blocks of PoolSize for each
+ * of the three distance ranges and stored directly as a gain in dB. A call to
+ * CalcRxPower is then one addition and the pool is refilled when exhausted.
+ *
+ * Refills use the sum of m exponential variates for an integer m (m uniforms and
+ * one logarithm per variate) and the Marsaglia-Tsang method otherwise.
+ *
+ * To be added to the OvnisWifiChannel with
+ * OvnisWifiChannelHelper::AddPropagationLoss ("ns3::OvnisNakagamiPropagationLossModel").
+ */
+class OvnisNakagamiPropagationLossModel : public PropagationLossModel
+{
+public:
+  static TypeId GetTypeId (void);
+
+  OvnisNakagamiPropagationLossModel ();
+  virtual ~OvnisNakagamiPropagationLossModel ();
+
+private:
+  OvnisNakagamiPropagationLossModel (const OvnisNakagamiPropagationLossModel &o);
+  OvnisNakagamiPropagationLossModel & operator = (const OvnisNakagamiPropagationLossModel &o);
+
+  virtual double DoCalcRxPower (double txPowerDbm,
+                                Ptr<MobilityModel> a,
+                                Ptr<MobilityModel> b) const;
+  virtual int64_t DoAssignStreams (int64_t stream);
+
+  struct Pool
+  {
+    double m;
+    std::vector<double> gainsDb;
+    uint32_t next;
+  };
+
+  /**
+   * Fills the pool with unit mean Gamma(m, 1/m) variates expressed in dB.
+   */
+  void Refill (Pool &pool) const;
+  void RefillInteger (Pool &pool, uint32_t m) const;
+  void RefillGamma (Pool &pool, double m) const;
+  double GetNormal (void) const;
+
+  double m_distance1;
+  double m_distance2;
+  double m_m0;
+  double m_m1;
+  double m_m2;
+  uint32_t m_poolSize;
+
+  mutable Pool m_pools[3];
+  Ptr<UniformRandomVariable> m_uniform;
+  // Box-Muller gives normals by pairs
+  mutable bool m_hasSpareNormal;
+  mutable double m_spareNormal;
+};
+
+} // namespace ns3
+
+#endif /* OVNIS_NAKAGAMI_PROPAGATION_LOSS_MODEL_H */
@@ -0,0 +1,268 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ *
+ * Copyright (c) 2010-2011 University of Luxembourg
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * @file ovnis-neighbor-table.cc
+ */
+
+#include "ovnis-neighbor-table.h"
+#include "beaconing-adhoc-wifi-mac.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+
+NS_LOG_COMPONENT_DEFINE ("OvnisNeighborTable");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (OvnisNeighborTable);
+
+TypeId
+OvnisNeighborTable::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::OvnisNeighborTable")
+    .SetParent<Object> ()
+    .AddConstructor<OvnisNeighborTable> ()
+    .AddAttribute ("Timeout",
+                   "Time after which Purge removes a neighbor only heard by the applications.",
+                   TimeValue (Seconds (4)),
+                   MakeTimeAccessor (&OvnisNeighborTable::m_timeout),
+                   MakeTimeChecker ())
+  ;
+  return tid;
+}
+
+OvnisNeighborTable::OvnisNeighborTable ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+OvnisNeighborTable::~OvnisNeighborTable ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+Ptr<OvnisNeighborTable>
+OvnisNeighborTable::Install (Ptr<Node> node)
+{
+  Ptr<OvnisNeighborTable> table = node->GetObject<OvnisNeighborTable> ();
+  if (table == 0)
+    {
+      table = CreateObject<OvnisNeighborTable> ();
+      node->AggregateObject (table);
+      BeaconingAdhocWifiMac::ConnectNeighborTraces (node,
+                                                    MakeCallback (&OvnisNeighborTable::NewNeighbor, table),
+                                                    MakeCallback (&OvnisNeighborTable::NeighborLost, table));
+    }
+  return table;
+}
+
+void
+OvnisNeighborTable::NewNeighbor (Ptr<const Packet> packet, Mac48Address address, double rxPowerDbm)
+{
+  NotifyHeard (address, rxPowerDbm);
+}
+
+void
+OvnisNeighborTable::NeighborLost (Ptr<const Packet> packet, Mac48Address address)
+{
+  NotifyLost (address);
+}
+
+void
+OvnisNeighborTable::NotifyHeard (Mac48Address address, double rxPowerDbm)
+{
+  std::map<Mac48Address, uint32_t>::iterator a = m_byAddress.find (address);
+  uint32_t index = a == m_byAddress.end () ? Add () : a->second;
+  SetAddress (index, address);
+  m_entries[index].lastHeard = Simulator::Now ();
+  m_entries[index].rxPowerDbm = rxPowerDbm;
+}
+
+void
+OvnisNeighborTable::NotifyLost (Mac48Address address)
+{
+  std::map<Mac48Address, uint32_t>::iterator a = m_byAddress.find (address);
+  if (a != m_byAddress.end ())
+    {
+      Remove (a->second);
+    }
+}
+
+void
+OvnisNeighborTable::UpdateVehicle (ovnis::StringId vehicleId, Vector position, double speed)
+{
+  std::map<ovnis::StringId, uint32_t>::iterator v = m_byVehicle.find (vehicleId);
+  uint32_t index = v == m_byVehicle.end () ? Add () : v->second;
+  SetVehicleId (index, vehicleId);
+  Entry &entry = m_entries[index];
+  entry.lastHeard = Simulator::Now ();
+  entry.position = position;
+  entry.speed = speed;
+}
+
+void
+OvnisNeighborTable::UpdateVehicle (Mac48Address address, ovnis::StringId vehicleId, Vector position, double speed)
+{
+  std::map<Mac48Address, uint32_t>::iterator a = m_byAddress.find (address);
+  std::map<ovnis::StringId, uint32_t>::iterator v = m_byVehicle.find (vehicleId);
+  uint32_t index;
+  if (a != m_byAddress.end ())
+    {
+      index = a->second;
+      if (v != m_byVehicle.end () && v->second != index)
+        {
+          // heard by the MAC and by an application before the two were related
+          uint32_t removed = v->second;
+          uint32_t last = m_entries.size () - 1;
+          Remove (removed);
+          if (index == last)
+            {
+              index = removed;
+            }
+        }
+    }
+  else
+    {
+      index = v == m_byVehicle.end () ? Add () : v->second;
+    }
+  SetAddress (index, address);
+  SetVehicleId (index, vehicleId);
+  Entry &entry = m_entries[index];
+  entry.lastHeard = Simulator::Now ();
+  entry.position = position;
+  entry.speed = speed;
+}
+
+void
+OvnisNeighborTable::Purge (void)
+{
+  Time oldest = Simulator::Now () - m_timeout;
+  for (uint32_t i = m_entries.size (); i > 0; i--)
+    {
+      const Entry &entry = m_entries[i - 1];
+      if (entry.address == Mac48Address () && entry.lastHeard < oldest)
+        {
+          Remove (i - 1);
+        }
+    }
+}
+
+uint32_t
+OvnisNeighborTable::GetNNeighbors (void) const
+{
+  return m_entries.size ();
+}
+
+OvnisNeighborTable::Iterator
+OvnisNeighborTable::Begin (void) const
+{
+  return m_entries.begin ();
+}
+
+OvnisNeighborTable::Iterator
+OvnisNeighborTable::End (void) const
+{
+  return m_entries.end ();
+}
+
+const OvnisNeighborTable::Entry *
+OvnisNeighborTable::Find (Mac48Address address) const
+{
+  std::map<Mac48Address, uint32_t>::const_iterator a = m_byAddress.find (address);
+  return a == m_byAddress.end () ? 0 : &m_entries[a->second];
+}
+
+const OvnisNeighborTable::Entry *
+OvnisNeighborTable::Find (ovnis::StringId vehicleId) const
+{
+  std::map<ovnis::StringId, uint32_t>::const_iterator v = m_byVehicle.find (vehicleId);
+  return v == m_byVehicle.end () ? 0 : &m_entries[v->second];
+}
+
+uint32_t
+OvnisNeighborTable::Add (void)
+{
+  Entry entry;
+  entry.vehicleId = ovnis::NO_STRING_ID;
+  entry.rxPowerDbm = 0;
+  entry.speed = 0;
+  m_entries.push_back (entry);
+  return m_entries.size () - 1;
+}
+
+void
+OvnisNeighborTable::Remove (uint32_t index)
+{
+  NS_ASSERT (index < m_entries.size ());
+  Entry &entry = m_entries[index];
+  if (entry.address != Mac48Address ())
+    {
+      m_byAddress.erase (entry.address);
+    }
+  if (entry.vehicleId != ovnis::NO_STRING_ID)
+    {
+      m_byVehicle.erase (entry.vehicleId);
+    }
+  uint32_t last = m_entries.size () - 1;
+  if (index != last)
+    {
+      entry = m_entries[last];
+      if (entry.address != Mac48Address ())
+        {
+          m_byAddress[entry.address] = index;
+        }
+      if (entry.vehicleId != ovnis::NO_STRING_ID)
+        {
+          m_byVehicle[entry.vehicleId] = index;
+        }
+    }
+  m_entries.pop_back ();
+}
+
+void
+OvnisNeighborTable::SetAddress (uint32_t index, Mac48Address address)
+{
+  Entry &entry = m_entries[index];
+  if (entry.address == address)
+    {
+      return;
+    }
+  if (entry.address != Mac48Address ())
+    {
+      m_byAddress.erase (entry.address);
+    }
+  entry.address = address;
+  m_byAddress[address] = index;
+}
+
+void
+OvnisNeighborTable::SetVehicleId (uint32_t index, ovnis::StringId vehicleId)
+{
+  Entry &entry = m_entries[index];
+  if (entry.vehicleId == vehicleId)
+    {
+      return;
+    }
+  if (entry.vehicleId != ovnis::NO_STRING_ID)
+    {
+      m_byVehicle.erase (entry.vehicleId);
+    }
+  entry.vehicleId = vehicleId;
+  m_byVehicle[vehicleId] = index;
+}
+
+} // namespace ns3
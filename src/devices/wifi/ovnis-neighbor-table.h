@@ -0,0 +1,129 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ *
+ * Copyright (c) 2010-2011 University of Luxembourg
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * @file ovnis-neighbor-table.h
+ */
+
+#ifndef OVNIS_NEIGHBOR_TABLE_H
+#define OVNIS_NEIGHBOR_TABLE_H
+
+#include <map>
+#include <vector>
+#include <stdint.h>
+#include "ns3/object.h"
+#include "ns3/node.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+#include "ns3/packet.h"
+#include "ns3/mac48-address.h"
+#include "stringInterner.h"
+
+namespace ns3 {
+
+/**
+ * \brief The neighbors of a node, shared by its MAC and its applications.
+ *
+ * The entries are indexed by MAC address and by the handle of the vehicle id
+ * (see ovnis::StringInterner). A neighbor is known by its MAC address when it
+ * is heard by the ns3::BeaconingAdhocWifiMac of the node, by its vehicle when
+ * an application receives one of its packets, and by both once a beacon
+ * payload has given the two. The MAC adds and removes neighbors through its
+ * NewNeighbor and NeighborLost trace sources; the applications complete the
+ * entries with the position and speed of the vehicles. Neighbors only known by
+ * their vehicle are removed by Purge when not heard for Timeout.
+ *
+ * Entries are kept contiguous and are read in place through Begin and End, an
+ * iterator being invalidated by the next change of the table.
+ */
+class OvnisNeighborTable : public Object
+{
+public:
+  struct Entry
+  {
+    Mac48Address address;  // 00:00:00:00:00:00 until heard by the MAC
+    ovnis::StringId vehicleId; // NO_STRING_ID until heard by an application
+    Time lastHeard;
+    double rxPowerDbm;
+    Vector position;
+    double speed;
+  };
+  typedef std::vector<Entry>::const_iterator Iterator;
+
+  static TypeId GetTypeId (void);
+
+  OvnisNeighborTable ();
+  virtual ~OvnisNeighborTable ();
+
+  /**
+   * \param node a node with one or several ns3::BeaconingAdhocWifiMac.
+   * \returns the table of the node, created, aggregated to the node and connected
+   * to its MACs at the first call.
+   */
+  static Ptr<OvnisNeighborTable> Install (Ptr<Node> node);
+
+  /**
+   * A beacon of address has been received with rxPowerDbm.
+   */
+  void NotifyHeard (Mac48Address address, double rxPowerDbm);
+  /**
+   * The MAC has not heard address for BeaconLost beacon intervals.
+   */
+  void NotifyLost (Mac48Address address);
+  /**
+   * An application has received the state of a vehicle.
+   */
+  void UpdateVehicle (ovnis::StringId vehicleId, Vector position, double speed);
+  /**
+   * An application has received the state of a vehicle with the address it was sent from.
+   */
+  void UpdateVehicle (Mac48Address address, ovnis::StringId vehicleId, Vector position, double speed);
+  /**
+   * Removes the neighbors not heard by the MAC and not heard for Timeout.
+   */
+  void Purge (void);
+
+  uint32_t GetNNeighbors (void) const;
+  Iterator Begin (void) const;
+  Iterator End (void) const;
+  /**
+   * \returns the entry of the neighbor, or 0 if unknown.
+   */
+  const Entry * Find (Mac48Address address) const;
+  const Entry * Find (ovnis::StringId vehicleId) const;
+
+private:
+  void NewNeighbor (Ptr<const Packet> packet, Mac48Address address, double rxPowerDbm);
+  void NeighborLost (Ptr<const Packet> packet, Mac48Address address);
+
+  uint32_t Add (void);
+  /**
+   * Moves the last entry to index, so the other indices do not change.
+   */
+  void Remove (uint32_t index);
+  void SetAddress (uint32_t index, Mac48Address address);
+  void SetVehicleId (uint32_t index, ovnis::StringId vehicleId);
+
+  Time m_timeout;
+  std::vector<Entry> m_entries;
+  std::map<Mac48Address, uint32_t> m_byAddress;
+  std::map<ovnis::StringId, uint32_t> m_byVehicle;
+};
+
+} // namespace ns3
+
+#endif /* OVNIS_NEIGHBOR_TABLE_H */
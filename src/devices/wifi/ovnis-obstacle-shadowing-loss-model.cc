@@ -0,0 +1,569 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ *
+ * Copyright (c) 2010-2011 University of Luxembourg
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * @file ovnis-obstacle-shadowing-loss-model.cc
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <xercesc/sax2/SAX2XMLReader.hpp>
+#include <xercesc/sax2/DefaultHandler.hpp>
+#include <xercesc/sax2/XMLReaderFactory.hpp>
+#include <xercesc/sax2/Attributes.hpp>
+#include <xercesc/sax/SAXParseException.hpp>
+#include <xercesc/util/XMLString.hpp>
+#include "ovnis-obstacle-shadowing-loss-model.h"
+#include "ns3/mobility-model.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/log.h"
+
+NS_LOG_COMPONENT_DEFINE ("OvnisObstacleShadowingLossModel");
+
+using namespace xercesc;
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (OvnisObstacleShadowingLossModel);
+
+// cached results kept for one pair of cells
+static const uint32_t CACHE_ENTRIES_PER_PAIR = 8;
+
+namespace {
+
+/**
+ * Reads the "poly" elements of a SUMO shapes file.
+ */
+class ShapesHandler : public DefaultHandler
+{
+public:
+  ShapesHandler (OvnisObstacleShadowingLossModel *model, std::string type)
+    : m_model (model),
+      m_type (type),
+      m_nObstacles (0)
+  {
+  }
+
+  virtual void startElement (const XMLCh* const uri, const XMLCh* const localname,
+                             const XMLCh* const qname, const Attributes& attrs)
+  {
+    char* name = XMLString::transcode (localname);
+    if (std::string ("poly") == name)
+      {
+        std::string type = GetAttribute (attrs, "type");
+        if (type.compare (0, m_type.size (), m_type) == 0)
+          {
+            std::vector<Vector> polygon;
+            std::istringstream shape (GetAttribute (attrs, "shape"));
+            std::string point;
+            while (shape >> point)
+              {
+                double x, y;
+                if (std::sscanf (point.c_str (), "%lf,%lf", &x, &y) == 2)
+                  {
+                    polygon.push_back (Vector (x, y, 0));
+                  }
+              }
+            if (polygon.size () > 2)
+              {
+                m_model->AddObstacle (polygon);
+                m_nObstacles++;
+              }
+          }
+      }
+    XMLString::release (&name);
+  }
+
+  virtual void fatalError (const SAXParseException& exception)
+  {
+    char* message = XMLString::transcode (exception.getMessage ());
+    std::cerr << "Fatal Error: " << message << " at line: " << exception.getLineNumber () << std::endl;
+    XMLString::release (&message);
+  }
+
+  uint32_t GetNObstacles (void) const
+  {
+    return m_nObstacles;
+  }
+
+private:
+  static std::string GetAttribute (const Attributes& attrs, const char *name)
+  {
+    XMLCh* q = XMLString::transcode (name);
+    const XMLCh* v = attrs.getValue (q);
+    std::string value;
+    if (v != 0)
+      {
+        char* b = XMLString::transcode (v);
+        value = b;
+        XMLString::release (&b);
+      }
+    XMLString::release (&q);
+    return value;
+  }
+
+  OvnisObstacleShadowingLossModel *m_model;
+  std::string m_type;
+  uint32_t m_nObstacles;
+};
+
+bool
+IsStill (Ptr<MobilityModel> m)
+{
+  Vector v = m->GetVelocity ();
+  return v.x == 0 && v.y == 0 && v.z == 0;
+}
+
+bool
+SamePosition (const Vector &a, const Vector &b)
+{
+  return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+} // anonymous namespace
+
+TypeId
+OvnisObstacleShadowingLossModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::OvnisObstacleShadowingLossModel")
+    .SetParent<PropagationLossModel> ()
+    .AddConstructor<OvnisObstacleShadowingLossModel> ()
+    .AddAttribute ("ShapesFile",
+                   "SUMO shapes file the obstacles are read from, at the first call.",
+                   StringValue (""),
+                   MakeStringAccessor (&OvnisObstacleShadowingLossModel::m_shapesFile),
+                   MakeStringChecker ())
+    .AddAttribute ("ObstacleType",
+                   "Only the polygons whose type starts with this string are obstacles.",
+                   StringValue ("building"),
+                   MakeStringAccessor (&OvnisObstacleShadowingLossModel::m_obstacleType),
+                   MakeStringChecker ())
+    .AddAttribute ("WallLoss",
+                   "Attenuation (dB) for each wall on the line of sight.",
+                   DoubleValue (9.0),
+                   MakeDoubleAccessor (&OvnisObstacleShadowingLossModel::m_wallLossDb),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("InternalLoss",
+                   "Attenuation (dB/m) inside the obstacles.",
+                   DoubleValue (0.4),
+                   MakeDoubleAccessor (&OvnisObstacleShadowingLossModel::m_internalLossDbPerMeter),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("GridResolution",
+                   "Side (m) of the cells of the grid indexing the walls.",
+                   DoubleValue (50.0),
+                   MakeDoubleAccessor (&OvnisObstacleShadowingLossModel::m_gridResolution),
+                   MakeDoubleChecker<double> (1.0))
+    .AddAttribute ("CacheSize",
+                   "Number of cell pairs for which results between still endpoints are kept.",
+                   UintegerValue (100000),
+                   MakeUintegerAccessor (&OvnisObstacleShadowingLossModel::m_cacheSize),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+OvnisObstacleShadowingLossModel::OvnisObstacleShadowingLossModel ()
+  : m_loaded (false),
+    m_nObstacles (0),
+    m_indexed (false),
+    m_minX (0),
+    m_minY (0),
+    m_maxX (0),
+    m_maxY (0),
+    m_nx (0),
+    m_ny (0),
+    m_stamp (0),
+    m_cacheHits (0)
+{
+}
+
+OvnisObstacleShadowingLossModel::~OvnisObstacleShadowingLossModel ()
+{
+}
+
+uint32_t
+OvnisObstacleShadowingLossModel::LoadShapes (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  try
+    {
+      XMLPlatformUtils::Initialize ();
+    }
+  catch (const XMLException& toCatch)
+    {
+      char* message = XMLString::transcode (toCatch.getMessage ());
+      std::cerr << "Error during initialization! :\n" << message << "\n";
+      XMLString::release (&message);
+      return 0;
+    }
+
+  SAX2XMLReader* parser = XMLReaderFactory::createXMLReader ();
+  parser->setFeature (XMLUni::fgSAX2CoreValidation, false);
+  ShapesHandler handler (this, m_obstacleType);
+  parser->setContentHandler (&handler);
+  parser->setErrorHandler (&handler);
+  try
+    {
+      parser->parse (filename.c_str ());
+    }
+  catch (const XMLException& toCatch)
+    {
+      char* message = XMLString::transcode (toCatch.getMessage ());
+      std::cerr << "Exception message is: \n" << message << "\n";
+      XMLString::release (&message);
+    }
+  catch (const SAXParseException& toCatch)
+    {
+      char* message = XMLString::transcode (toCatch.getMessage ());
+      std::cerr << "Exception message is: \n" << message << "\n";
+      XMLString::release (&message);
+    }
+  delete parser;
+  NS_LOG_INFO (handler.GetNObstacles () << " obstacles read from " << filename);
+  return handler.GetNObstacles ();
+}
+
+void
+OvnisObstacleShadowingLossModel::AddObstacle (const std::vector<Vector> &polygon)
+{
+  NS_ASSERT (polygon.size () > 2);
+  uint32_t n = polygon.size ();
+  if (SamePosition (polygon.front (), polygon.back ()))
+    {
+      n--;
+    }
+  for (uint32_t i = 0; i < n; i++)
+    {
+      const Vector &p = polygon[i];
+      const Vector &q = polygon[(i + 1) % n];
+      Wall wall;
+      wall.x0 = p.x;
+      wall.y0 = p.y;
+      wall.x1 = q.x;
+      wall.y1 = q.y;
+      wall.obstacle = m_nObstacles;
+      m_walls.push_back (wall);
+    }
+  m_nObstacles++;
+  m_indexed = false;
+  m_cache.clear ();
+}
+
+uint32_t
+OvnisObstacleShadowingLossModel::GetNObstacles (void) const
+{
+  return m_nObstacles;
+}
+
+uint64_t
+OvnisObstacleShadowingLossModel::GetNCacheHits (void) const
+{
+  return m_cacheHits;
+}
+
+void
+OvnisObstacleShadowingLossModel::BuildIndex (void) const
+{
+  NS_LOG_FUNCTION (this << m_walls.size ());
+  m_indexed = true;
+  m_cellStart.clear ();
+  m_cellWalls.clear ();
+  m_wallStamp.assign (m_walls.size (), 0);
+  m_stamp = 0;
+  if (m_walls.empty ())
+    {
+      m_nx = m_ny = 0;
+      return;
+    }
+
+  m_minX = m_maxX = m_walls[0].x0;
+  m_minY = m_maxY = m_walls[0].y0;
+  for (std::vector<Wall>::const_iterator w = m_walls.begin (); w != m_walls.end (); ++w)
+    {
+      m_minX = std::min (m_minX, std::min (w->x0, w->x1));
+      m_maxX = std::max (m_maxX, std::max (w->x0, w->x1));
+      m_minY = std::min (m_minY, std::min (w->y0, w->y1));
+      m_maxY = std::max (m_maxY, std::max (w->y0, w->y1));
+    }
+  m_nx = (uint32_t) std::floor ((m_maxX - m_minX) / m_gridResolution) + 1;
+  m_ny = (uint32_t) std::floor ((m_maxY - m_minY) / m_gridResolution) + 1;
+
+  // two passes over the walls: count per cell, then fill
+  m_cellStart.assign (m_nx * m_ny + 1, 0);
+  for (int pass = 0; pass < 2; pass++)
+    {
+      std::vector<uint32_t> fill;
+      if (pass == 1)
+        {
+          for (uint32_t c = 1; c < m_cellStart.size (); c++)
+            {
+              m_cellStart[c] += m_cellStart[c - 1];
+            }
+          m_cellWalls.resize (m_cellStart.back ());
+          fill.assign (m_cellStart.begin (), m_cellStart.end () - 1);
+        }
+      for (uint32_t k = 0; k < m_walls.size (); k++)
+        {
+          const Wall &w = m_walls[k];
+          uint32_t i0 = (uint32_t) ((std::min (w.x0, w.x1) - m_minX) / m_gridResolution);
+          uint32_t i1 = (uint32_t) ((std::max (w.x0, w.x1) - m_minX) / m_gridResolution);
+          uint32_t j0 = (uint32_t) ((std::min (w.y0, w.y1) - m_minY) / m_gridResolution);
+          uint32_t j1 = (uint32_t) ((std::max (w.y0, w.y1) - m_minY) / m_gridResolution);
+          for (uint32_t i = i0; i <= i1; i++)
+            {
+              for (uint32_t j = j0; j <= j1; j++)
+                {
+                  uint32_t c = i * m_ny + j;
+                  if (pass == 0)
+                    {
+                      m_cellStart[c + 1]++;
+                    }
+                  else
+                    {
+                      m_cellWalls[fill[c]++] = k;
+                    }
+                }
+            }
+        }
+    }
+}
+
+int64_t
+OvnisObstacleShadowingLossModel::GetCell (double x, double y) const
+{
+  if (x < m_minX || y < m_minY || x > m_maxX || y > m_maxY)
+    {
+      return -1;
+    }
+  uint32_t i = (uint32_t) ((x - m_minX) / m_gridResolution);
+  uint32_t j = (uint32_t) ((y - m_minY) / m_gridResolution);
+  return i * m_ny + j;
+}
+
+double
+OvnisObstacleShadowingLossModel::GetObstacleLoss (Vector a, Vector b) const
+{
+  if (!m_indexed)
+    {
+      BuildIndex ();
+    }
+  if (m_walls.empty ())
+    {
+      return 0;
+    }
+
+  double dx = b.x - a.x;
+  double dy = b.y - a.y;
+
+  // clip the line of sight to the bounding box of the walls (Liang-Barsky)
+  double tEnter = 0;
+  double tExit = 1;
+  double p[4] = { -dx, dx, -dy, dy };
+  double q[4] = { a.x - m_minX, m_maxX - a.x, a.y - m_minY, m_maxY - a.y };
+  for (int k = 0; k < 4; k++)
+    {
+      if (p[k] == 0)
+        {
+          if (q[k] < 0)
+            {
+              return 0;
+            }
+        }
+      else
+        {
+          double t = q[k] / p[k];
+          if (p[k] < 0)
+            {
+              tEnter = std::max (tEnter, t);
+            }
+          else
+            {
+              tExit = std::min (tExit, t);
+            }
+        }
+    }
+  if (tEnter > tExit)
+    {
+      return 0;
+    }
+
+  if (++m_stamp == 0)
+    {
+      std::fill (m_wallStamp.begin (), m_wallStamp.end (), 0);
+      m_stamp = 1;
+    }
+
+  // walk the cells crossed by the clipped segment (Amanatides and Woo)
+  double inf = std::numeric_limits<double>::infinity ();
+  double ex = a.x + tEnter * dx - m_minX;
+  double ey = a.y + tEnter * dy - m_minY;
+  int i = std::min ((int) (ex / m_gridResolution), (int) m_nx - 1);
+  int j = std::min ((int) (ey / m_gridResolution), (int) m_ny - 1);
+  int stepI = dx > 0 ? 1 : -1;
+  int stepJ = dy > 0 ? 1 : -1;
+  double tMaxI = dx == 0 ? inf : ((i + (stepI > 0)) * m_gridResolution + m_minX - a.x) / dx;
+  double tMaxJ = dy == 0 ? inf : ((j + (stepJ > 0)) * m_gridResolution + m_minY - a.y) / dy;
+  double tDeltaI = dx == 0 ? inf : m_gridResolution / std::fabs (dx);
+  double tDeltaJ = dy == 0 ? inf : m_gridResolution / std::fabs (dy);
+
+  // (obstacle, position on the line of sight) of every wall crossed
+  std::vector<std::pair<uint32_t, double> > hits;
+  while (i >= 0 && j >= 0 && i < (int) m_nx && j < (int) m_ny)
+    {
+      uint32_t c = i * m_ny + j;
+      for (uint32_t k = m_cellStart[c]; k < m_cellStart[c + 1]; k++)
+        {
+          uint32_t wallIndex = m_cellWalls[k];
+          if (m_wallStamp[wallIndex] == m_stamp)
+            {
+              continue;
+            }
+          m_wallStamp[wallIndex] = m_stamp;
+          const Wall &w = m_walls[wallIndex];
+          double sx = w.x1 - w.x0;
+          double sy = w.y1 - w.y0;
+          double denom = dx * sy - dy * sx;
+          if (denom == 0)
+            {
+              continue;
+            }
+          double qx = w.x0 - a.x;
+          double qy = w.y0 - a.y;
+          double t = (qx * sy - qy * sx) / denom;
+          double u = (qx * dy - qy * dx) / denom;
+          // u < 1: a corner belongs to one wall only
+          if (t >= 0 && t <= 1 && u >= 0 && u < 1)
+            {
+              hits.push_back (std::make_pair (w.obstacle, t));
+            }
+        }
+      if (tMaxI < tMaxJ)
+        {
+          if (tMaxI > tExit)
+            {
+              break;
+            }
+          i += stepI;
+          tMaxI += tDeltaI;
+        }
+      else
+        {
+          if (tMaxJ > tExit)
+            {
+              break;
+            }
+          j += stepJ;
+          tMaxJ += tDeltaJ;
+        }
+    }
+  if (hits.empty ())
+    {
+      return 0;
+    }
+
+  // inside length: between the first and second crossing of an obstacle, the
+  // third and fourth, ... An unpaired crossing (endpoint inside) only counts as a wall.
+  std::sort (hits.begin (), hits.end ());
+  double inside = 0;
+  for (uint32_t k = 0; k + 1 < hits.size (); k++)
+    {
+      if (hits[k].first == hits[k + 1].first)
+        {
+          inside += hits[k + 1].second - hits[k].second;
+          k++;
+        }
+    }
+  inside *= std::sqrt (dx * dx + dy * dy);
+  return hits.size () * m_wallLossDb + inside * m_internalLossDbPerMeter;
+}
+
+double
+OvnisObstacleShadowingLossModel::DoCalcRxPower (double txPowerDbm,
+                                                Ptr<MobilityModel> a,
+                                                Ptr<MobilityModel> b) const
+{
+  if (!m_loaded)
+    {
+      m_loaded = true;
+      if (!m_shapesFile.empty ())
+        {
+          // the obstacles are part of the configuration, not of the state of the model
+          const_cast<OvnisObstacleShadowingLossModel *> (this)->LoadShapes (m_shapesFile);
+        }
+    }
+
+  Vector pa = a->GetPosition ();
+  Vector pb = b->GetPosition ();
+  if (!IsStill (a) || !IsStill (b))
+    {
+      return txPowerDbm - GetObstacleLoss (pa, pb);
+    }
+
+  if (!m_indexed)
+    {
+      BuildIndex ();
+    }
+  int64_t ca = GetCell (pa.x, pa.y);
+  int64_t cb = GetCell (pb.x, pb.y);
+  if (ca < 0 || cb < 0)
+    {
+      return txPowerDbm - GetObstacleLoss (pa, pb);
+    }
+  // the loss is symmetric, one entry for both directions
+  if (ca > cb || (ca == cb && (pa.x > pb.x || (pa.x == pb.x && pa.y > pb.y))))
+    {
+      std::swap (ca, cb);
+      std::swap (pa, pb);
+    }
+  std::vector<CacheEntry> &entries = m_cache[((uint64_t) ca << 32) | (uint64_t) cb];
+  for (std::vector<CacheEntry>::const_iterator it = entries.begin (); it != entries.end (); ++it)
+    {
+      if (SamePosition (it->a, pa) && SamePosition (it->b, pb))
+        {
+          m_cacheHits++;
+          return txPowerDbm - it->lossDb;
+        }
+    }
+  CacheEntry entry;
+  entry.a = pa;
+  entry.b = pb;
+  entry.lossDb = GetObstacleLoss (pa, pb);
+  if (entries.size () >= CACHE_ENTRIES_PER_PAIR)
+    {
+      entries.erase (entries.begin ());
+    }
+  entries.push_back (entry);
+  if (m_cache.size () > m_cacheSize)
+    {
+      m_cache.clear ();
+    }
+  return txPowerDbm - entry.lossDb;
+}
+
+int64_t
+OvnisObstacleShadowingLossModel::DoAssignStreams (int64_t stream)
+{
+  return 0;
+}
+
+} // namespace ns3
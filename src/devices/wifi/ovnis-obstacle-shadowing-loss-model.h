@@ -0,0 +1,137 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ *
+ * Copyright (c) 2010-2011 University of Luxembourg
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * @file ovnis-obstacle-shadowing-loss-model.h
+ */
+
+#ifndef OVNIS_OBSTACLE_SHADOWING_LOSS_MODEL_H
+#define OVNIS_OBSTACLE_SHADOWING_LOSS_MODEL_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "ns3/propagation-loss-model.h"
+#include "ns3/vector.h"
+
+namespace ns3 {
+
+/**
+ * \brief Attenuation by the buildings on the line of sight.
+ *
+ * Empirical model of Sommer et al., "A Computationally Inexpensive Empirical Model
+ * of IEEE 802.11p Radio Shadowing in Urban Environments" (WONS 2011): every wall
+ * crossed by the line of sight costs WallLoss dB and every meter inside a building
+ * InternalLoss dB. Meant to be chained after the distance and fading models of the
+ * channel.
+ *
+ * Obstacles are the polygons of a SUMO shapes file (eg. Kirchberg.shapes.xml) whose
+ * type starts with ObstacleType, loaded once at the first call. Their walls are
+ * indexed in a uniform grid of GridResolution meters; a lookup walks the grid cells
+ * crossed by the line of sight and only tests the walls registered there, so the
+ * model can be called for every receiver of OvnisWifiChannel::Send.
+ *
+ * When both endpoints do not move (null velocity: parked or stopped vehicles) the
+ * result is kept in a cache indexed by the pair of grid cells of the endpoints.
+ */
+class OvnisObstacleShadowingLossModel : public PropagationLossModel
+{
+public:
+  static TypeId GetTypeId (void);
+
+  OvnisObstacleShadowingLossModel ();
+  virtual ~OvnisObstacleShadowingLossModel ();
+
+  /**
+   * \param filename a SUMO shapes file.
+   * \returns the number of obstacles read from the file.
+   */
+  uint32_t LoadShapes (std::string filename);
+  /**
+   * \param polygon the corners of the obstacle, the polygon being closed if needed.
+   */
+  void AddObstacle (const std::vector<Vector> &polygon);
+  uint32_t GetNObstacles (void) const;
+
+  /**
+   * \returns the attenuation (dB) due to the obstacles between a and b.
+   */
+  double GetObstacleLoss (Vector a, Vector b) const;
+
+  uint64_t GetNCacheHits (void) const;
+
+private:
+  OvnisObstacleShadowingLossModel (const OvnisObstacleShadowingLossModel &o);
+  OvnisObstacleShadowingLossModel & operator = (const OvnisObstacleShadowingLossModel &o);
+
+  virtual double DoCalcRxPower (double txPowerDbm,
+                                Ptr<MobilityModel> a,
+                                Ptr<MobilityModel> b) const;
+  virtual int64_t DoAssignStreams (int64_t stream);
+
+  struct Wall
+  {
+    double x0, y0, x1, y1;
+    uint32_t obstacle;
+  };
+
+  struct CacheEntry
+  {
+    Vector a;
+    Vector b;
+    double lossDb;
+  };
+
+  /**
+   * Lays the walls out in the grid. Walls of each cell are stored contiguously:
+   * those of cell c are m_cellWalls[m_cellStart[c]] to m_cellWalls[m_cellStart[c + 1] - 1].
+   */
+  void BuildIndex (void) const;
+  /**
+   * \returns the index of the grid cell of (x, y), or -1 if out of the grid.
+   */
+  int64_t GetCell (double x, double y) const;
+
+  std::string m_shapesFile;
+  std::string m_obstacleType;
+  double m_wallLossDb;
+  double m_internalLossDbPerMeter;
+  double m_gridResolution;
+  uint32_t m_cacheSize;
+
+  mutable bool m_loaded;
+  uint32_t m_nObstacles;
+  std::vector<Wall> m_walls;
+
+  mutable bool m_indexed;
+  mutable double m_minX, m_minY, m_maxX, m_maxY;
+  mutable uint32_t m_nx, m_ny;
+  mutable std::vector<uint32_t> m_cellStart;
+  mutable std::vector<uint32_t> m_cellWalls;
+  // last lookup that tested each wall, a wall spanning several cells is tested once
+  mutable std::vector<uint32_t> m_wallStamp;
+  mutable uint32_t m_stamp;
+
+  typedef std::map<uint64_t, std::vector<CacheEntry> > Cache;
+  mutable Cache m_cache;
+  mutable uint64_t m_cacheHits;
+};
+
+} // namespace ns3
+
+#endif /* OVNIS_OBSTACLE_SHADOWING_LOSS_MODEL_H */
@@ -0,0 +1,56 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ *
+ * Copyright (c) 2010-2011 University of Luxembourg
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * @file ovnis-rx-context.h
+ */
+
+#ifndef OVNIS_RX_CONTEXT_H
+#define OVNIS_RX_CONTEXT_H
+
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+
+namespace ns3 {
+
+/**
+ * \brief What the phy knows about the frame it is receiving.
+ *
+ * The sender position and the tx time are filled by the ns3::OvnisWifiChannel
+ * for each transmission, the rx power and the SNR by the ns3::OvnisWifiPhy that
+ * synchronizes on the frame. The phy keeps the context of its current frame and
+ * hands it out by reference (OvnisWifiPhy::GetRxContext) while the frame is
+ * forwarded up, so nothing is attached to the packet.
+ */
+struct OvnisRxContext
+{
+  OvnisRxContext ()
+    : rxPowerDbm (0),
+      snr (0),
+      txTime (Seconds (0))
+  {
+  }
+
+  double rxPowerDbm;
+  double snr; // linear ratio, known at the end of the reception
+  Vector senderPosition;
+  Time txTime;
+};
+
+} // namespace ns3
+
+#endif /* OVNIS_RX_CONTEXT_H */
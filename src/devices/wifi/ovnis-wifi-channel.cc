@@ -33,6 +33,7 @@
 #include "ns3/node.h"
 #include "ns3/log.h"
 #include "ns3/pointer.h"
+#include "ns3/double.h"
 #include "ns3/object-factory.h"
 #include "ovnis-wifi-channel.h"
 #include "ovnis-wifi-phy.h"
@@ -58,11 +59,15 @@ namespace ns3
                 PointerValue(), MakePointerAccessor(&OvnisWifiChannel::m_loss),
                 MakePointerChecker<PropagationLossModel> ()) .AddAttribute("PropagationDelayModel",
                 "A pointer to the propagation delay model attached to this channel.", PointerValue(),
-                MakePointerAccessor(&OvnisWifiChannel::m_delay), MakePointerChecker<PropagationDelayModel> ());
+                MakePointerAccessor(&OvnisWifiChannel::m_delay), MakePointerChecker<PropagationDelayModel> ()) .AddAttribute(
+                "InterferenceCutoff", "Received power (dBm) under which a transmission is neither delivered "
+                "nor accounted as interference by the receiving phy.", DoubleValue(-110.0),
+                MakeDoubleAccessor(&OvnisWifiChannel::m_interferenceCutoffDbm), MakeDoubleChecker<double> ());
     return tid;
   }
 
-  OvnisWifiChannel::OvnisWifiChannel()
+  OvnisWifiChannel::OvnisWifiChannel() :
+    m_interferenceCutoffDbm(-110.0), m_nScheduled(0), m_nCulled(0)
   {
     NS_LOG_FUNCTION_NOARGS();
     area_x = 1;
@@ -93,11 +98,26 @@ namespace ns3
   OvnisWifiChannel::Send (Ptr<OvnisWifiPhy> sender, Ptr<const Packet> packet, double txPowerDbm,
                          WifiTxVector txVector, WifiPreamble preamble) const
   {
+    Send(sender, packet, txPowerDbm, txVector, preamble,
+        sender->GetCachedTxDuration(packet->GetSize(), txVector, preamble));
+  }
+
+  void
+  OvnisWifiChannel::Send (Ptr<OvnisWifiPhy> sender, Ptr<const Packet> packet, double txPowerDbm,
+                         WifiTxVector txVector, WifiPreamble preamble, Time txDuration) const
+  {
+    Transmission transmission;
+    transmission.txVector = txVector;
+    transmission.preamble = preamble;
+    transmission.duration = txDuration;
     Ptr<MobilityModel> senderMobility = sender->GetMobility ()->GetObject<MobilityModel> ();
     NS_ASSERT (senderMobility != 0);
+    transmission.sender.senderPosition = senderMobility->GetPosition ();
+    transmission.sender.txTime = Simulator::Now ();
 //    uint32_t j = 0;
     Ptr<ChannelCell> senderCell = sender->cell;//GetObject<ChannelCell> ();
         NS_ASSERT (senderCell != 0);
+        uint16_t channelNumber = sender->GetChannelNumber();
         int nbcells=0;
         int i, j;
         for (i = (senderCell->i - 1) > 0 ? (senderCell->i - 1) : 0; i
@@ -109,17 +129,27 @@ namespace ns3
             Ptr<ChannelCell> thatCell = cells[i][j];
             nbcells++;
 
-            for (vector<Ptr<OvnisWifiPhy> >::iterator it = thatCell->content.begin(); it != thatCell->content.end(); it++)
+            // For now don't account for inter channel interference: only
+            // the phys tuned to the sender's channel are visited.
+            const ChannelCell::PhyList * phys = thatCell->GetPhys(channelNumber);
+            if (phys == 0)
+              continue;
+
+            for (ChannelCell::PhyList::const_iterator it = phys->begin(); it != phys->end(); it++)
             {
               if (sender != (*it))
               {
-                // For now don't account for inter channel interference
-                if ((*it)->GetChannelNumber() != sender->GetChannelNumber())
-                  continue;
-
                 Ptr<MobilityModel> receiverMobility = (*it)->GetMobility()->GetObject<MobilityModel> ();
                 Time delay = m_delay->GetDelay(senderMobility, receiverMobility);
                 double rxPowerDbm = m_loss->CalcRxPower(txPowerDbm, senderMobility, receiverMobility);
+                // Far below the noise floor the signal has no effect on the receiver but
+                // would still be iterated over by its OvnisInterferenceTracker.
+                if (rxPowerDbm + (*it)->GetRxGain() < m_interferenceCutoffDbm)
+                {
+                  m_nCulled++;
+                  continue;
+                }
+                m_nScheduled++;
                 //if (senderMobility->GetDistanceFrom (receiverMobility)>1400)
                 //{
                 NS_LOG_DEBUG ("propagation: txPower="<<txPowerDbm<<"dbm, rxPower="<<rxPowerDbm<<"dbm, "<<
@@ -137,7 +167,7 @@ namespace ns3
                   dstNode = dstNetDevice->GetObject<NetDevice> ()->GetNode()->GetId();
                 }
                 Simulator::ScheduleWithContext(dstNode, delay,
-                		&OvnisWifiChannel::Receive, this, (*it), copy, rxPowerDbm, txVector, preamble);
+                		&OvnisWifiChannel::Receive, this, (*it), copy, rxPowerDbm, transmission);
     //            Simulator::ScheduleWithContext (dstNode,
     //                                                        delay, &YansWifiChannel::Receive, this,
     //                                                        j, copy, rxPowerDbm, txVector, preamble);
@@ -213,10 +243,11 @@ namespace ns3
 //  }
   void
   OvnisWifiChannel::Receive (Ptr<OvnisWifiPhy> i, Ptr<Packet> packet, double rxPowerDbm,
-                            WifiTxVector txVector, WifiPreamble preamble) const
+                            Transmission transmission) const
   {
 //    m_phyList[i]->StartReceivePacket (packet, rxPowerDbm, txVector, preamble);
-	  i->StartReceivePacket (packet, rxPowerDbm, txVector, preamble);
+	  i->StartReceivePacket (packet, rxPowerDbm, transmission.txVector, transmission.preamble, transmission.duration,
+	                         transmission.sender);
   }
 
   void
@@ -232,7 +263,7 @@ namespace ns3
       if (mob == 0)
       {
         // no position
-        cells[0][0]->content.push_back(phy);
+        cells[0][0]->Add(phy);
         phy->AggregateObject(cells[0][0]);
 
       }
@@ -241,7 +272,7 @@ namespace ns3
         Vector v = mob->GetPosition();
         int nx = (int) (v.x / range);
         int ny = (int) (v.y / range);
-        cells[nx][ny]->content.push_back(phy);
+        cells[nx][ny]->Add(phy);
         //phy->AggregateObject(cells[nx][ny]);
         phy->cell = cells[nx][ny];
       }
@@ -253,14 +284,8 @@ namespace ns3
         //Ptr<ChannelCell> cell = phy->GetObject<ChannelCell> ();
         if (phy->cell != cells[0][0])
         {
-
-          std::vector<Ptr<OvnisWifiPhy> >::iterator it = std::find(phy->cell->content.begin(), phy->cell->content.end(),
-              phy);
-          if (it != phy->cell->content.end())
-          {
-            phy->cell->content.erase(it);
-          }
-          cells[0][0]->content.push_back(phy);
+          phy->cell->Remove(phy);
+          cells[0][0]->Add(phy);
           //phy->AggregateObject(cells[0][0]);
           phy->cell = cells[0][0];
         }
@@ -274,13 +299,8 @@ namespace ns3
 
         if (phy->cell != cells[nx][ny])
         {
-          std::vector<Ptr<OvnisWifiPhy> >::iterator it = std::find(phy->cell->content.begin(), phy->cell->content.end(),
-              phy);
-          if (it != phy->cell->content.end())
-          {
-            phy->cell->content.erase(it);
-          }
-          cells[nx][ny]->content.push_back(phy);
+          phy->cell->Remove(phy);
+          cells[nx][ny]->Add(phy);
           //phy->AggregateObject(cells[nx][ny]);
           NS_LOG_DEBUG ("phy moving from cell ("<<phy->cell->i<<","<<phy->cell->j<<") to cell ("<<nx<<","<<ny<<")");
           phy->cell = cells[nx][ny];
@@ -340,7 +360,7 @@ OvnisWifiChannel::updateArea(double x, double y, double r)
       jj = cells[ii].size() - j;
       for (int jjj = 0; jjj < jj; jjj++)
       {
-        if (cells[ii].back()->content.size() != 0)
+        if (cells[ii].back()->GetNPhys() != 0)
         {
           NS_LOG_ERROR("Removing Cell "<<cells[ii].back()->i<< " "<<cells[ii].back()->j<<" that is NOT empty !!!!");
         }
@@ -352,7 +372,7 @@ OvnisWifiChannel::updateArea(double x, double y, double r)
     {
       for (vector<Ptr<ChannelCell> >::iterator it = cells[iii].begin(); it != cells[iii].end(); it++)
       {
-        if ((*it)->content.size() != 0)
+        if ((*it)->GetNPhys() != 0)
         {
           NS_LOG_ERROR("Removing Cell "<<(*it)->i<< " "<<(*it)->j<<" that is NOT empty !!!!");
         }
@@ -363,6 +383,28 @@ OvnisWifiChannel::updateArea(double x, double y, double r)
 
   }
 
+  void
+  OvnisWifiChannel::UpdateChannelNumber(Ptr<OvnisWifiPhy> phy, uint16_t previous)
+  {
+    NS_LOG_FUNCTION_NOARGS();
+    if (phy->cell != 0)
+    {
+      phy->cell->UpdateChannelNumber(phy, previous);
+    }
+  }
+
+  uint64_t
+  OvnisWifiChannel::GetNScheduledReceptions(void) const
+  {
+    return m_nScheduled;
+  }
+
+  uint64_t
+  OvnisWifiChannel::GetNCulledReceptions(void) const
+  {
+    return m_nCulled;
+  }
+
   uint32_t
   OvnisWifiChannel::GetNDevices(void) const
   {
@@ -393,9 +435,7 @@ OvnisWifiChannel::updateArea(double x, double y, double r)
     }
     else
     {
-      vector<Ptr<OvnisWifiPhy> >::iterator i = std::find(phy->cell->content.begin(), phy->cell->content.end(), phy);
-      if (i != phy->cell->content.end())
-        phy->cell->content.erase(i);
+      phy->cell->Remove(phy);
     }
     PhyList::iterator i = std::find(m_phyList.begin(), m_phyList.end(), phy);
     if (i != m_phyList.end())
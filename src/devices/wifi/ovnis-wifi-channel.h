@@ -118,15 +118,53 @@ public:
   void
   updatePhy(Ptr<OvnisWifiPhy> );
 
+  /**
+   * \param phy a phy of this channel that has just been tuned to another channel number.
+   * \param previous the channel number the phy was tuned to before.
+   *
+   * Cells keep their phys partitioned by channel number so that Send only walks
+   * the phys tuned to the sender's channel. Called by OvnisWifiPhy::SetChannelNumber.
+   */
+  void UpdateChannelNumber (Ptr<OvnisWifiPhy> phy, uint16_t previous);
+
+  /**
+   * \returns the number of receptions scheduled by Send since the creation of the channel.
+   */
+  uint64_t GetNScheduledReceptions (void) const;
+  /**
+   * \returns the number of receptions dropped by Send because the received power
+   * was below the InterferenceCutoff attribute.
+   */
+  uint64_t GetNCulledReceptions (void) const;
+
+
 
 
 
+    /**
+     * \param txDuration duration of the transmission, as computed by the sender.
+     *
+     * Same as above, without computing the duration of the frame again for every receiver.
+     */
+    void Send (Ptr<OvnisWifiPhy> sender, Ptr<const Packet> packet, double txPowerDbm,
+               WifiTxVector txVector, WifiPreamble preamble, Time txDuration) const;
 
 protected:
   typedef std::vector<Ptr<OvnisWifiPhy> > PhyList;
 
+  /**
+   * What the receivers of one transmission share, computed once by Send.
+   */
+  struct Transmission
+  {
+    WifiTxVector txVector;
+    WifiPreamble preamble;
+    Time duration;
+    OvnisRxContext sender; // sender position and tx time
+  };
+
   void Receive (Ptr<OvnisWifiPhy>  i, Ptr<Packet> packet, double rxPowerDbm,
-                WifiTxVector txVector, WifiPreamble preamble) const;
+                Transmission transmission) const;
  double area_x;
   double area_y;
   double range;
@@ -139,6 +177,14 @@ protected:
   PhyList m_phyList;
   Ptr<PropagationLossModel> m_loss;
   Ptr<PropagationDelayModel> m_delay;
+
+  /**
+   * Signals received below this power (dBm) are neither scheduled nor
+   * added to the interference list of the receiver.
+   */
+  double m_interferenceCutoffDbm;
+  mutable uint64_t m_nScheduled;
+  mutable uint64_t m_nCulled;
 };
 
 } // namespace ns3
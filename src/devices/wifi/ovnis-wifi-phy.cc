@@ -38,7 +38,7 @@
 #include "ns3/net-device.h"
 #include "ns3/trace-source-accessor.h"
 #include <math.h>
-#include "common/myEnergy-tag.h"
+#include <algorithm>
 #include "common/myTxEnergy-tag.h"
 #include "ns3/wifi-mac-header.h"
 #include "log.h"
@@ -338,7 +338,12 @@ OvnisWifiPhy::SetChannelNumber (uint16_t nch)
     {
       // this is not channel switch, this is initialization 
       NS_LOG_DEBUG("start at channel " << nch);
+      uint16_t previous = m_channelNumber;
       m_channelNumber = nch;
+      if (m_channel != 0)
+        {
+          m_channel->UpdateChannelNumber (this, previous);
+        }
       return;
     }
 
@@ -368,7 +373,7 @@ OvnisWifiPhy::SetChannelNumber (uint16_t nch)
 
   NS_LOG_DEBUG("switching channel " << m_channelNumber << " -> " << nch);
   m_state->SwitchToChannelSwitching(m_channelSwitchDelay); 
-  m_interference.EraseEvents(); 
+  ResetMedium (); 
   /*
    * Needed here to be able to correctly sensed the medium for the first
    * time after the switching. The actual switching is not performed until
@@ -376,7 +381,12 @@ OvnisWifiPhy::SetChannelNumber (uint16_t nch)
    * state are added to the event list and are employed later to figure
    * out the state of the medium after the switching.
    */
+  uint16_t previous = m_channelNumber;
   m_channelNumber = nch;
+  if (m_channel != 0)
+    {
+      m_channel->UpdateChannelNumber (this, previous);
+    }
 }
 
 uint16_t 
@@ -385,6 +395,12 @@ OvnisWifiPhy::GetChannelNumber() const
   return m_channelNumber;
 }
 
+void
+OvnisWifiPhy::ResetMedium (void)
+{
+  m_interference.EraseEvents ();
+}
+
 double
 OvnisWifiPhy::GetChannelFrequencyMhz() const
 {
@@ -401,21 +417,56 @@ OvnisWifiPhy::SetReceiveErrorCallback (RxErrorCallback callback)
 {
   m_state->SetReceiveErrorCallback (callback);
 }
+// at most that many durations are kept, it is only meant for the few frame formats of the applications
+#define TX_DURATION_CACHE_SIZE 64
+
+Time
+OvnisWifiPhy::GetCachedTxDuration (uint32_t size, WifiTxVector txVector, WifiPreamble preamble)
+{
+  uint64_t key = ((uint64_t) size << 32) | ((uint64_t) (txVector.GetMode ().GetUid () & 0xffff) << 16)
+                 | ((uint64_t) (preamble & 0xff) << 8) | (uint64_t) (txVector.GetNss () & 0xff);
+  std::map<uint64_t, Time>::const_iterator it = m_txDurations.find (key);
+  if (it != m_txDurations.end ())
+    {
+      return it->second;
+    }
+  if (m_txDurations.size () >= TX_DURATION_CACHE_SIZE)
+    {
+      m_txDurations.clear ();
+    }
+  Time duration = CalculateTxDuration (size, txVector, preamble);
+  m_txDurations[key] = duration;
+  return duration;
+}
+
+void
+OvnisWifiPhy::StartReceivePacket (Ptr<Packet> packet,
+                                 double rxPowerDbm,
+                                 WifiTxVector txVector,
+                                 enum WifiPreamble preamble)
+{
+  OvnisRxContext sender;
+  sender.txTime = Simulator::Now ();
+  StartReceivePacket (packet, rxPowerDbm, txVector, preamble,
+                      GetCachedTxDuration (packet->GetSize (), txVector, preamble), sender);
+}
+
 void 
 OvnisWifiPhy::StartReceivePacket (Ptr<Packet> packet,
                                  double rxPowerDbm,
 //                                 WifiMode txMode,
                                  WifiTxVector txVector,
-                                 enum WifiPreamble preamble)
+                                 enum WifiPreamble preamble,
+                                 Time rxDuration,
+                                 const OvnisRxContext &sender)
 {
 	 NS_LOG_FUNCTION (this << packet << rxPowerDbm << txVector.GetMode()<< preamble);
 	 rxPowerDbm += m_rxGainDb;
 	 double rxPowerW = DbmToW (rxPowerDbm);
-	 Time rxDuration = CalculateTxDuration (packet->GetSize (), txVector, preamble);
 	 WifiMode txMode=txVector.GetMode();
 	 Time endRx = Simulator::Now () + rxDuration;
 
-	Ptr<InterferenceHelper::Event> event;
+	Ptr<OvnisInterferenceTracker::Event> event;
 	event = m_interference.Add (packet->GetSize (),
 							  txMode,
 							  preamble,
@@ -476,11 +527,9 @@ OvnisWifiPhy::StartReceivePacket (Ptr<Packet> packet,
       {
 
 // Added by Patricia Ruiz to tell the high layers the rx power of the message
-		  double rxPowerdBm = WToDbm(rxPowerW);
-
-		  MyEnergyTag tagEg = MyEnergyTag();
-		  tagEg.SetTagDouble(rxPowerdBm);
-		  packet ->AddPacketTag (tagEg);
+		  // kept by the phy, for the MAC to read while the frame is forwarded up
+		  m_rxContext = sender;
+		  m_rxContext.rxPowerDbm = rxPowerDbm;
 ////
         NS_LOG_DEBUG ("sync to signal (power="<<rxPowerW<<"W)");
         // sync to signal
@@ -508,7 +557,7 @@ OvnisWifiPhy::StartReceivePacket (Ptr<Packet> packet,
   // We are here because we have received the first bit of a packet and we are
   // not going to be able to synchronize on it
   // In this model, CCA becomes busy when the aggregation of all signals as
-  // tracked by the InterferenceHelper class is higher than the CcaBusyThreshold
+  // tracked by the OvnisInterferenceTracker is higher than the CcaBusyThreshold
 
   Time delayUntilCcaEnd = m_interference.GetEnergyDuration (m_ccaMode1ThresholdW);
   if (!delayUntilCcaEnd.IsZero ())
@@ -529,7 +578,7 @@ OvnisWifiPhy::SendPacket (Ptr<const Packet> packet, WifiMode txMode, WifiPreambl
    */
   NS_ASSERT (!m_state->IsStateTx () && !m_state->IsStateSwitching ());
 
-  Time txDuration = CalculateTxDuration (packet->GetSize (), txVector, preamble);
+  Time txDuration = GetCachedTxDuration (packet->GetSize (), txVector, preamble);
   if (m_state->IsStateRx ())
     {
       m_endRxEvent.Cancel ();
@@ -540,7 +589,14 @@ OvnisWifiPhy::SendPacket (Ptr<const Packet> packet, WifiMode txMode, WifiPreambl
   bool isShortPreamble = (WIFI_PREAMBLE_SHORT == preamble);
   NotifyMonitorSniffTx (packet, (uint16_t)GetChannelFrequencyMhz (), GetChannelNumber (), dataRate500KbpsUnits, isShortPreamble, txVector.GetTxPowerLevel());
   m_state->SwitchToTx (txDuration, packet, txVector.GetMode(), preamble,  txVector.GetTxPowerLevel());
-  m_channel->Send (this, packet, GetPowerDbm ( txVector.GetTxPowerLevel()) + m_txGainDb, txVector, preamble);
+  double txPowerDbm = GetPowerDbm (txVector.GetTxPowerLevel ());
+  // power requested by the MAC for this frame (eg. by ns3::OvnisDcc)
+  MyTxEnergyTag txPowerTag;
+  if (packet->PeekPacketTag (txPowerTag))
+    {
+      txPowerDbm = std::min (txPowerTag.GetTagDouble (), GetTxPowerEnd ());
+    }
+  m_channel->Send (this, packet, txPowerDbm + m_txGainDb, txVector, preamble, txDuration);
 }
 
 
@@ -845,13 +901,13 @@ OvnisWifiPhy::GetPowerDbm (uint8_t power) const
 }
 
 void
-OvnisWifiPhy::EndReceive (Ptr<Packet> packet, Ptr<InterferenceHelper::Event> event)
+OvnisWifiPhy::EndReceive (Ptr<Packet> packet, Ptr<OvnisInterferenceTracker::Event> event)
 {
   NS_LOG_FUNCTION (this << packet << event);
   NS_ASSERT (IsStateRx ());
   NS_ASSERT (event->GetEndTime () == Simulator::Now ());
 
-  struct InterferenceHelper::SnrPer snrPer;
+  struct OvnisInterferenceTracker::SnrPer snrPer;
   snrPer = m_interference.CalculateSnrPer (event);
   m_interference.NotifyRxEnd();
 
@@ -866,6 +922,7 @@ OvnisWifiPhy::EndReceive (Ptr<Packet> packet, Ptr<InterferenceHelper::Event> eve
       double noiseDbm = RatioToDb(event->GetRxPowerW() / snrPer.snr) - GetRxNoiseFigure() + 30 ;
       //NotifyPromiscSniffRx (packet, (uint16_t)GetChannelFrequencyMhz (), GetChannelNumber (), dataRate500KbpsUnits, isShortPreamble, signalDbm, noiseDbm);
       NotifyMonitorSniffRx (packet, (uint16_t)GetChannelFrequencyMhz (), GetChannelNumber (), dataRate500KbpsUnits, isShortPreamble, signalDbm, noiseDbm);
+      m_rxContext.snr = snrPer.snr;
       m_state->SwitchFromRxEndOk (packet, snrPer.snr, event->GetPayloadMode (), event->GetPreambleType ());
     } 
   else 
@@ -880,11 +937,17 @@ OvnisWifiPhy::EndReceive (Ptr<Packet> packet, Ptr<InterferenceHelper::Event> eve
 // Added by Patricia Ruiz (eg of received messages)
 void
 OvnisWifiPhy::SetRxPowerDBm (double level){
-	m_rxPowerDbm = level;
+	m_rxContext.rxPowerDbm = level;
 }
 double
 OvnisWifiPhy::GetRxPowerDBm (){
-	return m_rxPowerDbm;
+	return m_rxContext.rxPowerDbm;
+}
+
+const OvnisRxContext &
+OvnisWifiPhy::GetRxContext (void) const
+{
+  return m_rxContext;
 }
 
 //aadded AgataGrzybek (ns3 3.16)
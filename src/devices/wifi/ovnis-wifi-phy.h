@@ -32,6 +32,7 @@
 #define OVNIS_WIFI_PHY_H
 
 #include <stdint.h>
+#include <map>
 #include "ns3/callback.h"
 #include "ns3/event-id.h"
 #include "ns3/packet.h"
@@ -50,9 +51,10 @@
 #include "ns3/wifi-mode.h"
 #include "ns3/wifi-preamble.h"
 #include "ns3/wifi-phy-standard.h"
-#include "ns3/interference-helper.h"
+#include "ovnis-interference-tracker.h"
 
 #include "channel-cell.h"
+#include "ovnis-rx-context.h"
 
 #define HT_PHY 127
 
@@ -114,6 +116,21 @@ public:
                            double rxPowerDbm,
                            WifiTxVector txVector,
                            WifiPreamble preamble);
+  /**
+   * \param rxDuration duration of the frame, computed once by the channel for all the receivers.
+   * \param sender sender position and tx time, also filled once by the channel.
+   */
+  virtual void StartReceivePacket (Ptr<Packet> packet,
+                                   double rxPowerDbm,
+                                   WifiTxVector txVector,
+                                   WifiPreamble preamble,
+                                   Time rxDuration,
+                                   const OvnisRxContext &sender);
+  /**
+   * Same as CalculateTxDuration, memorized for the few (size, mode, preamble)
+   * combinations the applications generate.
+   */
+  Time GetCachedTxDuration (uint32_t size, WifiTxVector txVector, WifiPreamble preamble);
 
   void SetRxNoiseFigure (double noiseFigureDb);
   void SetTxPowerStart (double start);
@@ -137,7 +154,16 @@ public:
   
   // Added by Patricia Ruiz (eg of received messages)
   void SetRxPowerDBm (double level);
+  /**
+   * \returns the power (dBm) of the last frame the phy synchronized on. Valid
+   * while that frame is forwarded up, at the end of its reception.
+   */
   double GetRxPowerDBm ();
+  /**
+   * \returns the context of the last frame the phy synchronized on, complete
+   * while that frame is forwarded up to the MAC and the applications.
+   */
+  const OvnisRxContext & GetRxContext (void) const;
 
 
   virtual double GetTxPowerStart (void) const;
@@ -255,7 +281,13 @@ private:
 
 private:
   OvnisWifiPhy (const OvnisWifiPhy &o);
+
+protected:
   virtual void DoDispose (void);
+  /**
+   * Forgets the signals heard on the previous channel when switching channel.
+   */
+  virtual void ResetMedium (void);
   void Configure80211a (void);
   void Configure80211b (void);
   void Configure80211g (void);
@@ -270,9 +302,8 @@ private:
   double WToDbm (double w) const;
   double RatioToDb (double ratio) const;
   double GetPowerDbm (uint8_t power) const;
-  void EndReceive (Ptr<Packet> packet, Ptr<InterferenceHelper::Event> event);
+  void EndReceive (Ptr<Packet> packet, Ptr<OvnisInterferenceTracker::Event> event);
 
-private:
   double   m_edThresholdW;
   double   m_ccaMode1ThresholdW;
   double   m_txGainDb;
@@ -303,7 +334,7 @@ private:
   Ptr<Object> m_mobility;
 
   // Added by Patricia Ruiz (eg of received messages)
-  double m_rxPowerDbm;
+  OvnisRxContext m_rxContext;
 
   /**
    * This vector holds the set of transmission modes that this
@@ -349,8 +380,9 @@ private:
   /// Standard-dependent center frequency of 0-th channel, MHz 
   double m_channelStartingFrequency;
   Ptr<WifiPhyStateHelper> m_state;
-  InterferenceHelper m_interference;
+  OvnisInterferenceTracker m_interference;
   Time m_channelSwitchDelay;
+  std::map<uint64_t, Time> m_txDurations;
 
 
 };
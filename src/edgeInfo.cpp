@@ -15,13 +15,17 @@ using namespace std;
 using namespace ns3;
 
 EdgeInfo::EdgeInfo() :
-	id(""), laneId(""), length(0), maxSpeed(0) {
+	id(""), laneId(""), length(0), maxSpeed(0), staticCost(0), currentTravelTime(0) {
 	traci = Names::Find<ovnis::SumoTraciConnection>("SumoTraci");
 }
 
 EdgeInfo::EdgeInfo(string edgeId) :
-	id(edgeId) {
+	id(edgeId), laneId(""), length(0), maxSpeed(0), staticCost(0), currentTravelTime(0) {
 	traci = Names::Find<ovnis::SumoTraciConnection>("SumoTraci");
+	if (traci == 0) {
+		// without sumo, the length and the speed are set afterwards
+		return;
+	}
 	string laneId = edgeId + "_0";
 	try {
 		maxSpeed = traci->GetLaneMaxSpeed(laneId);
@@ -64,6 +68,20 @@ double EdgeInfo::getMaxSpeed() {
 	return maxSpeed;
 }
 
+void EdgeInfo::setLaneId(string laneId) {
+	this->laneId = laneId;
+}
+
+void EdgeInfo::setLength(double length) {
+	this->length = length;
+	staticCost = length / (maxSpeed > 0 ? maxSpeed : 25);
+}
+
+void EdgeInfo::setMaxSpeed(double maxSpeed) {
+	this->maxSpeed = maxSpeed;
+	staticCost = length / (maxSpeed > 0 ? maxSpeed : 25);
+}
+
 double EdgeInfo::getStaticCost() {
 	return staticCost;
 }
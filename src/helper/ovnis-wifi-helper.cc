@@ -205,6 +205,12 @@ OvnisWifiPhyHelper::Set (std::string name, const AttributeValue &v)
   m_phy.Set (name, v);
 }
 
+void
+OvnisWifiPhyHelper::SetPhyType (std::string type)
+{
+  m_phy.SetTypeId (type);
+}
+
 void
 OvnisWifiPhyHelper::SetErrorRateModel (std::string name,
                                       std::string n0, const AttributeValue &v0,
@@ -176,6 +176,13 @@ public:
    * Set an attribute of the underlying PHY object.
    */
   void Set (std::string name, const AttributeValue &v);
+  /**
+   * \param type the TypeId name of the PHY objects to create, ns3::OvnisWifiPhy
+   * or a subclass of it such as ns3::OvnisLinkWifiPhy.
+   *
+   * Attributes already set with Set are kept.
+   */
+  void SetPhyType (std::string type);
   /**
    * \param name the name of the error rate model to set.
    * \param n0 the name of the attribute to set
@@ -50,6 +50,7 @@ string Itinerary::printRoute() {
 void Itinerary::addEdge(string edgeId) {
 	lastEdgeId = currentEdge->getId();
 	edgeIds.push_back(edgeId);
+	edgeHandles.push_back(intern(edgeId));
 	edges[edgeId] = Edge(edgeId);
 	edgeInfos.push_back(EdgeInfo(edgeId));
 }
@@ -65,11 +66,13 @@ string Itinerary::printEdges() {
 
 void Itinerary::initializeEdges(vector<string> routeVector) {
 	this->edgeIds.clear();
+	this->edgeHandles.clear();
 	this->edgeInfos = vector<EdgeInfo>();
 	currentEdge = new Edge();
 	for (int i = 0; i < routeVector.size(); ++i) {
 		edges[routeVector[i]] = Edge(routeVector[i]);
 		this->edgeIds.push_back(routeVector[i]);
+		this->edgeHandles.push_back(intern(routeVector[i]));
 		edgeInfos.push_back(EdgeInfo(routeVector[i]));
 	}
 	if (routeVector.size() > 0) {
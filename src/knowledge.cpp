@@ -12,47 +12,90 @@ using namespace std;
 
 namespace ovnis {
 
-Knowledge::Knowledge() {
+namespace {
+
+/**
+ * Shared edges of the routes of a scenario between a start and an end edge, see
+ * Knowledge::analyseCorrelation.
+ */
+struct Correlation {
+	uint32_t indexedRoutes; // rows of the route index when it was computed, NOT_FOUND if not yet
+	map<string,map<string,vector<string> > > correlated;
+
+	Correlation() : indexedRoutes(RouteIndex::NOT_FOUND) {
+	}
+};
+
+typedef pair<pair<StringId,StringId>, vector<StringId> > CorrelationKey; // start and end edge, routes
+
+map<CorrelationKey, Correlation> & getCorrelations() {
+	static map<CorrelationKey, Correlation> correlations; // shared by all the vehicles
+	return correlations;
+}
+
+}
+
+Knowledge::Contribution::Contribution() :
+		recorded(0), length(0), dated(0), date(0), fresh(0), costDelta(0), delayed(0), delay(0), congested(0),
+		congestedLength(0), dense(0), denseLength(0) {
+}
+
+void Knowledge::RouteAggregate::apply(const Contribution & previous, const Contribution & next, uint32_t count) {
+	recorded += next.recorded - previous.recorded;
+	length += next.length - previous.length;
+	dated += next.dated - previous.dated;
+	date += next.date - previous.date;
+	fresh += next.fresh - previous.fresh;
+	costDelta += count * (next.costDelta - previous.costDelta);
+	delayed += next.delayed - previous.delayed;
+	delay += next.delay - previous.delay;
+	congested += next.congested - previous.congested;
+	congestedLength += next.congestedLength - previous.congestedLength;
+	dense += next.dense - previous.dense;
+	denseLength += next.denseLength - previous.denseLength;
+}
+
+Knowledge::Knowledge() : indexedRoutes(0), scheduledExpiry(0) {
 	maxInformationAge = PACKET_TTL;
 	congestionThreshold = CONGESTION_THRESHOLD;
 	densityThreshold = DENSITY_THRESHOLD;
+	travelTimes.share();
 
 	traci = Names::Find<ovnis::SumoTraciConnection>("SumoTraci");
 }
 
 Knowledge::~Knowledge() {
+	expiryEvent.Cancel();
 }
 
-int Knowledge::getNumberOfVehicles(std::string edgeId) {
+int Knowledge::getNumberOfVehicles(const std::string & edgeId) {
 	int vehs = 0;
-	if (numberOfVehicles.find(edgeId) != numberOfVehicles.end()) {
-		vehs = numberOfVehicles[edgeId];
+	map<StringId,int>::iterator it = numberOfVehicles.find(intern(edgeId));
+	if (it != numberOfVehicles.end()) {
+		vehs = it->second;
 	}
 	return vehs;
 }
 
-int Knowledge::addNumberOfVehicles(std::string edgeId) {
-	if (numberOfVehicles.find(edgeId) != numberOfVehicles.end()) {
-		++numberOfVehicles[edgeId];
-	}
-	else {
-		numberOfVehicles[edgeId] = 1;
-	}
-	return numberOfVehicles[edgeId];
+int Knowledge::addNumberOfVehicles(const std::string & edgeId) {
+	return ++numberOfVehicles[intern(edgeId)];
 }
 
-int Knowledge::substractNumberOfVehicles(std::string edgeId) {
-	if (numberOfVehicles.find(edgeId) != numberOfVehicles.end()) {
-		numberOfVehicles[edgeId] = numberOfVehicles[edgeId]==0 ? 0 : --numberOfVehicles[edgeId];
+int Knowledge::substractNumberOfVehicles(const std::string & edgeId) {
+	int & vehs = numberOfVehicles[intern(edgeId)];
+	if (vehs > 0) {
+		--vehs;
 	}
-	return numberOfVehicles[edgeId];
+	return vehs;
 }
 
-bool Knowledge::record(Data data) {
-	// record only information that is fresher than the last heard
-	if (travelTimes.find(data.edgeId) == travelTimes.end() ||
-			(travelTimes.find(data.edgeId) != travelTimes.end() && travelTimes[data.edgeId].getLatestTime() < data.date)) {
-		travelTimes[data.edgeId].add(0, "", data.date, data.travelTime);
+bool Knowledge::record(const Data & data) {
+	// record only information that is fresher than the last heard, as it would be stored
+	const KnowledgeStore & records = travelTimes; // reading does not copy a shared entry
+	const RecordEntry * entry = records.find(data.edgeId);
+	if (entry == 0 || entry->getLatestTime() < RecordEntry::toStoredTime(data.date)) {
+		travelTimes[data.edgeId].add(0, NO_STRING_ID, data.date, data.travelTime);
+		update(data.edgeId);
 		return true;
 	}
 	// ?????
@@ -66,18 +109,186 @@ bool Knowledge::record(Data data) {
 	return false;
 }
 
-void Knowledge::record(vector<Data> data) {
-	for (vector<Data>::iterator it = data.begin(); it != data.end(); ++it) {
+void Knowledge::record(const vector<Data> & data) {
+	for (vector<Data>::const_iterator it = data.begin(); it != data.end(); ++it) {
 		record(*it);
 	}
 }
 
-map<string,RecordEntry> & Knowledge::getRecords()
+const KnowledgeStore & Knowledge::getRecords()
 {
 	return travelTimes;
 }
 
-void Knowledge::analyseLocalDatabase(map<string, Route> routes, string startEdgeId, string endEdgeId, map<string,double> routeTTL, bool usePerfectInformation) {
+void Knowledge::getEdgeWeights(const RoadGraph & graph, vector<double> & weights) const {
+	graph.getStaticCosts(weights);
+	double now = Simulator::Now().GetSeconds();
+	const vector<StringId> & edges = travelTimes.getEdges();
+	for (vector<StringId>::const_iterator it = edges.begin(); it != edges.end(); ++it) {
+		uint32_t edge = graph.getEdge(*it);
+		if (edge == RoadGraph::NOT_FOUND) {
+			continue;
+		}
+		const RecordEntry * entry = travelTimes.find(*it);
+		double packetDate = entry->getLatestTime();
+		double packetAge = packetDate == 0 ? 0 : now - packetDate;
+		if (entry->getLatestValue() > 0 && packetAge < maxInformationAge) {
+			weights[edge] = entry->getLatestValue();
+		}
+	}
+}
+
+Knowledge::Contribution Knowledge::computeContribution(StringId edge, uint32_t column, bool log) const {
+	Contribution contribution;
+	const KnowledgeStore & records = travelTimes; // reading does not copy a shared entry
+	const RecordEntry * entry = records.find(edge);
+	if (entry == 0) {
+		return contribution;
+	}
+	RecordEntry recordEntry = *entry;
+	const string & edgeId = lookup(edge);
+	double travelTime = recordEntry.getLatestValue();
+	double packetDate = recordEntry.getLatestTime();
+	double packetAge = packetDate == 0 ? 0 : Simulator::Now().GetSeconds() - packetDate;
+	double staticCost = TIS::getInstance().getEdgeStaticCost(edge);
+	if (staticCost != 0) {
+		recordEntry.setCapacity(staticCost);
+	}
+	contribution.recorded = 1;
+	contribution.length = TIS::getInstance().getEdgeLength(edge);
+	if (packetDate != 0) {
+		contribution.dated = 1;
+		contribution.date = packetDate;
+	}
+	if (travelTime > 0 && packetAge < maxInformationAge) { // information was recorded about this edge and is fresh enough
+		contribution.fresh = 1;
+		contribution.costDelta = travelTime - TIS::getInstance().getStaticEdgeCosts()[column];
+		if (travelTime != SIMULATION_STEP_INTERVAL || recordEntry.getExpectedValue() > SIMULATION_STEP_INTERVAL) { // sumo bug fix - travelTime > 1 means that it was recorded in sumo!
+			double delay = travelTime - recordEntry.getExpectedValue();
+			if (delay > 0) {
+				contribution.delayed = 1;
+				contribution.delay = delay;
+			}
+			if (log) {
+				Log::getInstance().getStream("delay") << Simulator::Now().GetSeconds() << "\t" << edgeId << "\t" << travelTime << "\t-\t" << recordEntry.getExpectedValue() << "\t=\t" << delay << endl;
+				Log::getInstance().getStream("capacity") << Simulator::Now().GetSeconds() << "\t" << edgeId << "," << recordEntry.getExpectedValue() << "," << travelTime << "," << recordEntry.getActualCapacity() << endl;
+			}
+			if (recordEntry.getActualCapacity() < congestionThreshold) {
+				contribution.congested = 1;
+				contribution.congestedLength = contribution.length;
+				if (log) {
+					Log::getInstance().getStream("congestion") << Simulator::Now().GetSeconds() << "\t" << edgeId << "\t" << recordEntry.getActualCapacity() << "<" << congestionThreshold << "\t" << travelTime << "\t" << recordEntry.getExpectedValue() << endl;
+				}
+			}
+			if (recordEntry.getActualCapacity() > congestionThreshold && recordEntry.getActualCapacity() < densityThreshold) {
+				contribution.dense = 1;
+				contribution.denseLength = contribution.length;
+				if (log) {
+					Log::getInstance().getStream("dense") << Simulator::Now().GetSeconds() << "\t" << edgeId << "\t" << congestionThreshold << "<" << recordEntry.getActualCapacity() << "<" << densityThreshold << "\t" << travelTime << "\t" << recordEntry.getExpectedValue() << endl;
+				}
+			}
+		}
+	}
+	return contribution;
+}
+
+void Knowledge::update(StringId edge) {
+	checkRouteIndex();
+	const RouteIndex & routeIndex = TIS::getInstance().getRouteIndex();
+	uint32_t column = routeIndex.getColumn(edge);
+	if (column == RouteIndex::NOT_FOUND) { // no alternative route goes through the edge
+		return;
+	}
+	Contribution next = computeContribution(edge, column, true);
+	Contribution & previous = contributions[column];
+	for (map<pair<StringId,StringId>, RouteAggregates>::iterator it = aggregates.begin(); it != aggregates.end(); ++it) {
+		const RouteIndex::Selection & selection = TIS::getInstance().getSelection(it->first.first, it->first.second);
+		for (uint32_t row = 0; row < it->second.size(); ++row) {
+			uint32_t count = routeIndex.count(selection, row, column);
+			if (count > 0) {
+				it->second[row].apply(previous, next, count);
+			}
+		}
+	}
+	if (next.fresh && next.dated && (!previous.fresh || previous.date != next.date)) {
+		expiries.push(make_pair(next.date + maxInformationAge, column));
+		scheduleExpiry();
+	}
+	previous = next;
+}
+
+void Knowledge::checkRouteIndex() {
+	const RouteIndex & routeIndex = TIS::getInstance().getRouteIndex();
+	if (routeIndex.getNumberOfRows() == indexedRoutes) {
+		return;
+	}
+	// the columns of the recorded edges and the selections may have changed
+	indexedRoutes = routeIndex.getNumberOfRows();
+	contributions.clear();
+	aggregates.clear();
+	expiries = priority_queue<pair<double,uint32_t>, vector<pair<double,uint32_t> >, greater<pair<double,uint32_t> > >();
+	const KnowledgeStore & records = travelTimes;
+	for (vector<StringId>::const_iterator it = records.getEdges().begin(); it != records.getEdges().end(); ++it) {
+		uint32_t column = routeIndex.getColumn(*it);
+		if (column != RouteIndex::NOT_FOUND) {
+			Contribution & contribution = contributions[column] = computeContribution(*it, column, false);
+			if (contribution.fresh && contribution.dated) {
+				expiries.push(make_pair(contribution.date + maxInformationAge, column));
+			}
+		}
+	}
+	scheduleExpiry();
+}
+
+const Knowledge::RouteAggregates & Knowledge::getAggregates(StringId startEdge, StringId endEdge) {
+	checkRouteIndex();
+	expire();
+	pair<StringId,StringId> key(startEdge, endEdge);
+	map<pair<StringId,StringId>, RouteAggregates>::iterator it = aggregates.find(key);
+	if (it != aggregates.end()) {
+		return it->second;
+	}
+	const RouteIndex & routeIndex = TIS::getInstance().getRouteIndex();
+	const RouteIndex::Selection & selection = TIS::getInstance().getSelection(startEdge, endEdge);
+	RouteAggregates & routeAggregates = aggregates[key];
+	routeAggregates.resize(routeIndex.getNumberOfRows());
+	Contribution none;
+	for (map<uint32_t, Contribution>::iterator itContributions = contributions.begin(); itContributions != contributions.end(); ++itContributions) {
+		for (uint32_t row = 0; row < routeAggregates.size(); ++row) {
+			uint32_t count = routeIndex.count(selection, row, itContributions->first);
+			if (count > 0) {
+				routeAggregates[row].apply(none, itContributions->second, count);
+			}
+		}
+	}
+	return routeAggregates;
+}
+
+void Knowledge::expire() {
+	double now = Simulator::Now().GetSeconds();
+	while (!expiries.empty() && expiries.top().first <= now) {
+		uint32_t column = expiries.top().second;
+		expiries.pop();
+		update(TIS::getInstance().getRouteIndex().getEdge(column));
+	}
+	scheduleExpiry();
+}
+
+void Knowledge::scheduleExpiry() {
+	if (expiries.empty()) {
+		return;
+	}
+	double next = expiries.top().first;
+	if (expiryEvent.IsRunning() && scheduledExpiry <= next) {
+		return;
+	}
+	expiryEvent.Cancel();
+	scheduledExpiry = next;
+	// at least a step later, should the delay be rounded down
+	expiryEvent = Simulator::Schedule(Max(Seconds(next - Simulator::Now().GetSeconds()), NanoSeconds(1)), &Knowledge::expire, this);
+}
+
+void Knowledge::analyseLocalDatabase(const map<string, Route> & routes, const string & startEdgeId, const string & endEdgeId, const map<string,double> & routeTTL, bool usePerfectInformation) {
 	ifCongestedFlow = false;
 	ifDenseFlow = false;
 	sumLength = 0;
@@ -85,161 +296,164 @@ void Knowledge::analyseLocalDatabase(map<string, Route> routes, string startEdge
 	denseLength = 0;
 	sumDelay = 0;
 	int totalNumberOfUpdatedEdges = 0;
-	map<string,int> vehicles;
 	map<string,double> newTravelTimesOnRoutes = map<string,double>(); // for a potential comparison to the last state in the local data base
 	packetAgesOnRoutes = map<string,double>();
 	delayOnRoutes = map<string,double>();
 	congestedLengthOnRoutes = map<string,double>();
 	denseLengthOnRoutes = map<string,double>();
-	// initialize
-	for (map<string, Route>::iterator it = routes.begin(); it != routes.end(); ++it) {
-		newTravelTimesOnRoutes[it->first] = TIS::getInstance().computeStaticCostExcludingMargins(it->first, startEdgeId, endEdgeId);
+	StringId startEdge = intern(startEdgeId);
+	StringId endEdge = intern(endEdgeId);
+	double now = Simulator::Now().GetSeconds();
+
+//	map<string, RecordEntry> perfectDB = TIS::getInstance().getPerfectTravelTimes();
+
+	if (usePerfectInformation) {
+		const KnowledgeStore & records = travelTimes; // reading does not copy a shared entry
+		for (vector<StringId>::const_iterator it = records.getEdges().begin(); it != records.getEdges().end(); ++it) {
+			StringId edge = *it;
+			const RecordEntry * recordEntry = records.find(edge);
+			double packetDate = recordEntry->getLatestTime();
+			double packetAge = packetDate == 0 ? 0 : now - packetDate;
+			Log::getInstance().getStream("perfect") << now << "\t" << lookup(edge) << "\tvanet\t" << recordEntry->getLatestValue() << "\t" << packetAge;
+			double travelTime = TIS::getInstance().getEdgePerfectCost(edge);
+			travelTimes[edge].add(0, NO_STRING_ID, now, travelTime);
+			update(edge);
+			Log::getInstance().getStream("perfect") << now << "\tperfect\t" << travelTime << "\t" << 0 << endl;
+		}
+	}
+
+	// sums over the edges of the routes between the start and the end edge, maintained by update()
+	const RouteAggregates & routeAggregates = getAggregates(startEdge, endEdge);
+	const RouteIndex & routeIndex = TIS::getInstance().getRouteIndex();
+	const RouteIndex::Selection & selection = TIS::getInstance().getSelection(startEdge, endEdge);
+	const vector<double> & staticRouteCosts = TIS::getInstance().getStaticRouteCosts(startEdge, endEdge);
+	vector<uint32_t> rows; // row of each route in the index
+	for (map<string, Route>::const_iterator it = routes.begin(); it != routes.end(); ++it) {
+		uint32_t row = routeIndex.getRow(it->first);
+		rows.push_back(row);
+		newTravelTimesOnRoutes[it->first] = 0;
 		packetAgesOnRoutes[it->first] = 0;
-		vehicles[it->first] = 0;
 		numberOfUpdatedEdges[it->first] = 0;
 		numberOfEdges[it->first] = 0;
 		congestedLengthOnRoutes[it->first] = 0;
 		denseLengthOnRoutes[it->first] = 0;
 		delayOnRoutes[it->first] = 0;
-	}
-
-//	map<string, RecordEntry> perfectDB = TIS::getInstance().getPerfectTravelTimes();
-
-	for (map<string, RecordEntry>::iterator it = travelTimes.begin(); it != travelTimes.end(); ++it) {
-		RecordEntry recordEntry = it->second;
-		string edgeId = it->first;
-		double travelTime = recordEntry.getLatestValue();
-		double packetDate = recordEntry.getLatestTime();
-		double packetAge = packetDate == 0 ? 0 : Simulator::Now().GetSeconds() - packetDate;
-//		double avgTravelTime = it->second.getAverageValue();
-//		double avgPacketDate = it->second.getAverageTime();
-//		travelTime = avgTravelTime;
-//		packetDate = avgPacketDate;
-
-		if (usePerfectInformation) {
-			Log::getInstance().getStream("perfect") << Simulator::Now().GetSeconds() << "\t" << edgeId << "\tvanet\t" << travelTime << "\t" << packetAge;
-			travelTime = TIS::getInstance().getEdgePerfectCost(edgeId);
-			packetDate = Simulator::Now().GetSeconds();
-			packetAge = 0;
-			travelTimes[edgeId].add(0, "", packetDate, travelTime);
-			Log::getInstance().getStream("perfect") << Simulator::Now().GetSeconds() << "\tperfect\t" << travelTime << "\t" << packetAge << endl;
+		if (row == RouteIndex::NOT_FOUND) {
+			continue;
 		}
-		double staticCost = TIS::getInstance().getEdgeStaticCost(edgeId);
-		if (staticCost != 0) {
-			recordEntry.setCapacity(staticCost);
+		// the counts are exact, the sums of what was added and removed are not
+		const RouteAggregate & aggregate = routeAggregates[row];
+		newTravelTimesOnRoutes[it->first] = staticRouteCosts[row] + (aggregate.fresh > 0 ? aggregate.costDelta : 0);
+		numberOfEdges[it->first] = aggregate.recorded;
+		numberOfUpdatedEdges[it->first] = aggregate.fresh;
+		totalNumberOfUpdatedEdges += aggregate.fresh;
+		if (aggregate.recorded > 0) {
+			sumLength += aggregate.length;
 		}
-		int vehs = numberOfVehicles[it->first];
-
-		// calculate travel times on routes
-		for (map<string, Route>::iterator itRoutes = routes.begin(); itRoutes != routes.end(); ++itRoutes) {
-			if (itRoutes->second.containsEdgeExcludedMargins(edgeId, startEdgeId, endEdgeId)) { // if the edge belongs to the part of the future route
-//				maxInformationAge = routeTTL[itRoutes->first];
-				maxInformationAge = 120;
-				double edgeLength = TIS::getInstance().getEdgeLength(edgeId);
-				sumLength += edgeLength;
-				++numberOfEdges[itRoutes->first];
-				if (travelTime > 0 && packetAge < maxInformationAge) { // information was recorded about this edge and is fresh enough
-					// update travel time with the information from th elocal database
-					newTravelTimesOnRoutes[itRoutes->first] = newTravelTimesOnRoutes[itRoutes->first] - staticCost + travelTime;
-					++numberOfUpdatedEdges[itRoutes->first];
-					++totalNumberOfUpdatedEdges;
-					Log::getInstance().getStream("capacity") << Simulator::Now().GetSeconds() << "\t";
-					if (travelTime != SIMULATION_STEP_INTERVAL || recordEntry.getExpectedValue() > SIMULATION_STEP_INTERVAL) { // sumo bug fix - travelTime > 1 means that it was recorded in sumo!
-						double delay = travelTime - recordEntry.getExpectedValue();
-						if (delay > 0) {
-							delayOnRoutes[itRoutes->first] += delay;
-							sumDelay += delay;
-						}
-						Log::getInstance().getStream("vanets_knowledge") << edgeId << "," << packetDate << "," << travelTime  <<"," << recordEntry.getExpectedValue() << "\t";
-						Log::getInstance().getStream("delay") << Simulator::Now().GetSeconds() << "\t" << edgeId << "\t" << travelTime << "\t-\t" << recordEntry.getExpectedValue() << "\t=\t" << delay << "\t";
-						Log::getInstance().getStream("capacity") << edgeId << "," << recordEntry.getExpectedValue() << "," << travelTime << "," << recordEntry.getActualCapacity() << "\t";
-						if (recordEntry.getActualCapacity() < congestionThreshold) {
-							congestedLength += edgeLength;
-							ifCongestedFlow = true;
-							double now = Simulator::Now().GetSeconds();
-							congestedLengthOnRoutes[itRoutes->first] += edgeLength;
-							Log::getInstance().getStream("congestion") << Simulator::Now().GetSeconds() << "\t" << edgeId << "\t" << recordEntry.getActualCapacity() << "<" << congestionThreshold << "\t" << travelTime << "\t" << recordEntry.getExpectedValue() << endl;
-						}
-						if (recordEntry.getActualCapacity() > congestionThreshold && recordEntry.getActualCapacity() < densityThreshold) {
-							ifDenseFlow = true;
-							denseLengthOnRoutes[itRoutes->first] += edgeLength;
-							Log::getInstance().getStream("dense") << Simulator::Now().GetSeconds() << "\t" << edgeId << "\t" << congestionThreshold << "<" << recordEntry.getActualCapacity() << "<" << densityThreshold << "\t" << travelTime << "\t" << recordEntry.getExpectedValue() << endl;
-						}
-					}
-				}
-				else if (travelTime > 0 && packetAge < maxInformationAge) { // information was recorded but it's older than the allowed treshold
-					// reset packet age
-					packetAge = 0;
-				}
-				packetAgesOnRoutes[itRoutes->first] += packetAge;
-			}
+		if (aggregate.dated > 0) {
+			packetAgesOnRoutes[it->first] = aggregate.dated * now - aggregate.date;
+		}
+		if (aggregate.delayed > 0) {
+			delayOnRoutes[it->first] = aggregate.delay;
+			sumDelay += aggregate.delay;
+		}
+		if (aggregate.congested > 0) {
+			congestedLengthOnRoutes[it->first] = aggregate.congestedLength;
+			congestedLength += aggregate.congestedLength;
+			ifCongestedFlow = true;
+		}
+		if (aggregate.dense > 0) {
+			denseLengthOnRoutes[it->first] = aggregate.denseLength;
+			denseLength += aggregate.denseLength;
+			ifDenseFlow = true;
 		}
 	}
 
 	// calculate the average information age
-	for (map<string, Route>::iterator it = routes.begin(); it != routes.end(); ++it) {
+	for (map<string, Route>::const_iterator it = routes.begin(); it != routes.end(); ++it) {
 		packetAgesOnRoutes[it->first] = numberOfUpdatedEdges[it->first] == 0 ? 0 : packetAgesOnRoutes[it->first] / numberOfUpdatedEdges[it->first];
 	}
 	// print knowledge
-	for (map<string, Route>::iterator it = routes.begin(); it != routes.end(); ++it) {
+	size_t route = 0;
+	for (map<string, Route>::const_iterator it = routes.begin(); it != routes.end(); ++it, ++route) {
 		packetAgesOnRoutes[it->first] = numberOfUpdatedEdges[it->first] == 0 ? 0 : packetAgesOnRoutes[it->first] / numberOfUpdatedEdges[it->first];
 		//if (totalNumberOfUpdatedEdges > 0) {
-			Log::getInstance().getStream("vanets_knowledge") << it->first << "," << numberOfUpdatedEdges[it->first] << "," << it->second.countEdgesExcludedMargins(startEdgeId, endEdgeId) << "\t";
+			Log::getInstance().getStream("vanets_knowledge") << it->first << "," << numberOfUpdatedEdges[it->first] << "," << (rows[route] == RouteIndex::NOT_FOUND ? 0 : routeIndex.count(selection, rows[route])) << "\t";
 		//}
 	}
 	Log::getInstance().getStream("vanets_knowledge") << endl;
 //	for (map<string, double>::iterator it = newTravelTimesOnRoutes.begin(); it != newTravelTimesOnRoutes.end(); ++it) {
 ////		cout << "route " << it->first << ", new travel time " << it->second << ", traveltime " << travelTimesOnRoutes[it->first] << ", number of updated edges: " << numberOfUpdatedEdges[it->first] << " / number of edges: " << numberOfEdges[it->first] << endl;
 //	}
-	travelTimesOnRoutes = newTravelTimesOnRoutes;
+	travelTimesOnRoutes.swap(newTravelTimesOnRoutes);
 }
 
 
-map<string,map<string,vector<string> > > Knowledge::analyseCorrelation(map<string, Route> routes, string startEdgeId, string endEdgeId) {
-	map<string,map<string,vector<string> > > correlated;
-	for (map<string, Route>::iterator itRoutes = routes.begin(); itRoutes != routes.end(); ++itRoutes) {
+const map<string,map<string,vector<string> > > & Knowledge::analyseCorrelation(const map<string, Route> & routes, const string & startEdgeId, const string & endEdgeId) {
+	StringId startEdge = intern(startEdgeId);
+	StringId endEdge = intern(endEdgeId);
+	const RouteIndex & routeIndex = TIS::getInstance().getRouteIndex();
+	CorrelationKey key(make_pair(startEdge, endEdge), vector<StringId>());
+	for (map<string, Route>::const_iterator itRoutes = routes.begin(); itRoutes != routes.end(); ++itRoutes) {
+		key.second.push_back(intern(itRoutes->first));
+	}
+	Correlation & correlation = getCorrelations()[key];
+	if (correlation.indexedRoutes == routeIndex.getNumberOfRows()) {
+		return correlation.correlated;
+	}
+
+	// computed on first use, and again if routes were indexed since
+	map<string,map<string,vector<string> > > & correlated = correlation.correlated;
+	correlated.clear();
+	correlation.indexedRoutes = routeIndex.getNumberOfRows();
+	const RouteIndex::Selection & selection = TIS::getInstance().getSelection(startEdge, endEdge);
+	for (map<string, Route>::const_iterator itRoutes = routes.begin(); itRoutes != routes.end(); ++itRoutes) {
 		correlated[itRoutes->first] = map<string,vector<string> >();
-		for (map<string, Route>::iterator itRoutesCorrleated = routes.begin(); itRoutesCorrleated != routes.end(); ++itRoutesCorrleated) {
+		uint32_t row = routeIndex.getRow(itRoutes->first);
+		for (map<string, Route>::const_iterator itRoutesCorrleated = routes.begin(); itRoutesCorrleated != routes.end(); ++itRoutesCorrleated) {
 			if (itRoutes->first != itRoutesCorrleated->first) {
 				correlated[itRoutes->first][itRoutesCorrleated->first] = vector<string>();
-				for (vector<string>::iterator itEdges = itRoutes->second.getEdgeIds().begin(); itEdges != itRoutes->second.getEdgeIds().end(); ++itEdges) {
-					if (itRoutesCorrleated->second.containsEdgeExcludedMargins(*itEdges, startEdgeId, endEdgeId)) {
-						correlated[itRoutes->first][itRoutesCorrleated->first].push_back(*itEdges);
+				uint32_t correlatedRow = routeIndex.getRow(itRoutesCorrleated->first);
+				if (row == RouteIndex::NOT_FOUND || correlatedRow == RouteIndex::NOT_FOUND) {
+					continue;
+				}
+				for (uint32_t i = 0; i < routeIndex.getLength(row); ++i) {
+					uint32_t column = routeIndex.getColumnAt(row, i);
+					if (routeIndex.contains(selection, correlatedRow, column)) {
+						correlated[itRoutes->first][itRoutesCorrleated->first].push_back(lookup(routeIndex.getEdge(column)));
 					}
 				}
 			}
 		}
 	}
-	if (TIS::getInstance().executeOnce == false) {
-		for (map<string, map<string,vector<string> > >::iterator itCorrelated = correlated.begin(); itCorrelated != correlated.end(); ++itCorrelated) {
-			Log::getInstance().getStream("correlation") << itCorrelated->first << ":" << endl;
-			for (map<string,vector<string> >::iterator itCorrelatedTo = itCorrelated->second.begin(); itCorrelatedTo != itCorrelated->second.end(); ++itCorrelatedTo) {
-				Log::getInstance().getStream("correlation") << itCorrelatedTo->first << "\t" << itCorrelatedTo->second.size() << ":\t";
-				for (vector<string>::iterator it = itCorrelatedTo->second.begin(); it != itCorrelatedTo->second.end(); ++it) {
-					Log::getInstance().getStream("correlation") << *it << "\t";
-				}
-				Log::getInstance().getStream("correlation") << endl;
+	Log::getInstance().getStream("correlation") << startEdgeId << "\t" << endEdgeId << endl;
+	for (map<string, map<string,vector<string> > >::iterator itCorrelated = correlated.begin(); itCorrelated != correlated.end(); ++itCorrelated) {
+		Log::getInstance().getStream("correlation") << itCorrelated->first << ":" << endl;
+		for (map<string,vector<string> >::iterator itCorrelatedTo = itCorrelated->second.begin(); itCorrelatedTo != itCorrelated->second.end(); ++itCorrelatedTo) {
+			Log::getInstance().getStream("correlation") << itCorrelatedTo->first << "\t" << itCorrelatedTo->second.size() << ":\t";
+			for (vector<string>::iterator it = itCorrelatedTo->second.begin(); it != itCorrelatedTo->second.end(); ++it) {
+				Log::getInstance().getStream("correlation") << *it << "\t";
 			}
 			Log::getInstance().getStream("correlation") << endl;
 		}
-		TIS::getInstance().executeOnce = true;
+		Log::getInstance().getStream("correlation") << endl;
 	}
 	return correlated;
 }
 
-map<string,double> Knowledge::getTravelTimesOnRoutes() {
+const map<string,double> & Knowledge::getTravelTimesOnRoutes() {
 	return travelTimesOnRoutes;
 }
 
-map<string,double> Knowledge::getDelayOnRoutes() {
+const map<string,double> & Knowledge::getDelayOnRoutes() {
 	return delayOnRoutes;
 }
 
-map<string,double> Knowledge::getCongestedLengthOnRoutes() {
+const map<string,double> & Knowledge::getCongestedLengthOnRoutes() {
 	return congestedLengthOnRoutes;
 }
 
-map<string,double> Knowledge::getDenseLengthOnRoutes() {
+const map<string,double> & Knowledge::getDenseLengthOnRoutes() {
 	return denseLengthOnRoutes;
 }
 
@@ -259,25 +473,35 @@ double Knowledge::getSumLength() {
 	return sumLength;
 }
 
-map<std::string,double> Knowledge::getEdgesCosts(map<string, Route> routes, string startEdgeId, string endEdgeId, bool usePerfect)
+map<std::string,double> Knowledge::getEdgesCosts(const map<string, Route> & routes, const string & startEdgeId, const string & endEdgeId, bool usePerfect)
 {
-	map<string, RecordEntry> ttdb = travelTimes;
-	if (usePerfect) {
-		ttdb = TIS::getInstance().getPerfectTravelTimes();
-	}
+	const KnowledgeStore & ttdb = usePerfect ? TIS::getInstance().getPerfectTravelTimes() : travelTimes;
+	StringId startEdge = intern(startEdgeId);
+	StringId endEdge = intern(endEdgeId);
+	const RouteIndex & routeIndex = TIS::getInstance().getRouteIndex();
+	const RouteIndex::Selection & selection = TIS::getInstance().getSelection(startEdge, endEdge);
+	const vector<double> & staticCosts = TIS::getInstance().getStaticEdgeCosts();
 	map<std::string, double> edgesCosts;//edgesCosts = map<string, double> ();
-	for (map<string, EdgeInfo>::iterator it = TIS::getInstance().getStaticRecords().begin(); it != TIS::getInstance().getStaticRecords().end(); ++it) {
-		for (map<string, Route>::iterator itRoutes = routes.begin(); itRoutes != routes.end(); ++itRoutes) {
-			if (itRoutes->second.containsEdgeExcludedMargins(it->first, startEdgeId, endEdgeId)) {
-				if (edgesCosts.find(it->first) == edgesCosts.end()) {
-					double travelTime = ttdb[it->first].getLatestValue();
-					double packetAge = ttdb[it->first].getLatestTime() == 0 ? 0 : Simulator::Now().GetSeconds() - ttdb[it->first].getLatestTime();
-					if (travelTime > 0 && packetAge < maxInformationAge) { // if the information is fresh enough
-						edgesCosts[it->first] = travelTime;
-					}
-					else {
-						edgesCosts[it->first] = it->second.getStaticCost();
-					}
+	vector<uint32_t> columns;
+	for (map<string, Route>::const_iterator itRoutes = routes.begin(); itRoutes != routes.end(); ++itRoutes) {
+		uint32_t row = routeIndex.getRow(itRoutes->first);
+		if (row == RouteIndex::NOT_FOUND) {
+			continue;
+		}
+		routeIndex.getColumns(selection, row, columns);
+		for (vector<uint32_t>::iterator it = columns.begin(); it != columns.end(); ++it) {
+			StringId edge = routeIndex.getEdge(*it);
+			const string & edgeId = lookup(edge);
+			if (edgesCosts.find(edgeId) == edgesCosts.end()) {
+				const RecordEntry * entry = ttdb.find(edge);
+				double travelTime = entry == 0 ? 0 : entry->getLatestValue();
+				double packetDate = entry == 0 ? 0 : entry->getLatestTime();
+				double packetAge = packetDate == 0 ? 0 : Simulator::Now().GetSeconds() - packetDate;
+				if (travelTime > 0 && packetAge < maxInformationAge) { // if the information is fresh enough
+					edgesCosts[edgeId] = travelTime;
+				}
+				else {
+					edgesCosts[edgeId] = staticCosts[*it];
 				}
 			}
 		}
@@ -285,7 +509,7 @@ map<std::string,double> Knowledge::getEdgesCosts(map<string, Route> routes, stri
     return edgesCosts;
 }
 
-map<std::string,double> Knowledge::getEdgesCosts(map<string, Route> routes, string startEdgeId, string endEdgeId)
+map<std::string,double> Knowledge::getEdgesCosts(const map<string, Route> & routes, const string & startEdgeId, const string & endEdgeId)
 {
 	return getEdgesCosts(routes, startEdgeId, endEdgeId, false);
 }
@@ -16,8 +16,11 @@
 #include <set>
 #include <limits.h>
 #include <stdint.h>
+#include <queue>
+#include <functional>
 
 #include "ns3/ptr.h"
+#include "ns3/event-id.h"
 #include "applications/ovnis-application.h"
 #include "vehicle.h"
 #include "scenario.h"
@@ -26,6 +29,9 @@
 #include "ovnisPacket.h"
 #include "itinerary.h"
 #include "recordEntry.h"
+#include "knowledgeStore.h"
+#include "routeIndex.h"
+#include "roadGraph.h"
 #include "applications/trafficInformationSystem.h"
 #include "traci/sumoTraciConnection.h"
 #include <traci-server/TraCIConstants.h>
@@ -35,29 +41,52 @@ using namespace std;
 namespace ovnis
 {
 
+/**
+ * Travel times heard by a vehicle, and their analysis on the alternative routes.
+ *
+ * The sums over the routes read by analyseLocalDatabase are maintained as the records
+ * change: each edge on a route of the TIS route index has a Contribution, computed from
+ * its latest record, and the aggregates of the routes between a start and an end edge
+ * are updated with the difference when it changes. A contribution stops counting as
+ * fresh maxInformationAge after the date of its record, on a timer. The aggregates of
+ * a start and end edge are built at the first decision there.
+ */
 class Knowledge {
 public:
 	Knowledge();
 	virtual ~Knowledge();
 
-	int getNumberOfVehicles(std::string edgeId);
-	int addNumberOfVehicles(std::string edgeId);
-	int substractNumberOfVehicles(std::string edgeId);
-
-	bool record(Data data);
-	void record(vector<Data> data);
-	map<string,RecordEntry> & getRecords();
-
-	void analyseLocalDatabase(map<string, Route> routes, string startEdgeId, string endEdgeId, map<string,double> routeTTL, bool usePerfectInformation);
-	map<string,map<string,vector<string> > > analyseCorrelation(map<string, Route> routes, string startEdgeId, string endEdgeI);
-
-	map<std::string,double> getEdgesCosts(map<string, Route> routes, string startEdgeId, string endEdgeId, bool usePerfect);
-
-	map<std::string,double> getCongestedLengthOnRoutes();
-	map<std::string,double> getDenseLengthOnRoutes();
-	map<std::string,double> getTravelTimesOnRoutes();
-	map<std::string,double> getDelayOnRoutes();
-    map<std::string,double> getEdgesCosts(map<std::string, Route> routes, std::string startEdgeId, std::string endEdgeId);
+	int getNumberOfVehicles(const std::string & edgeId);
+	int addNumberOfVehicles(const std::string & edgeId);
+	int substractNumberOfVehicles(const std::string & edgeId);
+
+	bool record(const Data & data);
+	void record(const vector<Data> & data);
+	/**
+	 * Records are only modified by record(), which keeps the aggregates up to date.
+	 */
+	const KnowledgeStore & getRecords();
+	/**
+	 * Fills weights with the fresh travel time heard about each edge of graph, its
+	 * static cost if none was, for the RoutingEngine.
+	 */
+	void getEdgeWeights(const RoadGraph & graph, vector<double> & weights) const;
+
+	void analyseLocalDatabase(const map<string, Route> & routes, const string & startEdgeId, const string & endEdgeId, const map<string,double> & routeTTL, bool usePerfectInformation);
+	/**
+	 * @return the edges each route shares with each other route, between startEdgeId and
+	 * endEdgeId. It only depends on the routes, and is computed and logged once for all
+	 * the vehicles.
+	 */
+	const map<string,map<string,vector<string> > > & analyseCorrelation(const map<string, Route> & routes, const string & startEdgeId, const string & endEdgeId);
+
+	map<std::string,double> getEdgesCosts(const map<string, Route> & routes, const string & startEdgeId, const string & endEdgeId, bool usePerfect);
+
+	const map<std::string,double> & getCongestedLengthOnRoutes();
+	const map<std::string,double> & getDenseLengthOnRoutes();
+	const map<std::string,double> & getTravelTimesOnRoutes();
+	const map<std::string,double> & getDelayOnRoutes();
+    map<std::string,double> getEdgesCosts(const map<std::string, Route> & routes, const std::string & startEdgeId, const std::string & endEdgeId);
     bool isCongestedFlow() const;
     bool isDenseFlow() const;
 
@@ -67,10 +96,62 @@ public:
     double getSumLength();
 
 protected:
+	/**
+	 * What the latest record about an edge adds to a route through it.
+	 */
+	struct Contribution {
+		Contribution();
+
+		int recorded; // numberOfEdges
+		double length;
+		int dated; // records with a date, whose age is counted
+		double date;
+		int fresh; // numberOfUpdatedEdges
+		double costDelta; // travel time heard - static cost, for each time the route goes through the edge
+		int delayed;
+		double delay;
+		int congested;
+		double congestedLength;
+		int dense;
+		double denseLength;
+	};
+	/**
+	 * Sum of the contributions of the edges of a route between a start and an end edge.
+	 */
+	struct RouteAggregate : public Contribution {
+		/**
+		 * Replaces previous with next, count times through the edge.
+		 */
+		void apply(const Contribution & previous, const Contribution & next, uint32_t count);
+	};
+	typedef std::vector<RouteAggregate> RouteAggregates; // by row of the route index
+
+	/**
+	 * @param log whether to log the capacity, delay, congestion and density of the edge.
+	 */
+	Contribution computeContribution(StringId edge, uint32_t column, bool log) const;
+	/**
+	 * Updates the contribution of edge from its latest record.
+	 */
+	void update(StringId edge);
+	/**
+	 * Rebuilds the contributions when the route index has changed.
+	 */
+	void checkRouteIndex();
+	/**
+	 * @return the aggregates of the routes between startEdge and endEdge.
+	 */
+	const RouteAggregates & getAggregates(StringId startEdge, StringId endEdge);
+	/**
+	 * Updates the contributions that are not fresh anymore.
+	 */
+	void expire();
+	void scheduleExpiry();
+
     Ptr<ovnis::SumoTraciConnection> traci;
 	map<long,int> packets; // counter of packets
-	std::map<std::string, RecordEntry> travelTimes; // info about travel times on routes
-	std::map<std::string, int> numberOfVehicles;
+	KnowledgeStore travelTimes; // info about travel times on routes
+	std::map<StringId, int> numberOfVehicles;
 	map<std::string,double> congestedLengthOnRoutes;
 	map<std::string,double> delayOnRoutes;
 	map<std::string,double> denseLengthOnRoutes;
@@ -89,6 +170,17 @@ protected:
 	double congestedLength;
 	double denseLength;
 	double sumDelay;
+
+	uint32_t indexedRoutes; // rows of the route index when the contributions were computed
+	std::map<uint32_t, Contribution> contributions; // by column of the route index
+	std::map<std::pair<StringId,StringId>, RouteAggregates> aggregates; // by start and end edge
+	std::priority_queue<std::pair<double,uint32_t>, std::vector<std::pair<double,uint32_t> >, std::greater<std::pair<double,uint32_t> > > expiries; // date and column of the fresh contributions
+	EventId expiryEvent;
+	double scheduledExpiry;
+
+private:
+	Knowledge(const Knowledge &); // Don't Implement, the expiry timer refers to this
+	void operator =(const Knowledge &); // Don't implement
 };
 
 }
@@ -0,0 +1,235 @@
+/*
+ * knowledgeStore.cpp
+ *
+ *  Travel times heard by a vehicle, per edge.
+ */
+
+#include <algorithm>
+#include <map>
+#include "knowledgeStore.h"
+
+using namespace std;
+
+namespace ovnis {
+
+const uint32_t KnowledgeStore::NO_EDGE_INDEX;
+const uint32_t KnowledgeStore::NO_ENTRY;
+const uint32_t KnowledgeStore::IN_BASELINE;
+
+namespace {
+
+/**
+ * Dense numbers of the edges, shared by the stores of all the vehicles.
+ */
+struct EdgeNumbers {
+	vector<uint32_t> indices; // number of each handle
+	uint32_t count;
+
+	EdgeNumbers() : count(0) {
+	}
+};
+
+EdgeNumbers & getEdgeNumbers() {
+	static EdgeNumbers numbers; // Instantiated on first use.
+	return numbers;
+}
+
+struct SameState {
+	bool operator()(const RecordEntry * a, const RecordEntry * b) const {
+		return a->compare(*b) < 0;
+	}
+};
+
+}
+
+KnowledgeStore::KnowledgeStore() : sharing(false) {
+}
+
+KnowledgeStore::KnowledgeStore(const KnowledgeStore & other) :
+		baseline(other.baseline), slots(other.slots), entries(other.entries), edges(other.edges), sharing(false) {
+	if (other.sharing) {
+		share();
+	}
+}
+
+KnowledgeStore & KnowledgeStore::operator =(const KnowledgeStore & other) {
+	// whether the store shares does not change
+	baseline = other.baseline;
+	slots = other.slots;
+	entries = other.entries;
+	edges = other.edges;
+	return *this;
+}
+
+KnowledgeStore::~KnowledgeStore() {
+	if (sharing) {
+		getSharingStores().erase(this);
+	}
+}
+
+uint32_t KnowledgeStore::getEdgeIndex(StringId edge, bool add) {
+	EdgeNumbers & numbers = getEdgeNumbers();
+	if (edge >= numbers.indices.size()) {
+		if (!add) {
+			return NO_EDGE_INDEX;
+		}
+		numbers.indices.resize(edge + 1, NO_EDGE_INDEX);
+	}
+	if (numbers.indices[edge] == NO_EDGE_INDEX && add) {
+		numbers.indices[edge] = numbers.count++;
+	}
+	return numbers.indices[edge];
+}
+
+uint32_t KnowledgeStore::getNumberOfEdges() {
+	return getEdgeNumbers().count;
+}
+
+ns3::Ptr<const KnowledgeStore::Baseline> & KnowledgeStore::getCurrentBaseline() {
+	static ns3::Ptr<const Baseline> current;
+	return current;
+}
+
+set<KnowledgeStore *> & KnowledgeStore::getSharingStores() {
+	static set<KnowledgeStore *> stores;
+	return stores;
+}
+
+const RecordEntry * KnowledgeStore::findByIndex(uint32_t index) const {
+	if (index >= slots.size() || slots[index] == NO_ENTRY) {
+		return 0;
+	}
+	if (slots[index] == IN_BASELINE) {
+		return &baseline->entries[baseline->slots[index]];
+	}
+	return &entries[slots[index]];
+}
+
+const RecordEntry * KnowledgeStore::find(StringId edge) const {
+	return findByIndex(getEdgeIndex(edge, false));
+}
+
+RecordEntry * KnowledgeStore::find(StringId edge) {
+	uint32_t index = getEdgeIndex(edge, false);
+	if (index >= slots.size() || slots[index] == NO_ENTRY) {
+		return 0;
+	}
+	if (slots[index] == IN_BASELINE) {
+		// copy on write
+		entries.push_back(baseline->entries[baseline->slots[index]]);
+		slots[index] = entries.size() - 1;
+	}
+	return &entries[slots[index]];
+}
+
+RecordEntry & KnowledgeStore::operator[](StringId edge) {
+	RecordEntry * entry = find(edge);
+	if (entry != 0) {
+		return *entry;
+	}
+	uint32_t index = getEdgeIndex(edge, true);
+	if (index >= slots.size()) {
+		slots.resize(index + 1, NO_ENTRY);
+	}
+	slots[index] = entries.size();
+	entries.push_back(RecordEntry());
+	edges.insert(lower_bound(edges.begin(), edges.end(), edge), edge);
+	return entries.back();
+}
+
+const vector<StringId> & KnowledgeStore::getEdges() const {
+	return edges;
+}
+
+size_t KnowledgeStore::size() const {
+	return edges.size();
+}
+
+bool KnowledgeStore::empty() const {
+	return edges.empty();
+}
+
+void KnowledgeStore::clear() {
+	baseline = 0;
+	slots.clear();
+	entries.clear();
+	edges.clear();
+}
+
+size_t KnowledgeStore::getMemoryUsage() const {
+	return sizeof(KnowledgeStore) + slots.capacity() * sizeof(uint32_t) + entries.size() * sizeof(RecordEntry)
+			+ edges.capacity() * sizeof(StringId);
+}
+
+void KnowledgeStore::share() {
+	sharing = true;
+	getSharingStores().insert(this);
+}
+
+size_t KnowledgeStore::compact(double minimumShare) {
+	set<KnowledgeStore *> & stores = getSharingStores();
+	ns3::Ptr<const Baseline> & current = getCurrentBaseline();
+	ns3::Ptr<Baseline> next = ns3::Create<Baseline>();
+	next->version = current == 0 ? 1 : current->version + 1;
+	next->slots.resize(getNumberOfEdges(), NO_ENTRY);
+
+	// the state of each edge held by most stores, if enough of them hold it
+	double minimumCount = max(1.0, minimumShare * stores.size());
+	for (uint32_t index = 0; index < getNumberOfEdges(); ++index) {
+		map<const RecordEntry *, uint32_t, SameState> counts;
+		const RecordEntry * best = 0;
+		uint32_t bestCount = 0;
+		for (set<KnowledgeStore *>::iterator it = stores.begin(); it != stores.end(); ++it) {
+			const RecordEntry * entry = (*it)->findByIndex(index);
+			if (entry != 0) {
+				uint32_t & count = counts[entry];
+				if (++count > bestCount) {
+					best = entry;
+					bestCount = count;
+				}
+			}
+		}
+		if (bestCount >= minimumCount) {
+			next->slots[index] = next->entries.size();
+			next->entries.push_back(*best);
+		}
+	}
+
+	// each store keeps a copy of the entries that differ from the new baseline only
+	for (set<KnowledgeStore *>::iterator it = stores.begin(); it != stores.end(); ++it) {
+		KnowledgeStore & store = **it;
+		vector<uint32_t> slots(store.slots.size(), NO_ENTRY);
+		deque<RecordEntry> entries;
+		for (vector<StringId>::const_iterator edge = store.edges.begin(); edge != store.edges.end(); ++edge) {
+			uint32_t index = getEdgeIndex(*edge, false);
+			const RecordEntry * entry = store.findByIndex(index);
+			if (next->slots[index] != NO_ENTRY && entry->compare(next->entries[next->slots[index]]) == 0) {
+				slots[index] = IN_BASELINE;
+			}
+			else {
+				slots[index] = entries.size();
+				entries.push_back(*entry);
+			}
+		}
+		store.slots.swap(slots);
+		store.entries.swap(entries);
+		store.baseline = next;
+	}
+	current = next;
+	return next->entries.size();
+}
+
+uint32_t KnowledgeStore::getBaselineVersion() {
+	ns3::Ptr<const Baseline> & current = getCurrentBaseline();
+	return current == 0 ? 0 : current->version;
+}
+
+size_t KnowledgeStore::getBaselineMemoryUsage() {
+	ns3::Ptr<const Baseline> & current = getCurrentBaseline();
+	if (current == 0) {
+		return 0;
+	}
+	return sizeof(Baseline) + current->slots.capacity() * sizeof(uint32_t) + current->entries.capacity() * sizeof(RecordEntry);
+}
+
+} /* namespace ovnis */
@@ -0,0 +1,120 @@
+/*
+ * knowledgeStore.h
+ *
+ *  Travel times heard by a vehicle, per edge.
+ */
+
+#ifndef KNOWLEDGESTORE_H_
+#define KNOWLEDGESTORE_H_
+
+#include <cstdlib>
+#include <deque>
+#include <vector>
+#include <set>
+#include <stdint.h>
+
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include "recordEntry.h"
+#include "stringInterner.h"
+
+namespace ovnis {
+
+/**
+ * The RecordEntry of each edge a vehicle has heard about.
+ *
+ * Edges are numbered densely, in the order they are first recorded by any store, and
+ * a store holds an array indexed by that number: a lookup is two array reads instead
+ * of a walk down a tree, and a store only grows by the 4 bytes of a slot for the edges
+ * it has no record about. Entries are allocated at the first record about their edge,
+ * in a deque so that the references given out stay valid.
+ *
+ * The vehicles mostly hear the same broadcasts and hold the same entries. The stores
+ * that share() take part in compact(), which copies the entries held by enough of
+ * them into a new immutable baseline: a store then only keeps its own copy of the
+ * entries that differ from the baseline, and refers to the baseline for the others.
+ * An entry of the baseline is copied into the store before it is modified, by the
+ * non-const find() and operator[], so that what a store holds never depends on the
+ * others. Reading through a const store does not copy.
+ *
+ * getEdges() lists the edges that have an entry by increasing handle, the order in
+ * which a map keyed by handle was walked.
+ */
+class KnowledgeStore {
+public:
+	KnowledgeStore();
+	KnowledgeStore(const KnowledgeStore & other);
+	KnowledgeStore & operator =(const KnowledgeStore & other);
+	~KnowledgeStore();
+
+	/**
+	 * @return the entry of edge, null when nothing was recorded about it.
+	 */
+	RecordEntry * find(StringId edge);
+	const RecordEntry * find(StringId edge) const;
+	/**
+	 * @return the entry of edge, allocated if needed.
+	 */
+	RecordEntry & operator[](StringId edge);
+
+	const std::vector<StringId> & getEdges() const;
+	size_t size() const;
+	bool empty() const;
+	void clear();
+	/**
+	 * @return the approximate number of bytes used by the store, the baseline
+	 * it refers to excluded.
+	 */
+	size_t getMemoryUsage() const;
+
+	/**
+	 * Makes the store take part in compact(), until it is destroyed. A copy of
+	 * the store takes part as well.
+	 */
+	void share();
+	/**
+	 * Replaces the baseline with the entries held, in the same state, by at least
+	 * minimumShare of the sharing stores, and drops the copies the stores have of
+	 * them. Pointers to the entries of the sharing stores are invalidated.
+	 *
+	 * @return the number of entries of the new baseline.
+	 */
+	static size_t compact(double minimumShare);
+	/**
+	 * @return the number of baselines made by compact().
+	 */
+	static uint32_t getBaselineVersion();
+	static size_t getBaselineMemoryUsage();
+
+private:
+	struct Baseline : public ns3::SimpleRefCount<Baseline> {
+		uint32_t version;
+		std::vector<uint32_t> slots; // entry of each edge number, NO_ENTRY if none
+		std::vector<RecordEntry> entries;
+	};
+
+	/**
+	 * @return the dense number of edge, NO_EDGE_INDEX if it was never recorded
+	 * and add is false.
+	 */
+	static uint32_t getEdgeIndex(StringId edge, bool add);
+	static uint32_t getNumberOfEdges();
+	static ns3::Ptr<const Baseline> & getCurrentBaseline();
+	static std::set<KnowledgeStore *> & getSharingStores();
+
+	const RecordEntry * findByIndex(uint32_t index) const;
+
+	static const uint32_t NO_EDGE_INDEX = 0xffffffff;
+	static const uint32_t NO_ENTRY = 0xffffffff;
+	static const uint32_t IN_BASELINE = 0xfffffffe;
+
+	ns3::Ptr<const Baseline> baseline;
+	std::vector<uint32_t> slots; // entry of each edge number, NO_ENTRY if none, IN_BASELINE if that of the baseline
+	std::deque<RecordEntry> entries;
+	std::vector<StringId> edges; // edges of the entries, sorted
+	bool sharing;
+};
+
+} /* namespace ovnis */
+
+#endif /* KNOWLEDGESTORE_H_ */
@@ -41,7 +41,10 @@
 #define RX_GAIN 0
 #define ENERGY_DETECTION_THRESHOLD -96.0
 #define CCA_MODEL_THRESHOLD -99
-#define PROPAGATION_LOSS_MODEL "ns3::NakagamiPropagationLossModel"
+#define INTERFERENCE_CUTOFF -110.0 // dBm, signals below are not delivered by the ovnis channel
+#define PHY_TYPE "ns3::OvnisWifiPhy" // "ns3::OvnisLinkWifiPhy" for link level reception
+#define PROPAGATION_LOSS_MODEL "ns3::OvnisNakagamiPropagationLossModel" // pooled version of "ns3::NakagamiPropagationLossModel"
+#define OBSTACLE_LOSS_MODEL "ns3::OvnisObstacleShadowingLossModel"
 #define PROPAGATION_DELAY_MODEL "ns3::ConstantSpeedPropagationDelayModel"
 #define WIFI_PHY_STANDARD WIFI_PHY_STANDARD_80211_10MHZ
 #define PHY_MODE "OfdmRate6MbpsBW10MHz"
@@ -49,6 +52,7 @@
 #define MAC_TYPE "ns3::BeaconingAdhocWifiMac"
 #define BASE_NETWORK_ADDRESS "10.0.0.0"
 #define NETWORK_MASK "255.0.0.0"
+#define OVNIS_PROTOCOL_NUMBER 0x88DC // LLC/SNAP type of the broadcasts sent without the internet stack (the WSMP one)
 
 // APLICATION PARAMETERS
 
@@ -70,6 +74,9 @@
 #define CHANGED_EDGE_PACKET_ID 7
 
 #define LOCAL_MEMORY_SIZE 10
+#define KNOWLEDGE_COMPACTION_INTERVAL 60 // s between two compactions of the knowledge shared by the vehicles
+#define KNOWLEDGE_BASELINE_SHARE 0.5 // share of the vehicles that must hold a record, unchanged, for it to enter the shared baseline
+#define ROUTING_CUSTOMIZATION_INTERVAL 1 // s between two customizations of the routing engine with the travel times reported to the TIS
 
 #define BROADCASTING_DISTANCE_THRESHOLD 60
 #define RESEND_INTERVAL 1
@@ -35,6 +35,7 @@
 #include "ns3/nqos-wifi-mac-helper.h"
 #include "ns3/yans-wifi-helper.h"
 #include "ns3/internet-stack-helper.h"
+#include "ns3/packet-socket-helper.h"
 #include "ns3/wifi-phy.h"
 #include "ns3/wifi-net-device.h"
 #include "ns3/mobility-helper.h"
@@ -54,8 +55,10 @@
 #include "helper/ovnis-wifi-helper.h"
 #include "devices/wifi/ovnis-adhoc-wifi-mac.h"
 #include "devices/wifi/beaconing-adhoc-wifi-mac.h"
+#include "devices/wifi/ovnis-dcc.h"
 #include "ovnis.h"
 #include "ovnis-constants.h"
+#include "knowledgeStore.h"
 #include "log.h"
 
 using namespace std;
@@ -81,8 +84,12 @@ ns3::TypeId Ovnis::GetTypeId(void) {
 	return tid;
 }
 
+Ovnis::Config::Config() :
+		phyType(PHY_TYPE), internetStack(true), dcc(false), hasPenetrationRate(false), penetrationRate(1) {
+}
+
 Ovnis::Ovnis() :
-		runningVehicles(vector<string>()), departedVehicles(vector<string>()), arrivedVehicles(vector<string>()) {
+		runningVehicles(vector<StringId>()), departedVehicles(vector<StringId>()), arrivedVehicles(vector<StringId>()) {
 }
 
 Ovnis::~Ovnis() {
@@ -94,11 +101,33 @@ Ovnis::~Ovnis() {
 	}
 }
 
-void Ovnis::SetOvnisParams(std::map <string,string> params) {
-	_params = params;
+void Ovnis::SetOvnisParams(const std::map <string,string> & params) {
+	config = Config();
+	map<string, string>::const_iterator it = params.find("outputFolder");
+	if (it != params.end()) {
+		config.outputFolder = it->second;
+	}
+	it = params.find("phyType");
+	if (it != params.end()) {
+		config.phyType = it->second;
+	}
+	it = params.find("shapesFile");
+	if (it != params.end()) {
+		config.shapesFile = it->second;
+	}
+	it = params.find("internetStack");
+	config.internetStack = it == params.end() || it->second != "false";
+	it = params.find("dcc");
+	config.dcc = it != params.end() && it->second == "true";
+	it = params.find("penedtrationRate");
+	if (it != params.end()) {
+		config.hasPenetrationRate = true;
+		config.penetrationRate = atof((it->second).c_str());
+		cout << "Penetration rate is set: " << config.penetrationRate << endl;
+	}
 }
 
-void Ovnis::SetApplicationParams(std::map <string,string> params) {
+void Ovnis::SetApplicationParams(const std::map <string,string> & params) {
 	_applicationParams = params;
 }
 
@@ -118,10 +147,9 @@ void Ovnis::DoInitialize(void) {
     Names::Add("Ovnis", this);
 
     Log::getInstance().setOutputFolder(scenarioFolder + "ovnisOutput");
-    map<string, string>::iterator it = _params.find("outputFolder");
-    if (it != _params.end()) {
-    	cout << "Setting output folder " << it->second << endl;
-    	Log::getInstance().setOutputFolder(it->second);
+    if (!config.outputFolder.empty()) {
+    	cout << "Setting output folder " << config.outputFolder << endl;
+    	Log::getInstance().setOutputFolder(config.outputFolder);
     }
 
     try {
@@ -202,6 +230,7 @@ void Ovnis::InitializeDefaultNetwork() {
 void Ovnis::InitializeOvnisNetwork() {
 	if (is80211p) {
 		ovnisPhyHelper = OvnisWifiPhyHelper::Default();
+		ovnisPhyHelper.SetPhyType(config.phyType);
 		ovnisPhyHelper.Set("TxPowerStart",DoubleValue(TX_POWER_START));
 		ovnisPhyHelper.Set("TxPowerEnd",DoubleValue(TX_POWER_END));
 		ovnisPhyHelper.Set("TxPowerLevels",UintegerValue(TX_POWER_LEVELS));
@@ -212,8 +241,13 @@ void Ovnis::InitializeOvnisNetwork() {
 
 		OvnisWifiChannelHelper ovnisChannelHelper = OvnisWifiChannelHelper::Default ();
 		ovnisChannelHelper.AddPropagationLoss(PROPAGATION_LOSS_MODEL);
+		// buildings of the scenario, eg. "shapesFile=Kirchberg.shapes.xml"
+		if (!config.shapesFile.empty()) {
+			ovnisChannelHelper.AddPropagationLoss(OBSTACLE_LOSS_MODEL, "ShapesFile", StringValue(scenarioFolder + config.shapesFile));
+		}
 		ovnisChannelHelper.SetPropagationDelay(PROPAGATION_DELAY_MODEL);
 		ovnisChannel = ovnisChannelHelper.Create();
+		ovnisChannel->SetAttribute("InterferenceCutoff", DoubleValue(INTERFERENCE_CUTOFF));
 		ovnisChannel->updateArea(boundaries[0], boundaries[1], communicationRange);
 		ovnisPhyHelper.SetChannel(ovnisChannel);
 
@@ -234,19 +268,37 @@ void Ovnis::CreateNetworkDevices(ns3::NodeContainer & node_container) {
 	else {
 		devices = wifi.Install(phyHelper, mac, node_container);
 	}
-	InternetStackHelper stack;
-	stack.Install(node_container);
-	Ipv4InterfaceContainer wifiInterfaces;
-	wifiInterfaces = address.Assign(devices);
+	// single hop applications do not need IP, eg. "internetStack=false"
+	if (config.internetStack) {
+		InternetStackHelper stack;
+		stack.Install(node_container);
+		Ipv4InterfaceContainer wifiInterfaces;
+		wifiInterfaces = address.Assign(devices);
+	}
+	else {
+		PacketSocketHelper packetSocket;
+		packetSocket.Install(node_container);
+	}
+	// congestion control of the beacons and applications, eg. "dcc=true"
+	if (config.dcc) {
+		for (NetDeviceContainer::Iterator d = devices.Begin(); d != devices.End(); ++d) {
+			Ptr<WifiNetDevice> wd = DynamicCast<WifiNetDevice>(*d);
+			if (wd != 0) {
+				Ptr<OvnisDcc> dcc = CreateObject<OvnisDcc>();
+				dcc->SetAttribute("BaseAppInterval", TimeValue(Seconds(NEIGHBOR_INFORMATION_SENDING_INTERVAL)));
+				dcc->Install(wd);
+			}
+		}
+	}
 }
 
-void Ovnis::DestroyNetworkDevices(vector<string> to_destroy) {
-	for (vector<string>::iterator i = to_destroy.begin(); i != to_destroy.end(); ++i) {
-		Ptr<Node> n = Names::Find<Node>((*i));
+void Ovnis::DestroyNetworkDevices(const vector<StringId> & to_destroy) {
+	for (vector<StringId>::const_iterator i = to_destroy.begin(); i != to_destroy.end(); ++i) {
+		Ptr<Node> n = Names::Find<Node>(lookup(*i));
 		if (n != 0) {
 			double now = Simulator::Now().GetSeconds();
 			Ptr<Ipv4> ipv4 = n->GetObject<Ipv4>();
-			for (uint32_t j = 0; j < n->GetNDevices(); ++j) {
+			for (uint32_t j = 0; ipv4 != 0 && j < n->GetNDevices(); ++j) {
 				int32_t ifIndex = ipv4->GetInterfaceForDevice(n->GetDevice(j));
 				Ipv4InterfaceAddress address = ipv4->GetAddress(ifIndex, 0);
 				ipv4->RemoveAddress(ifIndex, 0);
@@ -258,7 +310,7 @@ void Ovnis::DestroyNetworkDevices(vector<string> to_destroy) {
 					Ptr<Application> app = n->GetApplication(j);
 					try {
 						Ptr<OvnisApplication> ovnisApp = DynamicCast<OvnisApplication>(app);
-						for (vector<string>::iterator k = connectedVehicles.begin(); k < connectedVehicles.end(); ++k) {
+						for (vector<StringId>::iterator k = connectedVehicles.begin(); k < connectedVehicles.end(); ++k) {
 							if (*i == *k) {
 //								cout << "stopping connected app" << endl;
 								ovnisApp->SetStopTime(stopTime);
@@ -281,6 +333,10 @@ void Ovnis::DestroyNetworkDevices(vector<string> to_destroy) {
 				Ptr<WifiMac> wm = wd->GetMac();
 				Ptr<BeaconingAdhocWifiMac> bwm = DynamicCast<BeaconingAdhocWifiMac>(wm);
 				bwm->StopBeaconing();
+				Ptr<OvnisDcc> dcc = n->GetObject<OvnisDcc>();
+				if (dcc != 0) {
+					dcc->Stop();
+				}
 				ovnisChannel->Remove(ywp);
 			}
 		}
@@ -290,9 +346,9 @@ void Ovnis::DestroyNetworkDevices(vector<string> to_destroy) {
 void Ovnis::UpdateInOutVehicles() {
 	NS_LOG_FUNCTION_NOARGS();
 	// remove the eventually removed vehicles while added in the inserted list (especially a the beginning)
-	vector<string>::iterator i = arrivedVehicles.begin();
+	vector<StringId>::iterator i = arrivedVehicles.begin();
 	while (i != arrivedVehicles.end()) {
-		vector<string>::iterator it;
+		vector<StringId>::iterator it;
 		it = std::find(departedVehicles.begin(), departedVehicles.end(), (*i));
 		if (it != departedVehicles.end()) {
 			departedVehicles.erase(it);
@@ -307,8 +363,8 @@ void Ovnis::UpdateInOutVehicles() {
 	NodeContainer node_container;
 	node_container.Create(departedVehicles.size());
 	int j = 0;
-	for (vector<string>::iterator i = departedVehicles.begin(); i != departedVehicles.end(); ++i) {
-		Names::Add("Nodes", (*i), node_container.Get(j));
+	for (vector<StringId>::iterator i = departedVehicles.begin(); i != departedVehicles.end(); ++i) {
+		Names::Add("Nodes", lookup(*i), node_container.Get(j));
 		++j;
 	}
 	MobilityHelper mobility;
@@ -322,8 +378,8 @@ void Ovnis::UpdateInOutVehicles() {
 	DestroyNetworkDevices(arrivedVehicles);
 
 	// -------- update the set of running vehicles
-	for (std::vector<std::string>::iterator i = arrivedVehicles.begin(); i != arrivedVehicles.end(); ++i) {
-		vector<string>::iterator it;
+	for (std::vector<StringId>::iterator i = arrivedVehicles.begin(); i != arrivedVehicles.end(); ++i) {
+		vector<StringId>::iterator it;
 		it = std::find(runningVehicles.begin(), runningVehicles.end(), (*i));
 		if (it != runningVehicles.end()) {
 			runningVehicles.erase(it);
@@ -336,15 +392,12 @@ void Ovnis::UpdateInOutVehicles() {
 
 void Ovnis::StartApplications() {
 	newConnectedVehiclesCount = 0;
-	for (vector<string>::iterator i = departedVehicles.begin(); i != departedVehicles.end(); ++i) {
-		Ptr<Node> node = Names::Find<Node>((*i));
+	for (vector<StringId>::iterator i = departedVehicles.begin(); i != departedVehicles.end(); ++i) {
+		Ptr<Node> node = Names::Find<Node>(lookup(*i));
 		bool isVANET = true;
-		map<string,string>::iterator it = _params.find("penedtrationRate");
-		if (it != _params.end()) {
+		if (config.hasPenetrationRate) {
 			double r = (double)(rand()%RAND_MAX)/(double)RAND_MAX;
-			double penetrationRate = atof((it->second).c_str());
-			cout << "Penetration rate is set: " << penetrationRate << endl;
-			isVANET = penetrationRate > 0 && r <= penetrationRate;
+			isVANET = config.penetrationRate > 0 && r <= config.penetrationRate;
 		}
 		if (node!=0 && isOvnisChannel && isVANET) {
 			connectedVehicles.insert(connectedVehicles.end(), i, i+1);
@@ -366,16 +419,17 @@ void Ovnis::StartApplications() {
 
 void Ovnis::UpdateVehiclesPositions() {
 	NS_LOG_FUNCTION_NOARGS();
-	for (vector<string>::iterator i = runningVehicles.begin(); i != runningVehicles.end(); ++i) {
-		Ptr<Node> node = Names::Find<Node>((*i));
+	for (vector<StringId>::iterator i = runningVehicles.begin(); i != runningVehicles.end(); ++i) {
+		const string & vehicleId = lookup(*i);
+		Ptr<Node> node = Names::Find<Node>(vehicleId);
 		if (node!=0) {
 			Ptr<Object> object = node;
 			Ptr<ConstantVelocityMobilityModel> model = object->GetObject<ConstantVelocityMobilityModel>();
-			ovnis::Position2D newPos = traci->GetVehiclePosition(*i);
+			ovnis::Position2D newPos = traci->GetVehiclePosition(vehicleId);
 			if (newPos.x > 0 && newPos.y > 0)
 			{
-				double newSpeed = traci->GetVehicleSpeed((*i));
-				double newAngle = traci->GetVehicleAngle(*i);
+				double newSpeed = traci->GetVehicleSpeed(vehicleId);
+				double newAngle = traci->GetVehicleAngle(vehicleId);
 				Vector velocity(newSpeed * cos((newAngle + 90) * PI / 180.0), newSpeed * sin((newAngle - 90) * PI / 180.0), 0.0);
 				Vector position(newPos.x, newPos.y, 0.0);
 				model->SetPosition(position);
@@ -416,6 +470,10 @@ void Ovnis::TrafficSimulationStep() {
 		// in the first step, departed and arrived vehicles are aggregated from the beginning of running
 		traci->NextSimStep(departedVehicles, arrivedVehicles);
 
+		if (currentTime % (KNOWLEDGE_COMPACTION_INTERVAL*SIMULATION_TIME_UNIT) == 0) {
+			ovnis::KnowledgeStore::compact(KNOWLEDGE_BASELINE_SHARE);
+		}
+
 		if (currentTime < stopTime*SIMULATION_TIME_UNIT) {
 			Simulator::Schedule(Seconds(SIMULATION_STEP_INTERVAL), &Ovnis::TrafficSimulationStep, this);
 		}
@@ -426,6 +484,14 @@ void Ovnis::TrafficSimulationStep() {
 			cout << "Finished! Steps: " << currentTime/1000 << ", Simulation time" << (double)(time(0) - start) << " s. " << endl;
 			Log::getInstance().getStream("simulation") << "stop\t" << stop << endl;
 			Log::getInstance().getStream("simulation") << "duration\t" << (stop-start) << endl;
+			if (isOvnisChannel) {
+				Log::getInstance().getStream("simulation") << "receptions scheduled\t" << ovnisChannel->GetNScheduledReceptions() << endl;
+				Log::getInstance().getStream("simulation") << "receptions culled (below interference cutoff)\t" << ovnisChannel->GetNCulledReceptions() << endl;
+			}
+			Log::getInstance().getStream("simulation") << "interned ids\t" << StringInterner::getInstance().size() << endl;
+			Log::getInstance().getStream("simulation") << "interned ids memory (bytes)\t" << StringInterner::getInstance().getMemoryUsage() << endl;
+			Log::getInstance().getStream("simulation") << "knowledge baselines\t" << ovnis::KnowledgeStore::getBaselineVersion() << endl;
+			Log::getInstance().getStream("simulation") << "knowledge baseline memory (bytes)\t" << ovnis::KnowledgeStore::getBaselineMemoryUsage() << endl;
 			Log::getInstance().getStream("simulation") << "needed probabilistic (congestion detected)\t" << Log::getInstance().needProbabilistic << endl;
 			Log::getInstance().getStream("simulation") << "could cheat (the sugegsted trip != the shortest)\t" << Log::getInstance().cheaters << endl;
 			Log::getInstance().getStream("simulation") << "cheaters (actually cheatet)\t" << Log::getInstance().cheaters << endl;
@@ -59,8 +59,11 @@ namespace ns3
 	  static TypeId GetTypeId(void);
 	  Ovnis();
 	  virtual ~Ovnis();
-	  void SetApplicationParams(std::map <string,string> params);
-	  void SetOvnisParams(std::map <string,string> params);
+	  void SetApplicationParams(const std::map <string,string> & params);
+	  /**
+	   * Parses the optional ovnis params, see Config.
+	   */
+	  void SetOvnisParams(const std::map <string,string> & params);
 
   protected:
     virtual void DoDispose(void);
@@ -69,7 +72,7 @@ namespace ns3
     void InitializeOvnisNetwork();
     void InitializeDefaultNetwork();
     void CreateNetworkDevices(NodeContainer & node_container);
-    void DestroyNetworkDevices(std::vector<std::string> to_destroy);
+    void DestroyNetworkDevices(const std::vector<ovnis::StringId> & to_destroy);
     void DestroyNetworkDevices(NodeContainer node_container);
     void TrafficSimulationStep();
     void UpdateInOutVehicles();
@@ -145,9 +148,20 @@ namespace ns3
     double communicationRange;
 
     /**
-     * Optional ovnis params
+     * Optional ovnis params, parsed once by SetOvnisParams
      */
-    std::map <string,string> _params;
+    struct Config {
+    	Config();
+
+    	std::string outputFolder; // "outputFolder", empty for the output folder of the scenario
+    	std::string phyType; // "phyType"
+    	std::string shapesFile; // "shapesFile", buildings of the scenario, eg. "Kirchberg.shapes.xml"
+    	bool internetStack; // "internetStack", false for single hop applications
+    	bool dcc; // "dcc", congestion control of the beacons and applications
+    	bool hasPenetrationRate;
+    	double penetrationRate; // "penedtrationRate", share of the vehicles running the application
+    };
+    Config config;
 
     /**
      * Application parameters
@@ -155,10 +169,10 @@ namespace ns3
     std::map <string,string> _applicationParams;
 
     Ptr<ovnis::SumoTraciConnection> traci;
-    std::vector<std::string> runningVehicles;
-    std::vector<std::string> connectedVehicles;
-    std::vector<std::string> departedVehicles;
-    std::vector<std::string> arrivedVehicles;
+    std::vector<ovnis::StringId> runningVehicles;
+    std::vector<ovnis::StringId> connectedVehicles;
+    std::vector<ovnis::StringId> departedVehicles;
+    std::vector<ovnis::StringId> arrivedVehicles;
     int newConnectedVehiclesCount;
     double boundaries[2];
     bool is80211p;
@@ -160,7 +160,7 @@ OvnisPacket::~OvnisPacket() {
 		int senderIdSize = senderId.size();
 		int dataRecordSize = numberOfRecords * (2 * sizeof (double) + sizeof(int));
 		for (int i = 0; i < numberOfRecords; ++i) {
-			dataRecordSize +=  records[i].edgeId.size() * sizeof (char);
+			dataRecordSize +=  lookup(records[i].edgeId).size() * sizeof (char);
 		}
 		int headerSize = sizeof (int) + sizeof (double) + sizeof (double) + sizeof (double) + sizeof (int) + senderIdSize * sizeof (char) + sizeof (int);
 		int messageSize = sizeof (int) + dataRecordSize;
@@ -179,9 +179,10 @@ OvnisPacket::~OvnisPacket() {
 			// write message
 			tg.WriteU32(numberOfRecords);
 			for (int i = 0; i < numberOfRecords; ++i) {
-				int edgeIdSize = records[i].edgeId.size();
+				const string & edgeId = lookup(records[i].edgeId);
+				int edgeIdSize = edgeId.size();
 				tg.WriteU32(edgeIdSize);
-				tg.Write((uint8_t*) records[i].edgeId.c_str(), edgeIdSize);
+				tg.Write((uint8_t*) edgeId.c_str(), edgeIdSize);
 				tg.WriteDouble(records[i].travelTime);
 				tg.WriteDouble(records[i].date);
 			}
@@ -200,7 +201,7 @@ OvnisPacket::~OvnisPacket() {
 		int numberOfRecords = tg.ReadU32();
 		for (int i = 0; i < numberOfRecords; ++i) {
 			Data record;
-			record.edgeId = readString();
+			record.edgeId = intern(readString());
 			record.travelTime = tg.ReadDouble();
 			record.date = tg.ReadDouble();
 			records.push_back(record);
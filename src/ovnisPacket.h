@@ -13,12 +13,13 @@
 #include "ns3/packet.h"
 #include "traci/structs.h"
 #include "ovnis-constants.h"
+#include "stringInterner.h"
 #include "test/my-constants.h"
 
 namespace ovnis {
 
 typedef struct data {
-	std::string edgeId;
+	StringId edgeId;
 	double travelTime;
 	double date;
 } Data;
@@ -6,6 +6,7 @@
  */
 
 #include <cstdlib>
+#include <cstring>
 #include <string>
 #include <stdint.h>
 #include <cstdlib>
@@ -30,43 +31,80 @@ RecordEntry::RecordEntry() {
 
 void RecordEntry::reset() {
 	for (int i = 0; i < LOCAL_MEMORY_SIZE; ++i) {
-		senders[i] = "";
-		times[i] = 0;
-		values[i] = 0;
+		records[i].sender = NO_STRING_ID;
+		records[i].time = 0;
+		records[i].value = 0;
+		records[i].packetId = 0;
 	}
 	count = 0;
+	expectedValue = 0;
+	actualCapacity = 0;
+}
+
+double RecordEntry::toStoredTime(double time) {
+	return (float) time;
 }
 
 void RecordEntry::add(long packetId, string senderId, double time, double value) {
-	times[count%LOCAL_MEMORY_SIZE] = time;
+	add(packetId, intern(senderId), time, value);
+}
+
+void RecordEntry::add(long packetId, StringId senderId, double time, double value) {
+	Record & record = records[count%LOCAL_MEMORY_SIZE];
 	if (value == -1) {
-		value = values[(count-1)%LOCAL_MEMORY_SIZE];
+		value = getLatest().value;
 	}
-	values[count%LOCAL_MEMORY_SIZE] = value;
-	senders[count%LOCAL_MEMORY_SIZE] = senderId;
-	packetIds[count%LOCAL_MEMORY_SIZE] = packetId;
+	record.time = time;
+	record.value = value;
+	record.sender = senderId;
+	record.packetId = packetId;
 	if (time > 0) {
 		++count;
 	}
 }
 
-void RecordEntry::printValues() {
+int RecordEntry::compare(const RecordEntry & other) const {
+	if (this == &other) {
+		return 0;
+	}
+	int records = memcmp(this->records, other.records, sizeof(this->records));
+	if (records != 0) {
+		return records;
+	}
+	// only the position in the ring matters, not how many records went through it
+	if (count%LOCAL_MEMORY_SIZE != other.count%LOCAL_MEMORY_SIZE) {
+		return count%LOCAL_MEMORY_SIZE < other.count%LOCAL_MEMORY_SIZE ? -1 : 1;
+	}
+	if (expectedValue != other.expectedValue) {
+		return expectedValue < other.expectedValue ? -1 : 1;
+	}
+	if (actualCapacity != other.actualCapacity) {
+		return actualCapacity < other.actualCapacity ? -1 : 1;
+	}
+	return 0;
+}
+
+const RecordEntry::Record & RecordEntry::getLatest() const {
+	return records[(count+LOCAL_MEMORY_SIZE-1)%LOCAL_MEMORY_SIZE];
+}
+
+void RecordEntry::printValues() const {
 	cout << "[";
 	for (int i = 0; i < LOCAL_MEMORY_SIZE; ++i) {
-		cout << times[i] << "," << values[i] << "," << senders[i] << " ";
+		cout << records[i].time << "," << records[i].value << "," << lookup(records[i].sender) << " ";
 	}
 	cout << "]";
 }
 
-double RecordEntry::getLatestValue() {
-	return values[(count-1+LOCAL_MEMORY_SIZE)%LOCAL_MEMORY_SIZE];
+double RecordEntry::getLatestValue() const {
+	return getLatest().value;
 }
 
-double RecordEntry::getExpectedValue() {
+double RecordEntry::getExpectedValue() const {
 	return expectedValue;
 }
 
-double RecordEntry::getActualCapacity() {
+double RecordEntry::getActualCapacity() const {
 	return actualCapacity;
 }
 
@@ -76,40 +114,44 @@ double RecordEntry::setCapacity(double expectedValue) {
 	return actualCapacity;
 }
 
-double RecordEntry::getAverageValue() {
+double RecordEntry::getAverageValue() const {
 	double sum = 0;
 	int num = 0;
 	for (int i = 0; i < LOCAL_MEMORY_SIZE; ++i) {
-		if (values[i] != 0) {
-			sum += values[i];
+		if (records[i].value != 0) {
+			sum += records[i].value;
 			++num;
 		}
 	}
 	return sum/num;
 }
 
-double RecordEntry::getAverageTime() {
+double RecordEntry::getAverageTime() const {
 	double sum = 0;
 	int num = 0;
 	for (int i = 0; i < LOCAL_MEMORY_SIZE; ++i) {
-		if (values[i] != 0) {
-			sum += times[i];
+		if (records[i].value != 0) {
+			sum += records[i].time;
 			++num;
 		}
 	}
 	return sum/num;
 }
 
-double RecordEntry::getLatestTime() {
-	return times[(count-1+LOCAL_MEMORY_SIZE)%LOCAL_MEMORY_SIZE];
+double RecordEntry::getLatestTime() const {
+	return getLatest().time;
+}
+
+string RecordEntry::getLatestSenderId() const {
+	return lookup(getLatestSender());
 }
 
-string RecordEntry::getLatestSenderId() {
-	return senders[(count-1+LOCAL_MEMORY_SIZE)%LOCAL_MEMORY_SIZE];
+StringId RecordEntry::getLatestSender() const {
+	return getLatest().sender;
 }
 
-long RecordEntry::getLatestPacketId() {
-	return packetIds[(count-1+LOCAL_MEMORY_SIZE)%LOCAL_MEMORY_SIZE];
+long RecordEntry::getLatestPacketId() const {
+	return getLatest().packetId;
 }
 
 //double RecordEntry::computeAverageValue() {
@@ -21,35 +21,62 @@
 
 #include "ns3/ptr.h"
 #include "ovnis-constants.h"
+#include "stringInterner.h"
 
 
 namespace ovnis {
 
+/**
+ * The last LOCAL_MEMORY_SIZE travel times heard about an edge, in a ring.
+ *
+ * Each record is packed in 16 bytes: times are float seconds of the ns-3 clock,
+ * which starts with the simulation (under 1/100 s of error over a day), values are
+ * float seconds and senders are interned. An entry is allocated by a KnowledgeStore
+ * at the first record about its edge.
+ */
 class RecordEntry {
 public:
+	struct Record {
+		float time;
+		float value;
+		StringId sender;
+		uint32_t packetId;
+	};
+
 	RecordEntry();
-	virtual ~RecordEntry();
+	~RecordEntry();
+	void add(long packetId, StringId senderId, double time, double value);
 	void add(long packetId, std::string senderId, double time, double value);
-	void printValues();
+	void printValues() const;
 //	double computeAverageValue();
-	double getLatestValue();
-	double getLatestTime();
-	double getAverageValue();
-	double getAverageTime();
+	double getLatestValue() const;
+	double getLatestTime() const;
+	double getAverageValue() const;
+	double getAverageTime() const;
 	double setCapacity(double expectedValue);
-	double getActualCapacity();
-	double getExpectedValue();
-	std::string getLatestSenderId();
-	long getLatestPacketId();
+	double getActualCapacity() const;
+	double getExpectedValue() const;
+	std::string getLatestSenderId() const;
+	StringId getLatestSender() const;
+	long getLatestPacketId() const;
 	void reset();
 
+	/**
+	 * @return time as it is stored, to compare a date to getLatestTime().
+	 */
+	static double toStoredTime(double time);
+	/**
+	 * Orders the entries by state.
+	 *
+	 * @return 0 when both entries hold the same records and will behave the same.
+	 */
+	int compare(const RecordEntry & other) const;
+
 private:
-	std::string id;
-	int count;
-	double times[LOCAL_MEMORY_SIZE];
-	double values[LOCAL_MEMORY_SIZE];
-	std::string senders[LOCAL_MEMORY_SIZE];
-	long packetIds[LOCAL_MEMORY_SIZE];
+	const Record & getLatest() const;
+
+	Record records[LOCAL_MEMORY_SIZE];
+	uint32_t count;
 	double expectedValue;
 	double actualCapacity;
 };
@@ -0,0 +1,149 @@
+/*
+ * roadGraph.cpp
+ *
+ *  Junctions and edges of the SUMO network.
+ */
+
+#include "roadGraph.h"
+#include "ns3/assert.h"
+
+using namespace std;
+
+namespace ovnis {
+
+const uint32_t RoadGraph::NOT_FOUND;
+
+RoadGraph::RoadGraph() : located(0) {
+}
+
+RoadGraph::~RoadGraph() {
+}
+
+uint32_t RoadGraph::addJunction(StringId junction) {
+	map<StringId, uint32_t>::iterator it = junctionNumbers.find(junction);
+	if (it != junctionNumbers.end()) {
+		return it->second;
+	}
+	uint32_t number = junctions.size();
+	Junction added;
+	added.id = junction;
+	added.x = 0;
+	added.y = 0;
+	added.located = false;
+	junctions.push_back(added);
+	junctionNumbers[junction] = number;
+	return number;
+}
+
+uint32_t RoadGraph::addJunction(StringId junction, double x, double y) {
+	uint32_t number = addJunction(junction);
+	Junction & added = junctions[number];
+	if (!added.located) {
+		added.located = true;
+		++located;
+	}
+	added.x = x;
+	added.y = y;
+	return number;
+}
+
+uint32_t RoadGraph::addEdge(StringId edge, StringId from, StringId to) {
+	map<StringId, uint32_t>::iterator it = edgeNumbers.find(edge);
+	if (it != edgeNumbers.end()) {
+		return it->second;
+	}
+	uint32_t number = edges.size();
+	Edge added;
+	added.id = edge;
+	added.from = addJunction(from);
+	added.to = addJunction(to);
+	added.length = 0;
+	added.maxSpeed = 0;
+	edges.push_back(added);
+	edgeNumbers[edge] = number;
+	junctions[added.from].outEdges.push_back(number);
+	return number;
+}
+
+void RoadGraph::addLane(uint32_t edge, double length, double maxSpeed) {
+	NS_ASSERT(edge < edges.size());
+	Edge & lane = edges[edge];
+	if (length > lane.length) {
+		lane.length = length;
+	}
+	if (maxSpeed > lane.maxSpeed) {
+		lane.maxSpeed = maxSpeed;
+	}
+}
+
+uint32_t RoadGraph::getNumberOfJunctions() const {
+	return junctions.size();
+}
+
+uint32_t RoadGraph::getNumberOfEdges() const {
+	return edges.size();
+}
+
+uint32_t RoadGraph::getJunction(StringId junction) const {
+	map<StringId, uint32_t>::const_iterator it = junctionNumbers.find(junction);
+	return it == junctionNumbers.end() ? NOT_FOUND : it->second;
+}
+
+uint32_t RoadGraph::getEdge(StringId edge) const {
+	map<StringId, uint32_t>::const_iterator it = edgeNumbers.find(edge);
+	return it == edgeNumbers.end() ? NOT_FOUND : it->second;
+}
+
+StringId RoadGraph::getJunctionId(uint32_t junction) const {
+	return junctions[junction].id;
+}
+
+StringId RoadGraph::getEdgeId(uint32_t edge) const {
+	return edges[edge].id;
+}
+
+bool RoadGraph::isLocated() const {
+	return located == junctions.size();
+}
+
+double RoadGraph::getX(uint32_t junction) const {
+	return junctions[junction].x;
+}
+
+double RoadGraph::getY(uint32_t junction) const {
+	return junctions[junction].y;
+}
+
+uint32_t RoadGraph::getFrom(uint32_t edge) const {
+	return edges[edge].from;
+}
+
+uint32_t RoadGraph::getTo(uint32_t edge) const {
+	return edges[edge].to;
+}
+
+double RoadGraph::getLength(uint32_t edge) const {
+	return edges[edge].length;
+}
+
+double RoadGraph::getMaxSpeed(uint32_t edge) const {
+	return edges[edge].maxSpeed;
+}
+
+double RoadGraph::getStaticCost(uint32_t edge) const {
+	const Edge & e = edges[edge];
+	return e.maxSpeed > 0 ? e.length / e.maxSpeed : e.length;
+}
+
+void RoadGraph::getStaticCosts(vector<double> & costs) const {
+	costs.resize(edges.size());
+	for (uint32_t edge = 0; edge < edges.size(); ++edge) {
+		costs[edge] = getStaticCost(edge);
+	}
+}
+
+const vector<uint32_t> & RoadGraph::getOutEdges(uint32_t junction) const {
+	return junctions[junction].outEdges;
+}
+
+} /* namespace ovnis */
@@ -0,0 +1,118 @@
+/*
+ * roadGraph.h
+ *
+ *  Junctions and edges of the SUMO network.
+ */
+
+#ifndef ROADGRAPH_H_
+#define ROADGRAPH_H_
+
+#include <cstdlib>
+#include <vector>
+#include <map>
+#include <stdint.h>
+
+#include "stringInterner.h"
+
+namespace ovnis {
+
+/**
+ * Static graph of the network read from the SUMO net file: the junctions are the
+ * nodes and the edges go from a junction to another.
+ *
+ * Junctions and edges are numbered densely in the order they are added, and the
+ * routing works on those numbers; the handles of their ids are only looked up where
+ * a route is given to or read from SUMO. A junction is added by the first edge that
+ * goes from or to it, its position being set when the junction itself is read.
+ *
+ * The length of an edge is that of its longest lane and its maximum speed that of its
+ * fastest lane, so that its static cost is the time to drive it at the maximum speed,
+ * as by TIS::getEdgeStaticCost().
+ */
+class RoadGraph {
+public:
+	static const uint32_t NOT_FOUND = 0xffffffff;
+
+	RoadGraph();
+	~RoadGraph();
+
+	/**
+	 * Sets the position of junction, adding it if needed.
+	 *
+	 * @return the number of junction.
+	 */
+	uint32_t addJunction(StringId junction, double x, double y);
+	/**
+	 * Adds edge, without lanes, from the junction from to the junction to, unless it is
+	 * already in the graph.
+	 *
+	 * @return the number of edge.
+	 */
+	uint32_t addEdge(StringId edge, StringId from, StringId to);
+	/**
+	 * Adds a lane to the edge of number edge.
+	 */
+	void addLane(uint32_t edge, double length, double maxSpeed);
+
+	uint32_t getNumberOfJunctions() const;
+	uint32_t getNumberOfEdges() const;
+	/**
+	 * @return the number of junction, NOT_FOUND if it is not in the graph.
+	 */
+	uint32_t getJunction(StringId junction) const;
+	/**
+	 * @return the number of edge, NOT_FOUND if it is not in the graph.
+	 */
+	uint32_t getEdge(StringId edge) const;
+	StringId getJunctionId(uint32_t junction) const;
+	StringId getEdgeId(uint32_t edge) const;
+	/**
+	 * @return whether the position of every junction was set.
+	 */
+	bool isLocated() const;
+	double getX(uint32_t junction) const;
+	double getY(uint32_t junction) const;
+
+	uint32_t getFrom(uint32_t edge) const;
+	uint32_t getTo(uint32_t edge) const;
+	double getLength(uint32_t edge) const;
+	double getMaxSpeed(uint32_t edge) const;
+	double getStaticCost(uint32_t edge) const;
+	/**
+	 * Fills costs with the static cost of each edge, by number.
+	 */
+	void getStaticCosts(std::vector<double> & costs) const;
+	/**
+	 * @return the edges going out of junction.
+	 */
+	const std::vector<uint32_t> & getOutEdges(uint32_t junction) const;
+
+private:
+	struct Junction {
+		StringId id;
+		double x;
+		double y;
+		bool located;
+		std::vector<uint32_t> outEdges;
+	};
+
+	struct Edge {
+		StringId id;
+		uint32_t from;
+		uint32_t to;
+		double length;
+		double maxSpeed;
+	};
+
+	uint32_t addJunction(StringId junction);
+
+	std::vector<Junction> junctions;
+	std::map<StringId, uint32_t> junctionNumbers;
+	uint32_t located;
+	std::vector<Edge> edges;
+	std::map<StringId, uint32_t> edgeNumbers;
+};
+
+} /* namespace ovnis */
+
+#endif /* ROADGRAPH_H_ */
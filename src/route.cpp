@@ -15,11 +15,11 @@ namespace ovnis {
 using namespace std;
 
 Route::Route() :
-	edgeIds(), edgeInfos(), staticCost(0) {
+	edgeIds(), edgeHandles(), edgeInfos(), staticCost(0) {
 }
 
 Route::Route(string id, string strRoute) :
-	id(id), edgeIds(), edgeInfos(), staticCost(0) {
+	id(id), edgeIds(), edgeHandles(), edgeInfos(), staticCost(0) {
 	vector<string> readRoute;
 	if (strRoute.size() > 0) {
 		stringstream ss(strRoute);
@@ -32,15 +32,17 @@ Route::Route(string id, string strRoute) :
 }
 
 Route::Route(string id, vector<string> route) :
-		id(id), edgeIds(), edgeInfos(), staticCost(0) {
+		id(id), edgeIds(), edgeHandles(), edgeInfos(), staticCost(0) {
 	initializeEdges(route);
 }
 
 void Route::initializeEdges(vector<string> routeVector) {
 	this->edgeIds.clear();
+	this->edgeHandles.clear();
 	this->edgeInfos = vector<EdgeInfo>();
 	for (int i = 0; i < routeVector.size(); ++i) {
 		edgeIds.push_back(routeVector[i]);
+		edgeHandles.push_back(intern(routeVector[i]));
 		edgeInfos.push_back(EdgeInfo(routeVector[i]));
 	}
 	if (routeVector.size() > 0) {
@@ -88,6 +90,14 @@ vector<string> & Route::getEdgeIds() {
 	return edgeIds;
 }
 
+const vector<string> & Route::getEdgeIds() const {
+	return edgeIds;
+}
+
+const vector<StringId> & Route::getEdgeHandles() const {
+	return edgeHandles;
+}
+
 double Route::getCapacity() {
 	return capacity;
 }
@@ -107,8 +117,16 @@ double Route::getLength() {
  * Checks if route contains the edge after startEdge and before endEdge (margin edges excluded)
  */
 bool Route::containsEdgeExcludedMargins(string edgeId, string startEdgeId, string endEdgeId) {
+	StringId edge;
+	if (!StringInterner::getInstance().find(edgeId, edge)) {
+		return false;
+	}
+	return containsEdgeExcludedMargins(edge, intern(startEdgeId), intern(endEdgeId));
+}
+
+bool Route::containsEdgeExcludedMargins(StringId edgeId, StringId startEdgeId, StringId endEdgeId) const {
 	bool isMonitored = false;
-	for (vector<string>::iterator it = edgeIds.begin(); it != edgeIds.end(); ++it) {
+	for (vector<StringId>::const_iterator it = edgeHandles.begin(); it != edgeHandles.end(); ++it) {
 		if (*it == endEdgeId) {
 			isMonitored = false;
 		}
@@ -128,9 +146,13 @@ bool Route::containsEdgeExcludedMargins(string edgeId, string startEdgeId, strin
  * Checks how many edges does the route contain after startEdge and before endEdge (margin edges excluded)
  */
 int Route::countEdgesExcludedMargins(string startEdgeId, string endEdgeId) {
+	return countEdgesExcludedMargins(intern(startEdgeId), intern(endEdgeId));
+}
+
+int Route::countEdgesExcludedMargins(StringId startEdgeId, StringId endEdgeId) const {
 	bool isMonitored = false;
 	int numberOdEdges = 0;
-	for (vector<string>::iterator it = edgeIds.begin(); it != edgeIds.end(); ++it) {
+	for (vector<StringId>::const_iterator it = edgeHandles.begin(); it != edgeHandles.end(); ++it) {
 		if (*it == endEdgeId) {
 			isMonitored = false;
 		}
@@ -145,7 +167,12 @@ int Route::countEdgesExcludedMargins(string startEdgeId, string endEdgeId) {
 }
 
 bool Route::containsEdge(string edgeId) {
-	for (vector<string>::iterator it = edgeIds.begin(); it != edgeIds.end(); ++it) {
+	StringId edge;
+	return StringInterner::getInstance().find(edgeId, edge) && containsEdge(edge);
+}
+
+bool Route::containsEdge(StringId edgeId) const {
+	for (vector<StringId>::const_iterator it = edgeHandles.begin(); it != edgeHandles.end(); ++it) {
 		if (*it == edgeId) {
 			return true;
 		}
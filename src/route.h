@@ -15,6 +15,7 @@
 #include <string>
 #include "edge.h"
 #include "edgeInfo.h"
+#include "stringInterner.h"
 
 using namespace std;
 
@@ -37,10 +38,18 @@ public:
 	virtual std::string printRoute();
 
 	std::vector<std::string> & getEdgeIds();
+	const std::vector<std::string> & getEdgeIds() const;
+	/**
+	 * Handles of the edges, in the order of getEdgeIds().
+	 */
+	const std::vector<StringId> & getEdgeHandles() const;
 	std::vector<EdgeInfo> & getEdgeInfos();
 	bool containsEdge(string edgeId);
+	bool containsEdge(StringId edgeId) const;
 	bool containsEdgeExcludedMargins(string edgeId, string startEdgeId, string endEdgeId);
+	bool containsEdgeExcludedMargins(StringId edgeId, StringId startEdgeId, StringId endEdgeId) const;
 	int countEdgesExcludedMargins(string startEdgeId, string endEdgeId);
+	int countEdgesExcludedMargins(StringId startEdgeId, StringId endEdgeId) const;
 	double getEdgeMaxSpeed(std::string edgeId);
 	double getCapacity();
 	void setCapacity(double capacity);
@@ -58,6 +67,7 @@ public:
 protected:
 	std::string id;
 	std::vector<std::string> edgeIds;
+	std::vector<StringId> edgeHandles;
 	std::vector<EdgeInfo> edgeInfos;
 	double staticCost; // time = length / maxSpeed
 	double length;
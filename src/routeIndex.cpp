@@ -0,0 +1,215 @@
+/*
+ * routeIndex.cpp
+ *
+ *  Incidence of the edges on the alternative routes.
+ */
+
+#include "routeIndex.h"
+#include "ns3/assert.h"
+
+using namespace std;
+
+namespace ovnis {
+
+const uint32_t RouteIndex::NOT_FOUND;
+
+RouteIndex::Selection::Selection() {
+}
+
+RouteIndex::RouteIndex() {
+	firstPosition.push_back(0);
+	firstOccurrence.push_back(0);
+}
+
+RouteIndex::~RouteIndex() {
+}
+
+uint32_t RouteIndex::addRoute(const string & routeId, const vector<StringId> & routeEdges) {
+	map<string, uint32_t>::iterator it = rows.find(routeId);
+	if (it != rows.end()) {
+		return it->second;
+	}
+	uint32_t row = routeIds.size();
+	routeIds.push_back(routeId);
+	rows[routeId] = row;
+	for (vector<StringId>::const_iterator edge = routeEdges.begin(); edge != routeEdges.end(); ++edge) {
+		map<StringId, uint32_t>::iterator column = columns.find(*edge);
+		if (column == columns.end()) {
+			column = columns.insert(make_pair(*edge, (uint32_t) edges.size())).first;
+			edges.push_back(*edge);
+		}
+		positionColumns.push_back(column->second);
+	}
+	firstPosition.push_back(positionColumns.size());
+	indexColumns();
+	return row;
+}
+
+void RouteIndex::indexColumns() {
+	// counting sort of the positions by column, the rows being walked in order
+	firstOccurrence.assign(edges.size() + 1, 0);
+	for (vector<uint32_t>::iterator it = positionColumns.begin(); it != positionColumns.end(); ++it) {
+		++firstOccurrence[*it + 1];
+	}
+	for (uint32_t column = 0; column < edges.size(); ++column) {
+		firstOccurrence[column + 1] += firstOccurrence[column];
+	}
+	occurrences.resize(positionColumns.size());
+	vector<uint32_t> next(firstOccurrence.begin(), firstOccurrence.end() - 1);
+	for (uint32_t row = 0; row < routeIds.size(); ++row) {
+		for (uint32_t i = firstPosition[row]; i < firstPosition[row + 1]; ++i) {
+			Occurrence & occurrence = occurrences[next[positionColumns[i]]++];
+			occurrence.row = row;
+			occurrence.position = i - firstPosition[row];
+		}
+	}
+}
+
+uint32_t RouteIndex::getNumberOfRows() const {
+	return routeIds.size();
+}
+
+uint32_t RouteIndex::getNumberOfColumns() const {
+	return edges.size();
+}
+
+uint32_t RouteIndex::getRow(const string & routeId) const {
+	map<string, uint32_t>::const_iterator it = rows.find(routeId);
+	return it == rows.end() ? NOT_FOUND : it->second;
+}
+
+uint32_t RouteIndex::getColumn(StringId edge) const {
+	map<StringId, uint32_t>::const_iterator it = columns.find(edge);
+	return it == columns.end() ? NOT_FOUND : it->second;
+}
+
+const string & RouteIndex::getRouteId(uint32_t row) const {
+	return routeIds[row];
+}
+
+StringId RouteIndex::getEdge(uint32_t column) const {
+	return edges[column];
+}
+
+uint32_t RouteIndex::getLength(uint32_t row) const {
+	return firstPosition[row + 1] - firstPosition[row];
+}
+
+uint32_t RouteIndex::getColumnAt(uint32_t row, uint32_t position) const {
+	NS_ASSERT(position < getLength(row));
+	return positionColumns[firstPosition[row] + position];
+}
+
+void RouteIndex::getPositions(uint32_t column, uint32_t row, vector<uint32_t> & positions) const {
+	positions.clear();
+	if (column == NOT_FOUND) {
+		return;
+	}
+	for (uint32_t i = firstOccurrence[column]; i < firstOccurrence[column + 1]; ++i) {
+		if (occurrences[i].row == row) {
+			positions.push_back(occurrences[i].position);
+		}
+	}
+}
+
+void RouteIndex::select(StringId startEdge, StringId endEdge, Selection & selection) const {
+	selection.firstRange.clear();
+	selection.ranges.clear();
+	uint32_t startColumn = getColumn(startEdge);
+	uint32_t endColumn = getColumn(endEdge);
+	vector<uint32_t> starts;
+	vector<uint32_t> ends;
+	for (uint32_t row = 0; row < routeIds.size(); ++row) {
+		selection.firstRange.push_back(selection.ranges.size());
+		getPositions(startColumn, row, starts);
+		getPositions(endColumn, row, ends);
+		// monitoring stops at an end edge and starts after a start edge, the end
+		// being checked first when both are at the same position
+		bool monitored = false;
+		Range range = {0, 0};
+		size_t i = 0;
+		size_t j = 0;
+		while (i < starts.size() || j < ends.size()) {
+			if (j < ends.size() && (i == starts.size() || ends[j] <= starts[i])) {
+				if (monitored) {
+					range.to = ends[j];
+					if (range.from < range.to) {
+						selection.ranges.push_back(range);
+					}
+					monitored = false;
+				}
+				++j;
+			}
+			else {
+				if (!monitored) {
+					range.from = starts[i] + 1;
+					monitored = true;
+				}
+				++i;
+			}
+		}
+		if (monitored) {
+			range.to = getLength(row);
+			if (range.from < range.to) {
+				selection.ranges.push_back(range);
+			}
+		}
+	}
+	selection.firstRange.push_back(selection.ranges.size());
+}
+
+bool RouteIndex::contains(const Selection & selection, uint32_t row, uint32_t column) const {
+	return count(selection, row, column) > 0;
+}
+
+uint32_t RouteIndex::count(const Selection & selection, uint32_t row, uint32_t column) const {
+	if (column == NOT_FOUND) {
+		return 0;
+	}
+	uint32_t count = 0;
+	for (uint32_t i = firstOccurrence[column]; i < firstOccurrence[column + 1]; ++i) {
+		if (occurrences[i].row == row) {
+			uint32_t position = occurrences[i].position;
+			for (uint32_t r = selection.firstRange[row]; r < selection.firstRange[row + 1]; ++r) {
+				if (position >= selection.ranges[r].from && position < selection.ranges[r].to) {
+					++count;
+				}
+			}
+		}
+	}
+	return count;
+}
+
+uint32_t RouteIndex::count(const Selection & selection, uint32_t row) const {
+	uint32_t count = 0;
+	for (uint32_t r = selection.firstRange[row]; r < selection.firstRange[row + 1]; ++r) {
+		count += selection.ranges[r].to - selection.ranges[r].from;
+	}
+	return count;
+}
+
+void RouteIndex::getColumns(const Selection & selection, uint32_t row, vector<uint32_t> & columns) const {
+	columns.clear();
+	for (uint32_t r = selection.firstRange[row]; r < selection.firstRange[row + 1]; ++r) {
+		const Range & range = selection.ranges[r];
+		columns.insert(columns.end(), positionColumns.begin() + firstPosition[row] + range.from,
+				positionColumns.begin() + firstPosition[row] + range.to);
+	}
+}
+
+void RouteIndex::multiply(const Selection & selection, const vector<double> & edgeCosts, vector<double> & routeCosts) const {
+	NS_ASSERT(edgeCosts.size() >= edges.size());
+	routeCosts.assign(routeIds.size(), 0);
+	for (uint32_t row = 0; row < routeIds.size(); ++row) {
+		double cost = 0;
+		for (uint32_t r = selection.firstRange[row]; r < selection.firstRange[row + 1]; ++r) {
+			const Range & range = selection.ranges[r];
+			for (uint32_t i = firstPosition[row] + range.from; i < firstPosition[row] + range.to; ++i) {
+				cost += edgeCosts[positionColumns[i]];
+			}
+		}
+		routeCosts[row] = cost;
+	}
+}
+
+} /* namespace ovnis */
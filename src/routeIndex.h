@@ -0,0 +1,146 @@
+/*
+ * routeIndex.h
+ *
+ *  Incidence of the edges on the alternative routes.
+ */
+
+#ifndef ROUTEINDEX_H_
+#define ROUTEINDEX_H_
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <map>
+#include <stdint.h>
+
+#include "stringInterner.h"
+
+namespace ovnis {
+
+/**
+ * Sparse matrix of the routes (rows) and of the edges they go through (columns).
+ *
+ * The edges of each route are stored by position, so that the part of a route between
+ * a start and an end edge, the margins excluded as by Route::containsEdgeExcludedMargins,
+ * is a range of positions. The positions of each edge on the routes are stored as
+ * well, so that the ranges are found without scanning the routes.
+ *
+ * The cost of the routes is then the product of the matrix, restricted to a Selection
+ * of ranges, with a vector of edge costs indexed by column.
+ */
+class RouteIndex {
+public:
+	static const uint32_t NOT_FOUND = 0xffffffff;
+
+	/**
+	 * Positions [from, to) of a route.
+	 */
+	struct Range {
+		uint32_t from;
+		uint32_t to;
+	};
+
+	/**
+	 * The parts of the routes between a start and an end edge, see select().
+	 */
+	class Selection {
+	public:
+		Selection();
+
+	private:
+		friend class RouteIndex;
+		std::vector<uint32_t> firstRange; // first range of each row, and the end of the last
+		std::vector<Range> ranges;
+	};
+
+	RouteIndex();
+	~RouteIndex();
+
+	/**
+	 * Adds a row for routeId, unless it is already indexed.
+	 *
+	 * @return the row of routeId.
+	 */
+	uint32_t addRoute(const std::string & routeId, const std::vector<StringId> & edges);
+
+	uint32_t getNumberOfRows() const;
+	uint32_t getNumberOfColumns() const;
+	/**
+	 * @return the row of routeId, NOT_FOUND if it is not indexed.
+	 */
+	uint32_t getRow(const std::string & routeId) const;
+	/**
+	 * @return the column of edge, NOT_FOUND if no route goes through it.
+	 */
+	uint32_t getColumn(StringId edge) const;
+	const std::string & getRouteId(uint32_t row) const;
+	StringId getEdge(uint32_t column) const;
+	/**
+	 * @return the number of edges of the route of row.
+	 */
+	uint32_t getLength(uint32_t row) const;
+	/**
+	 * @return the column of the edge at position of the route of row.
+	 */
+	uint32_t getColumnAt(uint32_t row, uint32_t position) const;
+
+	/**
+	 * Fills selection with the positions of each route after startEdge and before
+	 * endEdge.
+	 */
+	void select(StringId startEdge, StringId endEdge, Selection & selection) const;
+	/**
+	 * @return whether the edge of column is in the selected part of the route of row.
+	 */
+	bool contains(const Selection & selection, uint32_t row, uint32_t column) const;
+	/**
+	 * @return the number of positions in the selected part of the route of row.
+	 */
+	uint32_t count(const Selection & selection, uint32_t row) const;
+	/**
+	 * @return the number of times the selected part of the route of row goes through
+	 * the edge of column.
+	 */
+	uint32_t count(const Selection & selection, uint32_t row, uint32_t column) const;
+	/**
+	 * Fills columns with the edges of the selected part of the route of row, in order.
+	 */
+	void getColumns(const Selection & selection, uint32_t row, std::vector<uint32_t> & columns) const;
+
+	/**
+	 * Sums the costs of the edges of the selected part of each route.
+	 *
+	 * @param edgeCosts the cost of each column.
+	 * @param routeCosts filled with the cost of each row.
+	 */
+	void multiply(const Selection & selection, const std::vector<double> & edgeCosts, std::vector<double> & routeCosts) const;
+
+private:
+	struct Occurrence {
+		uint32_t row;
+		uint32_t position;
+	};
+
+	/**
+	 * Rebuilds the occurrences of the edges from the rows.
+	 */
+	void indexColumns();
+	/**
+	 * Fills positions with the positions of column on the route of row.
+	 */
+	void getPositions(uint32_t column, uint32_t row, std::vector<uint32_t> & positions) const;
+
+	std::vector<std::string> routeIds;
+	std::map<std::string, uint32_t> rows;
+	std::vector<uint32_t> firstPosition; // first position of each row in positionColumns, and the end of the last
+	std::vector<uint32_t> positionColumns; // column of each position
+
+	std::vector<StringId> edges;
+	std::map<StringId, uint32_t> columns;
+	std::vector<uint32_t> firstOccurrence; // first occurrence of each column, and the end of the last
+	std::vector<Occurrence> occurrences; // by column, row and position
+};
+
+} /* namespace ovnis */
+
+#endif /* ROUTEINDEX_H_ */
@@ -0,0 +1,445 @@
+/*
+ * routingEngine.cpp
+ *
+ *  Shortest and alternative routes over the road graph.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <set>
+#include <functional>
+#include "routingEngine.h"
+#include "ns3/assert.h"
+
+using namespace std;
+
+namespace ovnis {
+
+const uint32_t RoutingEngine::NOT_FOUND;
+
+namespace {
+
+const double INFINITE_COST = numeric_limits<double>::infinity();
+
+/**
+ * Factor applied to the weight of the edges of a route found by getAlternatives(),
+ * before the next search.
+ */
+const double PENALTY = 1.5;
+
+}
+
+RoutingEngine::RoutingEngine(const RoadGraph & graph) : graph(graph), stamp(0) {
+	contract();
+	Label label;
+	label.stamp = 0;
+	label.distance = INFINITE_COST;
+	label.parent = NOT_FOUND;
+	label.settled = false;
+	forward.assign(graph.getNumberOfJunctions(), label);
+	backward.assign(graph.getNumberOfJunctions(), label);
+	vector<double> staticCosts;
+	graph.getStaticCosts(staticCosts);
+	customize(staticCosts);
+}
+
+RoutingEngine::~RoutingEngine() {
+}
+
+const RoadGraph & RoutingEngine::getGraph() const {
+	return graph;
+}
+
+uint32_t RoutingEngine::getNumberOfShortcuts() const {
+	return shortcuts.size();
+}
+
+void RoutingEngine::contract() {
+	uint32_t n = graph.getNumberOfJunctions();
+	vector<set<uint32_t> > neighbours(n); // not contracted yet
+	for (uint32_t edge = 0; edge < graph.getNumberOfEdges(); ++edge) {
+		uint32_t from = graph.getFrom(edge);
+		uint32_t to = graph.getTo(edge);
+		if (from != to) {
+			neighbours[from].insert(to);
+			neighbours[to].insert(from);
+		}
+	}
+	// the junction of least degree is contracted first, the degrees being updated
+	// lazily in the queue
+	priority_queue<pair<uint32_t, uint32_t>, vector<pair<uint32_t, uint32_t> >, greater<pair<uint32_t, uint32_t> > > queue;
+	for (uint32_t junction = 0; junction < n; ++junction) {
+		queue.push(make_pair((uint32_t) neighbours[junction].size(), junction));
+	}
+	ranks.assign(n, NOT_FOUND);
+	ordered.clear();
+	vector<vector<uint32_t> > later(n);
+	while (!queue.empty()) {
+		uint32_t degree = queue.top().first;
+		uint32_t junction = queue.top().second;
+		queue.pop();
+		if (ranks[junction] != NOT_FOUND || degree != neighbours[junction].size()) {
+			continue;
+		}
+		ranks[junction] = ordered.size();
+		ordered.push_back(junction);
+		vector<uint32_t> & links = later[junction];
+		links.assign(neighbours[junction].begin(), neighbours[junction].end());
+		set<uint32_t>().swap(neighbours[junction]);
+		for (vector<uint32_t>::iterator u = links.begin(); u != links.end(); ++u) {
+			neighbours[*u].erase(junction);
+			for (vector<uint32_t>::iterator w = links.begin(); w != links.end(); ++w) {
+				if (*u != *w) {
+					neighbours[*u].insert(*w);
+				}
+			}
+		}
+		for (vector<uint32_t>::iterator u = links.begin(); u != links.end(); ++u) {
+			queue.push(make_pair((uint32_t) neighbours[*u].size(), *u));
+		}
+	}
+
+	firstShortcut.assign(1, 0);
+	shortcuts.clear();
+	for (uint32_t junction = 0; junction < n; ++junction) {
+		for (vector<uint32_t>::iterator head = later[junction].begin(); head != later[junction].end(); ++head) {
+			Shortcut shortcut;
+			shortcut.tail = junction;
+			shortcut.head = *head;
+			shortcut.up = INFINITE_COST;
+			shortcut.down = INFINITE_COST;
+			shortcut.upEdge = NOT_FOUND;
+			shortcut.downEdge = NOT_FOUND;
+			shortcut.upVia = NOT_FOUND;
+			shortcut.downVia = NOT_FOUND;
+			shortcuts.push_back(shortcut);
+		}
+		firstShortcut.push_back(shortcuts.size());
+	}
+}
+
+uint32_t RoutingEngine::findShortcut(uint32_t low, uint32_t high) const {
+	uint32_t first = firstShortcut[low];
+	uint32_t last = firstShortcut[low + 1];
+	while (first < last) {
+		uint32_t middle = first + (last - first) / 2;
+		if (shortcuts[middle].head < high) {
+			first = middle + 1;
+		}
+		else {
+			last = middle;
+		}
+	}
+	NS_ASSERT(first < firstShortcut[low + 1] && shortcuts[first].head == high);
+	return first;
+}
+
+void RoutingEngine::customize(const vector<double> & weights) {
+	NS_ASSERT(weights.size() == graph.getNumberOfEdges());
+	this->weights = weights;
+	for (vector<Shortcut>::iterator it = shortcuts.begin(); it != shortcuts.end(); ++it) {
+		it->up = INFINITE_COST;
+		it->down = INFINITE_COST;
+		it->upEdge = NOT_FOUND;
+		it->downEdge = NOT_FOUND;
+		it->upVia = NOT_FOUND;
+		it->downVia = NOT_FOUND;
+	}
+	for (uint32_t edge = 0; edge < graph.getNumberOfEdges(); ++edge) {
+		uint32_t from = graph.getFrom(edge);
+		uint32_t to = graph.getTo(edge);
+		if (from == to) {
+			continue;
+		}
+		if (ranks[from] < ranks[to]) {
+			Shortcut & shortcut = shortcuts[findShortcut(from, to)];
+			if (weights[edge] < shortcut.up) {
+				shortcut.up = weights[edge];
+				shortcut.upEdge = edge;
+			}
+		}
+		else {
+			Shortcut & shortcut = shortcuts[findShortcut(to, from)];
+			if (weights[edge] < shortcut.down) {
+				shortcut.down = weights[edge];
+				shortcut.downEdge = edge;
+			}
+		}
+	}
+	// the shortcuts of a junction are final once the earlier junctions are done, the
+	// lower triangles of a shortcut being through earlier junctions only
+	for (vector<uint32_t>::iterator via = ordered.begin(); via != ordered.end(); ++via) {
+		for (uint32_t i = firstShortcut[*via]; i < firstShortcut[*via + 1]; ++i) {
+			for (uint32_t j = firstShortcut[*via]; j < firstShortcut[*via + 1]; ++j) {
+				const Shortcut & toLow = shortcuts[i];
+				const Shortcut & toHigh = shortcuts[j];
+				if (ranks[toLow.head] >= ranks[toHigh.head]) {
+					continue;
+				}
+				Shortcut & shortcut = shortcuts[findShortcut(toLow.head, toHigh.head)];
+				double up = toLow.down + toHigh.up;
+				if (up < shortcut.up) {
+					shortcut.up = up;
+					shortcut.upEdge = NOT_FOUND;
+					shortcut.upVia = *via;
+				}
+				double down = toHigh.down + toLow.up;
+				if (down < shortcut.down) {
+					shortcut.down = down;
+					shortcut.downEdge = NOT_FOUND;
+					shortcut.downVia = *via;
+				}
+			}
+		}
+	}
+}
+
+const vector<double> & RoutingEngine::getWeights() const {
+	return weights;
+}
+
+void RoutingEngine::unpack(uint32_t shortcut, bool up, vector<uint32_t> & edges) const {
+	const Shortcut & s = shortcuts[shortcut];
+	uint32_t via = up ? s.upVia : s.downVia;
+	if (via == NOT_FOUND) {
+		edges.push_back(up ? s.upEdge : s.downEdge);
+		return;
+	}
+	uint32_t toTail = findShortcut(via, s.tail);
+	uint32_t toHead = findShortcut(via, s.head);
+	if (up) {
+		unpack(toTail, false, edges);
+		unpack(toHead, true, edges);
+	}
+	else {
+		unpack(toHead, false, edges);
+		unpack(toTail, true, edges);
+	}
+}
+
+void RoutingEngine::nextStamp() const {
+	if (++stamp == 0) {
+		for (uint32_t junction = 0; junction < forward.size(); ++junction) {
+			forward[junction].stamp = 0;
+			backward[junction].stamp = 0;
+		}
+		stamp = 1;
+	}
+}
+
+RoutingEngine::Label & RoutingEngine::getLabel(vector<Label> & labels, uint32_t junction) const {
+	Label & label = labels[junction];
+	if (label.stamp != stamp) {
+		label.stamp = stamp;
+		label.distance = INFINITE_COST;
+		label.parent = NOT_FOUND;
+		label.settled = false;
+	}
+	return label;
+}
+
+void RoutingEngine::complete(const vector<double> & weights, uint32_t source, uint32_t target, double cost, Path & path) const {
+	path.edges.insert(path.edges.begin(), source);
+	path.edges.push_back(target);
+	path.cost = weights[source] + cost + weights[target];
+}
+
+bool RoutingEngine::query(uint32_t source, uint32_t target, Path & path) const {
+	path.edges.clear();
+	if (source == target) {
+		path.edges.push_back(source);
+		path.cost = weights[source];
+		return true;
+	}
+	uint32_t from = graph.getTo(source);
+	uint32_t to = graph.getFrom(target);
+	nextStamp();
+	priority_queue<QueueEntry, vector<QueueEntry>, greater<QueueEntry> > queues[2];
+	vector<Label> * labels[2] = { &forward, &backward };
+	getLabel(forward, from).distance = 0;
+	getLabel(backward, to).distance = 0;
+	queues[0].push(QueueEntry(0, from));
+	queues[1].push(QueueEntry(0, to));
+	double best = INFINITE_COST;
+	uint32_t meeting = NOT_FOUND;
+	while (!queues[0].empty() || !queues[1].empty()) {
+		int side = queues[1].empty() || (!queues[0].empty() && queues[0].top().first <= queues[1].top().first) ? 0 : 1;
+		double distance = queues[side].top().first;
+		uint32_t junction = queues[side].top().second;
+		queues[side].pop();
+		if (distance >= best) {
+			// nothing shorter is left on that side
+			while (!queues[side].empty()) {
+				queues[side].pop();
+			}
+			continue;
+		}
+		Label & label = getLabel(*labels[side], junction);
+		if (label.settled || distance > label.distance) {
+			continue;
+		}
+		label.settled = true;
+		const Label & other = getLabel(*labels[1 - side], junction);
+		if (distance + other.distance < best) {
+			best = distance + other.distance;
+			meeting = junction;
+		}
+		for (uint32_t i = firstShortcut[junction]; i < firstShortcut[junction + 1]; ++i) {
+			const Shortcut & shortcut = shortcuts[i];
+			double next = distance + (side == 0 ? shortcut.up : shortcut.down);
+			Label & head = getLabel(*labels[side], shortcut.head);
+			if (next < head.distance) {
+				head.distance = next;
+				head.parent = i;
+				queues[side].push(QueueEntry(next, shortcut.head));
+			}
+		}
+	}
+	if (meeting == NOT_FOUND) {
+		return false;
+	}
+	vector<uint32_t> upwards;
+	for (uint32_t junction = meeting; junction != from; junction = shortcuts[forward[junction].parent].tail) {
+		upwards.push_back(forward[junction].parent);
+	}
+	for (vector<uint32_t>::reverse_iterator it = upwards.rbegin(); it != upwards.rend(); ++it) {
+		unpack(*it, true, path.edges);
+	}
+	for (uint32_t junction = meeting; junction != to; junction = shortcuts[backward[junction].parent].tail) {
+		unpack(backward[junction].parent, false, path.edges);
+	}
+	complete(weights, source, target, best, path);
+	return true;
+}
+
+double RoutingEngine::getDistance(uint32_t junction, uint32_t target) const {
+	double dx = graph.getX(junction) - graph.getX(target);
+	double dy = graph.getY(junction) - graph.getY(target);
+	return sqrt(dx * dx + dy * dy);
+}
+
+double RoutingEngine::getLowestCostPerMeter(const vector<double> & weights) const {
+	// the weight of an edge bounds the distance between its junctions, so that the
+	// estimate of the cost to the target never decreases by more than the weight
+	// along an edge and A* settles each junction once
+	double lowest = INFINITE_COST;
+	for (uint32_t edge = 0; edge < graph.getNumberOfEdges(); ++edge) {
+		double distance = getDistance(graph.getFrom(edge), graph.getTo(edge));
+		if (distance > 0) {
+			lowest = min(lowest, weights[edge] / distance);
+		}
+	}
+	return lowest == INFINITE_COST ? 0 : lowest;
+}
+
+bool RoutingEngine::search(const vector<double> & weights, double costPerMeter, uint32_t source, uint32_t target, Path & path) const {
+	NS_ASSERT(weights.size() == graph.getNumberOfEdges());
+	path.edges.clear();
+	if (source == target) {
+		path.edges.push_back(source);
+		path.cost = weights[source];
+		return true;
+	}
+	uint32_t from = graph.getTo(source);
+	uint32_t to = graph.getFrom(target);
+	nextStamp();
+	priority_queue<QueueEntry, vector<QueueEntry>, greater<QueueEntry> > queue;
+	getLabel(forward, from).distance = 0;
+	queue.push(QueueEntry(costPerMeter * getDistance(from, to), from));
+	while (!queue.empty()) {
+		uint32_t junction = queue.top().second;
+		queue.pop();
+		Label & label = getLabel(forward, junction);
+		if (label.settled) {
+			continue;
+		}
+		label.settled = true;
+		if (junction == to) {
+			break;
+		}
+		const vector<uint32_t> & outEdges = graph.getOutEdges(junction);
+		for (vector<uint32_t>::const_iterator edge = outEdges.begin(); edge != outEdges.end(); ++edge) {
+			uint32_t next = graph.getTo(*edge);
+			double distance = label.distance + weights[*edge];
+			Label & head = getLabel(forward, next);
+			if (distance < head.distance) {
+				head.distance = distance;
+				head.parent = *edge;
+				queue.push(QueueEntry(distance + costPerMeter * getDistance(next, to), next));
+			}
+		}
+	}
+	const Label & reached = getLabel(forward, to);
+	if (!reached.settled) {
+		return false;
+	}
+	for (uint32_t junction = to; junction != from; junction = graph.getFrom(forward[junction].parent)) {
+		path.edges.push_back(forward[junction].parent);
+	}
+	reverse(path.edges.begin(), path.edges.end());
+	complete(weights, source, target, reached.distance, path);
+	return true;
+}
+
+bool RoutingEngine::dijkstra(const vector<double> & weights, uint32_t source, uint32_t target, Path & path) const {
+	return search(weights, 0, source, target, path);
+}
+
+bool RoutingEngine::astar(const vector<double> & weights, uint32_t source, uint32_t target, Path & path) const {
+	return search(weights, graph.isLocated() ? getLowestCostPerMeter(weights) : 0, source, target, path);
+}
+
+void RoutingEngine::getAlternatives(const vector<double> & weights, uint32_t source, uint32_t target, uint32_t k,
+		vector<Path> & routes, double maxShare, double maxStretch) const {
+	routes.clear();
+	// the penalties only raise the weights, the lowest cost per meter stays a bound
+	double costPerMeter = graph.isLocated() ? getLowestCostPerMeter(weights) : 0;
+	vector<double> penalized(weights);
+	vector<vector<uint32_t> > inner; // edges of each route kept, the source and target excluded, sorted
+	Path path;
+	for (uint32_t attempt = 0; attempt < 2 * k && routes.size() < k; ++attempt) {
+		if (!search(penalized, costPerMeter, source, target, path)) {
+			return;
+		}
+		vector<uint32_t> edges;
+		path.cost = 0;
+		for (size_t i = 0; i < path.edges.size(); ++i) {
+			path.cost += weights[path.edges[i]];
+			if (i > 0 && i + 1 < path.edges.size()) {
+				edges.push_back(path.edges[i]);
+				penalized[path.edges[i]] *= PENALTY;
+			}
+		}
+		sort(edges.begin(), edges.end());
+		double innerCost = path.cost - weights[source] - (source == target ? 0 : weights[target]);
+		bool kept = routes.empty() || path.cost <= maxStretch * routes.front().cost;
+		for (size_t r = 0; r < routes.size() && kept; ++r) {
+			double shared = 0;
+			for (vector<uint32_t>::iterator edge = edges.begin(); edge != edges.end(); ++edge) {
+				if (binary_search(inner[r].begin(), inner[r].end(), *edge)) {
+					shared += weights[*edge];
+				}
+			}
+			kept = path.edges != routes[r].edges && shared <= maxShare * innerCost;
+		}
+		if (kept) {
+			routes.push_back(path);
+			inner.push_back(edges);
+		}
+	}
+}
+
+string RoutingEngine::toString(const Path & path) const {
+	string edges;
+	for (vector<uint32_t>::const_iterator edge = path.edges.begin(); edge != path.edges.end(); ++edge) {
+		if (!edges.empty()) {
+			edges += " ";
+		}
+		edges += lookup(graph.getEdgeId(*edge));
+	}
+	return edges;
+}
+
+} /* namespace ovnis */
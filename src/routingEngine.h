@@ -0,0 +1,182 @@
+/*
+ * routingEngine.h
+ *
+ *  Shortest and alternative routes over the road graph.
+ */
+
+#ifndef ROUTINGENGINE_H_
+#define ROUTINGENGINE_H_
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "ns3/simple-ref-count.h"
+#include "roadGraph.h"
+
+namespace ovnis {
+
+/**
+ * Routes from an edge to another of a RoadGraph, for edge weights that change during
+ * the simulation, e.g. the travel times known by a vehicle or reported to the TIS.
+ *
+ * A route goes from the source to the target edge through the junctions in between,
+ * and its cost is the sum of the weights of all its edges, the source and the target
+ * included. The turns are not restricted, the connections of the net file not being
+ * read.
+ *
+ * dijkstra() and astar() search the graph for any weights. query() answers from a
+ * contraction hierarchy of the junctions: the junctions are ordered once, by minimum
+ * degree, and every junction is linked by a shortcut to the later junctions of its
+ * neighbourhood when it is contracted. The shortcuts depend on the order only, so that
+ * new weights are taken by customize(), which computes the weight of each shortcut
+ * from those of the lower triangles, without ordering the junctions again. A query
+ * then only searches upwards from both ends, which settles a few hundred junctions
+ * in a city network.
+ *
+ * The searches keep their labels between the queries, stamped with the query, so that
+ * a query does not clear arrays the size of the graph. The engine is not reentrant.
+ */
+class RoutingEngine : public ns3::SimpleRefCount<RoutingEngine> {
+public:
+	static const uint32_t NOT_FOUND = 0xffffffff;
+
+	/**
+	 * Edges of a route, by number in the graph, and its cost.
+	 */
+	struct Path {
+		std::vector<uint32_t> edges;
+		double cost;
+	};
+
+	/**
+	 * Orders the junctions of graph and builds the shortcuts. graph must outlive the
+	 * engine and must not be modified afterwards. The hierarchy is customized with the
+	 * static costs of the edges.
+	 */
+	RoutingEngine(const RoadGraph & graph);
+	~RoutingEngine();
+
+	const RoadGraph & getGraph() const;
+	/**
+	 * @return the number of shortcuts of the hierarchy, the links between the
+	 * junctions included.
+	 */
+	uint32_t getNumberOfShortcuts() const;
+
+	/**
+	 * Searches the graph with the Dijkstra algorithm.
+	 *
+	 * @param weights the cost of each edge, by number, non negative.
+	 * @return false when target cannot be reached from source.
+	 */
+	bool dijkstra(const std::vector<double> & weights, uint32_t source, uint32_t target, Path & path) const;
+	/**
+	 * Searches the graph with the A* algorithm, the distance to target as the crow
+	 * flies being scaled by the lowest cost per meter of the edges. Falls back to
+	 * dijkstra() when the junctions are not located.
+	 */
+	bool astar(const std::vector<double> & weights, uint32_t source, uint32_t target, Path & path) const;
+
+	/**
+	 * Computes the weights of the shortcuts from weights, for query().
+	 */
+	void customize(const std::vector<double> & weights);
+	/**
+	 * @return the weights of the last customize().
+	 */
+	const std::vector<double> & getWeights() const;
+	/**
+	 * Searches the hierarchy, for the weights of the last customize().
+	 */
+	bool query(uint32_t source, uint32_t target, Path & path) const;
+
+	/**
+	 * Finds up to k routes by the penalty method: the edges of each route found are
+	 * made more expensive before the next search, and a route is kept unless it shares
+	 * more than maxShare of its cost with a route kept before, or costs more than
+	 * maxStretch times the shortest. The source and target edges, common to all the
+	 * routes, are not counted as shared.
+	 *
+	 * @param routes filled with the routes, the shortest first.
+	 */
+	void getAlternatives(const std::vector<double> & weights, uint32_t source, uint32_t target, uint32_t k,
+			std::vector<Path> & routes, double maxShare = 0.8, double maxStretch = 1.5) const;
+
+	/**
+	 * @return the ids of the edges of path, separated by spaces, as by Route.
+	 */
+	std::string toString(const Path & path) const;
+
+private:
+	RoutingEngine(const RoutingEngine &); // Don't Implement
+	void operator =(const RoutingEngine &); // Don't implement
+
+	/**
+	 * Link from a junction to a later one in the order, and the weights of the
+	 * routes between them, through earlier junctions only, in both directions.
+	 */
+	struct Shortcut {
+		uint32_t tail; // the earlier junction
+		uint32_t head; // the later junction
+		double up; // weight from the earlier junction to head
+		double down; // weight from head to the earlier junction
+		uint32_t upEdge; // edge of weight up, NOT_FOUND if through upVia
+		uint32_t downEdge;
+		uint32_t upVia; // junction of the lower triangle of weight up, NOT_FOUND if an edge
+		uint32_t downVia;
+	};
+
+	/**
+	 * Label of a junction in a search, valid while stamp is that of the search.
+	 */
+	struct Label {
+		uint32_t stamp;
+		double distance;
+		uint32_t parent; // edge or shortcut the junction was reached through
+		bool settled;
+	};
+
+	typedef std::pair<double, uint32_t> QueueEntry;
+
+	/**
+	 * Orders the junctions by minimum degree and links each of them to the later
+	 * junctions of its neighbourhood.
+	 */
+	void contract();
+	/**
+	 * @return the shortcut from the earlier junction low to high.
+	 */
+	uint32_t findShortcut(uint32_t low, uint32_t high) const;
+	/**
+	 * Appends the edges of the shortcut from its earlier junction to its head, if up,
+	 * from its head to its earlier junction otherwise.
+	 */
+	void unpack(uint32_t shortcut, bool up, std::vector<uint32_t> & edges) const;
+
+	bool search(const std::vector<double> & weights, double costPerMeter, uint32_t source, uint32_t target, Path & path) const;
+	double getLowestCostPerMeter(const std::vector<double> & weights) const;
+	double getDistance(uint32_t junction, uint32_t target) const;
+	Label & getLabel(std::vector<Label> & labels, uint32_t junction) const;
+	void nextStamp() const;
+	/**
+	 * Adds the source and target edges around the edges between the junctions.
+	 */
+	void complete(const std::vector<double> & weights, uint32_t source, uint32_t target, double cost, Path & path) const;
+
+	const RoadGraph & graph;
+	std::vector<uint32_t> ranks; // position of each junction in the order
+	std::vector<uint32_t> ordered; // junction of each position
+	std::vector<uint32_t> firstShortcut; // first shortcut of each junction, and the end of the last
+	std::vector<Shortcut> shortcuts; // by earlier junction and by head
+	std::vector<double> weights;
+
+	mutable uint32_t stamp;
+	mutable std::vector<Label> forward;
+	mutable std::vector<Label> backward;
+};
+
+} /* namespace ovnis */
+
+#endif /* ROUTINGENGINE_H_ */
@@ -24,31 +24,71 @@ std::map<std::string,Route>  & Network::getAlternativeRoutes()
 	return alternativeRoutes;
 }
 
+const std::map<std::string,Route>  & Network::getAlternativeRoutes() const
+{
+	return alternativeRoutes;
+}
+
 std::vector<std::string>  & Network::getDecisionEdges()
 {
 	return decisionEdges;
 }
 
+const std::vector<std::string>  & Network::getDecisionEdges() const
+{
+	return decisionEdges;
+}
+
 std::vector<std::string>  & Network::getNotificationEdges()
 {
 	return notificationEdges;
 }
 
-void Network::setAlternativeRoutes(std::map<std::string,Route> alternativeRoutes)
+const std::vector<std::string>  & Network::getNotificationEdges() const
+{
+	return notificationEdges;
+}
+
+void Network::setAlternativeRoutes(const std::map<std::string,Route> & alternativeRoutes)
 {
 	this->alternativeRoutes = alternativeRoutes;
 }
 
-void Network::setDecisionEdges(std::vector<std::string> decisionEdges)
+void Network::setDecisionEdges(const std::vector<std::string> & decisionEdges)
 {
 	this->decisionEdges = decisionEdges;
 }
 
-void Network::setNotificationEdges(std::vector<std::string> notificationEdges)
+void Network::setNotificationEdges(const std::vector<std::string> & notificationEdges)
 {
 	this->notificationEdges = notificationEdges;
 }
 
+map<string, ns3::Ptr<const Network> > & Network::getSharedNetworks() {
+	static map<string, ns3::Ptr<const Network> > networks; // Instantiated on first use.
+	return networks;
+}
+
+ns3::Ptr<const Network> Network::find(const string & name) {
+	map<string, ns3::Ptr<const Network> >::iterator it = getSharedNetworks().find(name);
+	if (it == getSharedNetworks().end()) {
+		return 0;
+	}
+	return it->second;
+}
+
+ns3::Ptr<const Network> Network::share(const string & name, ns3::Ptr<Network> network) {
+	ns3::Ptr<const Network> & shared = getSharedNetworks()[name];
+	if (shared == 0) {
+		for (map<string,Route>::iterator it = network->alternativeRoutes.begin(); it != network->alternativeRoutes.end(); ++it) {
+			it->second.computeLength();
+			it->second.computeStaticCost();
+		}
+		shared = network;
+	}
+	return shared;
+}
+
 void Network::print() {
 
 	cout << "\nDecision: ";
@@ -15,26 +15,52 @@
 #include <map>
 #include <set>
 
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
 #include "route.h"
 
 namespace ovnis {
 
-class Network {
+/**
+ * The alternative routes of a scenario, and the edges where the vehicles decide and
+ * are notified.
+ *
+ * A scenario is loaded once and share()d by name: the vehicles then refer to the same
+ * immutable instance instead of each holding a copy of its routes.
+ */
+class Network : public ns3::SimpleRefCount<Network> {
 public:
 	Network();
 	virtual ~Network();
     std::map<std::string,Route>  & getAlternativeRoutes();
+    const std::map<std::string,Route>  & getAlternativeRoutes() const;
     std::vector<std::string>  & getDecisionEdges();
+    const std::vector<std::string>  & getDecisionEdges() const;
     std::vector<std::string>  & getNotificationEdges();
-    void setAlternativeRoutes(std::map<std::string,Route> alternativeRoutes);
-    void setDecisionEdges(std::vector<std::string> decisionEdges);
-    void setNotificationEdges(std::vector<std::string> notificationEdges);
+    const std::vector<std::string>  & getNotificationEdges() const;
+    void setAlternativeRoutes(const std::map<std::string,Route> & alternativeRoutes);
+    void setDecisionEdges(const std::vector<std::string> & decisionEdges);
+    void setNotificationEdges(const std::vector<std::string> & notificationEdges);
     void print();
 
+    /**
+     * @return the scenario shared under name, null if none was.
+     */
+    static ns3::Ptr<const Network> find(const std::string & name);
+    /**
+     * Computes the length and static cost of the routes of network, and shares it under
+     * name. network must not be modified afterwards.
+     *
+     * @return the scenario shared under name, network unless one was already.
+     */
+    static ns3::Ptr<const Network> share(const std::string & name, ns3::Ptr<Network> network);
+
 private:
     std::vector<std::string> decisionEdges;
     std::vector<std::string> notificationEdges;
     std::map<std::string,Route> alternativeRoutes;
+
+    static std::map<std::string, ns3::Ptr<const Network> > & getSharedNetworks();
 };
 
 } /* namespace ovnis */
@@ -0,0 +1,59 @@
+/*
+ * stringInterner.cpp
+ *
+ *  Dense handles for the vehicle, edge, lane and route ids.
+ */
+
+#include "stringInterner.h"
+#include "ns3/assert.h"
+
+using namespace std;
+
+namespace ovnis {
+
+StringInterner & StringInterner::getInstance() {
+	static StringInterner instance; // Guaranteed to be destroyed. Instantiated on first use.
+	return instance;
+}
+
+StringInterner::StringInterner() : characters(0) {
+	strings.push_back("");
+	index[&strings.back()] = NO_STRING_ID;
+}
+
+StringId StringInterner::intern(const string & s) {
+	map<const string *, StringId, Less>::const_iterator it = index.find(&s);
+	if (it != index.end()) {
+		return it->second;
+	}
+	StringId id = strings.size();
+	strings.push_back(s);
+	index[&strings.back()] = id;
+	characters += s.size();
+	return id;
+}
+
+bool StringInterner::find(const string & s, StringId & id) const {
+	map<const string *, StringId, Less>::const_iterator it = index.find(&s);
+	if (it == index.end()) {
+		return false;
+	}
+	id = it->second;
+	return true;
+}
+
+const string & StringInterner::lookup(StringId id) const {
+	NS_ASSERT(id < strings.size());
+	return strings[id];
+}
+
+uint32_t StringInterner::size() const {
+	return strings.size();
+}
+
+size_t StringInterner::getMemoryUsage() const {
+	// strings, plus a red-black tree node (3 pointers, color, key, value) per index entry
+	return strings.size() * sizeof(string) + characters + index.size() * (4 * sizeof(void *) + sizeof(StringId) + sizeof(const string *));
+}
+
+} /* namespace ovnis */
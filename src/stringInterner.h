@@ -0,0 +1,86 @@
+/*
+ * stringInterner.h
+ *
+ *  Dense handles for the vehicle, edge, lane and route ids.
+ */
+
+#ifndef STRINGINTERNER_H_
+#define STRINGINTERNER_H_
+
+#include <cstdlib>
+#include <string>
+#include <deque>
+#include <map>
+#include <stdint.h>
+
+namespace ovnis {
+
+/**
+ * Handle of an interned string, the empty string being NO_STRING_ID.
+ */
+typedef uint32_t StringId;
+
+static const StringId NO_STRING_ID = 0;
+
+/**
+ * Process-wide table of the ids read from SUMO and from the packets.
+ *
+ * Ids are interned where they enter the simulation (TraCI answers, packet parsers)
+ * and the data structures are keyed by their handle: handles are compared and
+ * hashed as integers and, being dense, can index arrays. The string of a handle is
+ * only needed to talk to SUMO again or to log.
+ *
+ * Strings are stored once, in a deque so that the references given by lookup stay
+ * valid; the index from string to handle points into that storage.
+ */
+class StringInterner {
+public:
+	static StringInterner & getInstance(); // Guaranteed to be destroyed. Instantiated on first use.
+
+	/**
+	 * @return the handle of s, allocated at the first call with s.
+	 */
+	StringId intern(const std::string & s);
+	/**
+	 * @return false when s has never been interned: no data structure can then
+	 * hold it and a lookup by s can stop there.
+	 */
+	bool find(const std::string & s, StringId & id) const;
+	const std::string & lookup(StringId id) const;
+
+	uint32_t size() const;
+	/**
+	 * @return the approximate number of bytes used by the table.
+	 */
+	size_t getMemoryUsage() const;
+
+private:
+	StringInterner();
+	StringInterner(const StringInterner &); // Don't Implement
+	void operator =(const StringInterner &); // Don't implement
+
+	struct Less {
+		bool operator()(const std::string * a, const std::string * b) const {
+			return *a < *b;
+		}
+	};
+
+	std::deque<std::string> strings;
+	std::map<const std::string *, StringId, Less> index;
+	size_t characters;
+};
+
+/**
+ * Shortcuts for StringInterner::getInstance().intern() and lookup().
+ */
+inline StringId intern(const std::string & s) {
+	return StringInterner::getInstance().intern(s);
+}
+
+inline const std::string & lookup(StringId id) {
+	return StringInterner::getInstance().lookup(id);
+}
+
+} /* namespace ovnis */
+
+#endif /* STRINGINTERNER_H_ */
@@ -129,6 +129,7 @@ bool Query::ValidateResponse(Storage & responseMessage) {
 	}
 	catch (invalid_argument & e) {
 		cout << "Error while reading response: " << e.what();
+		return false;
 	}
 	if (responseStatus.getStatus() != RTYPE_OK) {
 		return false;
@@ -0,0 +1,84 @@
+/*
+ * routeChangesQuery.cpp
+ *
+ *  Changes of the routes of several vehicles, in a single message.
+ */
+
+#include "routeChangesQuery.h"
+
+using namespace std;
+using namespace tcpip;
+
+namespace ovnis {
+
+RouteChangesQuery::RouteChangesQuery(Socket * socket) :
+		VehicleQuery(socket, "", CMD_SET_VEHICLE_VARIABLE, VAR_ROUTE) {
+}
+
+RouteChangesQuery::~RouteChangesQuery() {
+}
+
+void RouteChangesQuery::AddChange(const string & vehicleId, const vector<string> & edges) {
+	changes.push_back(make_pair(vehicleId, edges));
+}
+
+int RouteChangesQuery::DoCommands() {
+	applied.assign(changes.size(), false);
+	if (changes.empty()) {
+		return 0;
+	}
+	InitializeCommand(requestCommand);
+	SendRequestAndReceiveResponse(requestCommand);
+	ReadResponse(responseStream);
+	int count = 0;
+	for (size_t i = 0; i < applied.size(); ++i) {
+		count += applied[i] ? 1 : 0;
+	}
+	return count;
+}
+
+bool RouteChangesQuery::IsApplied(size_t change) const {
+	return change < applied.size() && applied[change];
+}
+
+void RouteChangesQuery::WriteChanges(Storage & request) {
+	// the commands follow each other in the content, each with its own header
+	for (vector<pair<string, vector<string> > >::iterator it = changes.begin(); it != changes.end(); ++it) {
+		objectId = it->first;
+		Command change;
+		InitializeChangeEdgesCommand(change, TYPE_STRINGLIST, it->second);
+		request.writeStorage(change.Content());
+	}
+}
+
+void RouteChangesQuery::ReadStatuses(Storage & response) {
+	applied.assign(changes.size(), false);
+	vector<bool> statuses;
+	vector<string> descriptions;
+	while (response.valid_pos()) {
+		statuses.push_back(ValidateResponse(response) && responseStatus.getId() == commandId);
+		descriptions.push_back(responseStatus.getDescription());
+	}
+	if (statuses.size() != changes.size()) {
+		// the statuses do not tell which command they answer
+		cout << "#Error: " << statuses.size() << " statuses for " << changes.size() << " route changes, none is considered applied" << endl;
+		return;
+	}
+	for (size_t i = 0; i < changes.size(); ++i) {
+		applied[i] = statuses[i];
+		if (!applied[i]) {
+			cout << "Wrong response to the route change of " << changes[i].first << " " << descriptions[i] << endl;
+		}
+	}
+}
+
+void RouteChangesQuery::InitializeCommand(Command & command) {
+	command = Command(commandId);
+	WriteChanges(command.Content());
+}
+
+void RouteChangesQuery::ReadResponse(Storage & content) {
+	ReadStatuses(content);
+}
+
+} /* namespace ovnis */
@@ -0,0 +1,55 @@
+/*
+ * routeChangesQuery.h
+ *
+ *  Changes of the routes of several vehicles, in a single message.
+ */
+
+#ifndef ROUTECHANGESQUERY_H_
+#define ROUTECHANGESQUERY_H_
+
+#include "vehicleQuery.h"
+
+namespace ovnis {
+
+/**
+ * Sends a CMD_SET_VEHICLE_VARIABLE/VAR_ROUTE command per vehicle, all in one TraCI
+ * message, and reads the status SUMO answers to each of them, in the same order.
+ */
+class RouteChangesQuery : public VehicleQuery {
+public:
+	RouteChangesQuery(tcpip::Socket * socket);
+	virtual ~RouteChangesQuery();
+
+	void AddChange(const string & vehicleId, const vector<string> & edges);
+	/**
+	 * Sends the changes added.
+	 *
+	 * @return the number of changes SUMO applied.
+	 */
+	int DoCommands();
+	/**
+	 * @return whether SUMO applied the change added at position change.
+	 */
+	bool IsApplied(size_t change) const;
+
+	/**
+	 * Writes the commands of the changes added to request, in the order they were added.
+	 */
+	void WriteChanges(tcpip::Storage & request);
+	/**
+	 * Matches the statuses of response to the changes added, in order. A change is applied
+	 * if its status is RTYPE_OK. Should there not be a status per change, none of them can
+	 * be matched, and none is considered applied.
+	 */
+	void ReadStatuses(tcpip::Storage & response);
+
+private:
+	virtual void InitializeCommand(Command & command);
+	virtual void ReadResponse(tcpip::Storage & content);
+
+	vector<pair<string, vector<string> > > changes;
+	vector<bool> applied;
+};
+
+} /* namespace ovnis */
+#endif /* ROUTECHANGESQUERY_H_ */
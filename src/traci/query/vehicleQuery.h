@@ -19,12 +19,13 @@ public:
 	VehicleQuery(tcpip::Socket * socket, string vehicleId, int commandId = CMD_GET_VEHICLE_VARIABLE, int variableId = VAR_ROAD_ID);
 	virtual ~VehicleQuery();
 
+protected:
+	void InitializeChangeEdgesCommand(Command & command, int type, vector<string> edges);
+
 private:
 
     virtual void InitializeCommand(Command & command);
 	virtual void ReadResponse(tcpip::Storage & content);
-
-	void InitializeChangeEdgesCommand(Command & command, int type, vector<string> edges);
 };
 
 } /* namespace ovnis */
@@ -0,0 +1,59 @@
+/*
+ * routeChangeQueue.cpp
+ *
+ *  Changes of the routes of the vehicles, queued until the next simulation step.
+ */
+
+#include "routeChangeQueue.h"
+
+using namespace std;
+
+namespace ovnis {
+
+RouteChangeQueue::RouteChangeQueue() {
+}
+
+RouteChangeQueue::~RouteChangeQueue() {
+}
+
+void RouteChangeQueue::Add(const string & vehicleId, const vector<string> & edges, ns3::Callback<void, bool> done) {
+	RouteChange & change = queued[vehicleId];
+	change.edges = edges;
+	change.done = done;
+}
+
+void RouteChangeQueue::Cancel(const string & vehicleId) {
+	queued.erase(vehicleId);
+	for (vector<pair<string, ns3::Callback<void, bool> > >::iterator it = taken.begin(); it != taken.end(); ++it) {
+		if (it->first == vehicleId) {
+			it->second = ns3::Callback<void, bool>();
+		}
+	}
+}
+
+bool RouteChangeQueue::IsEmpty() const {
+	return queued.empty();
+}
+
+size_t RouteChangeQueue::Take(RouteChangesQuery & query) {
+	taken.clear();
+	for (map<string, RouteChange>::iterator it = queued.begin(); it != queued.end(); ++it) {
+		query.AddChange(it->first, it->second.edges);
+		taken.push_back(make_pair(it->first, it->second.done));
+	}
+	queued.clear();
+	return taken.size();
+}
+
+void RouteChangeQueue::Report(const RouteChangesQuery & query) {
+	// a callback may cancel the changes of the vehicles after it, but not add to taken
+	for (size_t i = 0; i < taken.size(); ++i) {
+		ns3::Callback<void, bool> done = taken[i].second;
+		if (!done.IsNull()) {
+			done(query.IsApplied(i));
+		}
+	}
+	taken.clear();
+}
+
+} /* namespace ovnis */
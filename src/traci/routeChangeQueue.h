@@ -0,0 +1,62 @@
+/*
+ * routeChangeQueue.h
+ *
+ *  Changes of the routes of the vehicles, queued until the next simulation step.
+ */
+
+#ifndef ROUTECHANGEQUEUE_H_
+#define ROUTECHANGEQUEUE_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ns3/callback.h"
+#include "traci/query/routeChangesQuery.h"
+
+namespace ovnis {
+
+/**
+ * Keeps the latest change of route of each vehicle, until it is taken into a
+ * RouteChangesQuery, and then reports to each vehicle whether SUMO applied it.
+ */
+class RouteChangeQueue {
+public:
+	RouteChangeQueue();
+	virtual ~RouteChangeQueue();
+
+	/**
+	 * Queues the change of the route of vehicleId to edges, in place of the change queued
+	 * for it before if any, whose callback is then not called.
+	 */
+	void Add(const std::string & vehicleId, const std::vector<std::string> & edges, ns3::Callback<void, bool> done);
+	/**
+	 * Drops the change queued for vehicleId, if any, and the callback of its change being
+	 * sent, so that a vehicle can cancel from its destructor.
+	 */
+	void Cancel(const std::string & vehicleId);
+	bool IsEmpty() const;
+	/**
+	 * Adds the changes queued to query, in the order of the vehicle ids, and empties the
+	 * queue.
+	 *
+	 * @return the number of changes added.
+	 */
+	size_t Take(RouteChangesQuery & query);
+	/**
+	 * Calls the callback of each change taken with whether query applied it. The callbacks
+	 * may queue changes, which are taken by the next query.
+	 */
+	void Report(const RouteChangesQuery & query);
+
+private:
+	struct RouteChange {
+		std::vector<std::string> edges;
+		ns3::Callback<void, bool> done;
+	};
+	std::map<std::string, RouteChange> queued; // by vehicle
+	std::vector<std::pair<std::string, ns3::Callback<void, bool> > > taken; // vehicle and callback, in the order of the query
+};
+
+} /* namespace ovnis */
+#endif /* ROUTECHANGEQUEUE_H_ */
@@ -12,6 +12,7 @@
 #include "traci/query/simStepQuery.h"
 #include "traci/query/subscribeQuery.h"
 #include "traci/query/vehicleQuery.h"
+#include "traci/query/routeChangesQuery.h"
 #include "traci/query/edgeQuery.h"
 #include "traci/query/laneQuery.h"
 #include "traci/query/closeQuery.h"
@@ -68,7 +69,7 @@ int SumoTraciConnection::StartSumo(string config, string sumoPath, string output
 	int sumoPort;
 	string configPath = outputFolder+config;
 	cout << "Reading config file " << configPath << endl;
-	XMLSumoConfParser::parseConfiguration(configPath, &sumoPort, boundaries);
+	XMLSumoConfParser::parseConfiguration(configPath, &sumoPort, boundaries, &roadGraph);
 	this->port = sumoPort;
 	if (this->port == 0) {
 		this->port = SUMO_PORT;
@@ -109,12 +110,29 @@ void SumoTraciConnection::SubscribeSimulation(int startTime, int stopTime) {
 }
 
 void SumoTraciConnection::NextSimStep(vector<string> & departedVehicles, vector<string> & arrivedVehicles) {
+	FlushVehicleEdges();
 	stepQuery.DoCommand();
 	currentTime = stepQuery.GetCurrentTime();
 	departedVehicles = stepQuery.getDepartedVehicles();
 	arrivedVehicles = stepQuery.getArrivedVehicles();
 }
 
+void SumoTraciConnection::NextSimStep(vector<StringId> & departedVehicles, vector<StringId> & arrivedVehicles) {
+	FlushVehicleEdges();
+	stepQuery.DoCommand();
+	currentTime = stepQuery.GetCurrentTime();
+	const vector<string> & departed = stepQuery.getDepartedVehicles();
+	const vector<string> & arrived = stepQuery.getArrivedVehicles();
+	departedVehicles.clear();
+	for (vector<string>::const_iterator it = departed.begin(); it != departed.end(); ++it) {
+		departedVehicles.push_back(intern(*it));
+	}
+	arrivedVehicles.clear();
+	for (vector<string>::const_iterator it = arrived.begin(); it != arrived.end(); ++it) {
+		arrivedVehicles.push_back(intern(*it));
+	}
+}
+
 double SumoTraciConnection::GetVehicleSpeed(string vehicleId) {
 	VehicleQuery vehicleQuery(&socket, vehicleId, CMD_GET_VEHICLE_VARIABLE, VAR_SPEED);
 	vehicleQuery.DoCommand();
@@ -201,6 +219,25 @@ void SumoTraciConnection::ChangeVehicleEdges(string vehicleId, vector<string> ed
 	vehicleQuery.DoCommand();
 }
 
+void SumoTraciConnection::ChangeVehicleEdges(const string & vehicleId, const vector<string> & edges, ns3::Callback<void, bool> done) {
+	routeChanges.Add(vehicleId, edges, done);
+}
+
+void SumoTraciConnection::CancelVehicleEdges(const string & vehicleId) {
+	routeChanges.Cancel(vehicleId);
+}
+
+void SumoTraciConnection::FlushVehicleEdges() {
+	if (routeChanges.IsEmpty()) {
+		return;
+	}
+	RouteChangesQuery query(&socket);
+	routeChanges.Take(query);
+	query.DoCommands();
+	// the callbacks may queue changes, for the next step
+	routeChanges.Report(query);
+}
+
 double SumoTraciConnection::GetVehicleAngle(string vehicleId) {
 	VehicleQuery vehicleQuery(&socket, vehicleId, CMD_GET_VEHICLE_VARIABLE, VAR_ANGLE);
 	vehicleQuery.DoCommand();
@@ -241,6 +278,10 @@ vector<double> SumoTraciConnection::GetSimulationBoundaries() {
 	return simQuery.getVectorResponse();
 }
 
+const RoadGraph & SumoTraciConnection::GetRoadGraph() const {
+	return roadGraph;
+}
+
 /**
  * Closes the connection, quits the simulator, frees any stale
  * resource and makes all Vehicle instances inactive.
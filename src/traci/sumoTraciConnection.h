@@ -17,12 +17,16 @@
 #include "traci/socket.h"
 #include "traci/query/simStepQuery.h"
 #include "traci/query/simulationQuery.h"
+#include "traci/routeChangeQueue.h"
+#include "stringInterner.h"
+#include "roadGraph.h"
 #include <limits.h>
 #include <iomanip>
 #include <fstream>
 #include <sstream>
 #include <ctime>
 #include <cstdlib>
+#include <map>
 #include "ns3/core-module.h"
 #include "ns3/object.h"
 
@@ -38,6 +42,10 @@ public:
 	void RunServer(std::string sumoConfig, std::string host, std::string sumoPath, int port, std::string outputFolder);
 	void SubscribeSimulation(int startTime, int stopTime);
 	void NextSimStep(std::vector<std::string> & departedVehicles, std::vector<std::string> & arrivedVehicles);
+	/**
+	 * Same as above, the ids of the vehicles being interned as they are decoded.
+	 */
+	void NextSimStep(std::vector<StringId> & departedVehicles, std::vector<StringId> & arrivedVehicles);
 	const int GetCurrentTime() const;
 	void Close();
 
@@ -51,6 +59,21 @@ public:
     std::string GetVehicleRouteId(std::string vehicleId);
     std::vector<std::string> GetVehicleEdges(std::string vehicleId);
     void ChangeVehicleEdges(std::string vehicleId, std::vector<std::string> edges);
+    /**
+     * Queues the change of the route of vehicleId to edges, in place of the change queued
+     * for it before if any, whose callback is then not called. The changes queued are
+     * sent in a single message just before the next simulation step, see
+     * FlushVehicleEdges(), and done is then called with whether SUMO applied the change.
+     */
+    void ChangeVehicleEdges(const std::string & vehicleId, const std::vector<std::string> & edges, ns3::Callback<void, bool> done);
+    /**
+     * Drops the change queued for vehicleId, if any, without calling its callback.
+     */
+    void CancelVehicleEdges(const std::string & vehicleId);
+    /**
+     * Sends the changes of routes queued, and reports their results.
+     */
+    void FlushVehicleEdges();
     double GetVehicleAngle(std::string vehicleId);
     Position2D GetVehiclePosition(std::string vehicleId);
     int GetVehicleCount(std::string vehicleId);
@@ -60,6 +83,10 @@ public:
 	void CloseLane(std::string laneId);
 	void CloseEdge(std::string edgeId);
 	std::vector<double> GetSimulationBoundaries();
+	/**
+	 * The network read from the net file of the configuration when SUMO was started.
+	 */
+	const RoadGraph & GetRoadGraph() const;
 
 protected:
     /**
@@ -83,6 +110,10 @@ protected:
 	 */
     double boundaries[2];
 
+    RoadGraph roadGraph;
+
+    RouteChangeQueue routeChanges;
+
     tcpip::Socket socket;
 
     int currentTime;
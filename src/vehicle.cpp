@@ -13,7 +13,7 @@ using namespace std;
 
 namespace ovnis {
 
-	Vehicle::Vehicle() {
+	Vehicle::Vehicle() : scenario(Create<Network>()), reroutePending(false) {
 		initialize("", Simulator::Now().GetSeconds());
 	}
 
@@ -29,6 +29,9 @@ namespace ovnis {
 	}
 
 	Vehicle::~Vehicle() {
+		if (reroutePending) {
+			traci->CancelVehicleEdges(id);
+		}
 	}
 
 	string Vehicle::getId() {
@@ -39,26 +42,20 @@ namespace ovnis {
 		return this->start;
 	}
 
-	void Vehicle::setScenario(Network scenario) {
-		this->scenario.setAlternativeRoutes(scenario.getAlternativeRoutes());
-		this->scenario.setDecisionEdges(scenario.getDecisionEdges());
-		this->scenario.setNotificationEdges(scenario.getNotificationEdges());
-		for (map<string,Route>::iterator it = getAlternativeRoutes().begin(); it != getAlternativeRoutes().end(); ++it) {
-			it->second.computeLength();
-			it->second.computeStaticCost();
-		}
+	void Vehicle::setScenario(Ptr<const Network> scenario) {
+		this->scenario = scenario;
 	}
 
-	Network & Vehicle::getScenario() {
-		return this->scenario;
+	const Network & Vehicle::getScenario() {
+		return *this->scenario;
 	}
 
 	Itinerary & Vehicle::getItinerary() {
 		return this->itinerary;
 	}
 
-	map<string, Route> & Vehicle::getAlternativeRoutes() {
-		return this->scenario.getAlternativeRoutes();
+	const map<string, Route> & Vehicle::getAlternativeRoutes() {
+		return this->scenario->getAlternativeRoutes();
 	}
 
     string Vehicle::getDestinationEdgeId() {
@@ -78,12 +75,16 @@ namespace ovnis {
     }
 
 	void Vehicle::requestRoute(string routeId) {
-		double routeDepartureTime = Simulator::Now().GetSeconds();
 		if (routeId=="") {
 			routeId = traci->GetVehicleRouteId(id);
 		}
+		setRoute(routeId, traci->GetVehicleEdges(id));
+	}
+
+	void Vehicle::setRoute(string routeId, const vector<string> & edges) {
+		double routeDepartureTime = Simulator::Now().GetSeconds();
 		itinerary.setId(routeId);
-		currentRoute = Route(routeId, traci->GetVehicleEdges(id));
+		currentRoute = Route(routeId, edges);
 		if (currentRoute.getEdgeIds().size() > 0) {
 			string newEdge = currentRoute.getEdgeIds()[0];
 			if (itinerary.getCurrentEdge().getId() == "" || newEdge != itinerary.getCurrentEdge().getId()) {
@@ -153,25 +154,55 @@ namespace ovnis {
 
 	void Vehicle::reroute(string routeId) {
 		vector<string> reroute = vector<string>();
-		try {
-			vector<string> chosenRoute = getAlternativeRoutes()[routeId].getEdgeIds();
-			bool metCurrentEdge = false;
-			for (vector<string>::iterator it = chosenRoute.begin(); it != chosenRoute.end(); ++it) {
-				if (itinerary.getCurrentEdge().getId().compare(*it)==0) {
-					metCurrentEdge = true;
-				}
-				if (metCurrentEdge) {
-					reroute.push_back(*it);
-				}
+		map<string, Route>::const_iterator itRoute = getAlternativeRoutes().find(routeId);
+		static const vector<string> noRoute;
+		const vector<string> & chosenRoute = itRoute == getAlternativeRoutes().end() ? noRoute : itRoute->second.getEdgeIds();
+		bool metCurrentEdge = false;
+		for (vector<string>::const_iterator it = chosenRoute.begin(); it != chosenRoute.end(); ++it) {
+			if (itinerary.getCurrentEdge().getId().compare(*it)==0) {
+				metCurrentEdge = true;
+			}
+			if (metCurrentEdge) {
+				reroute.push_back(*it);
 			}
-			traci->ChangeVehicleEdges(id, reroute);
-			requestRoute(routeId);
 		}
-		catch (TraciException & e) {
+		this->reroute(routeId, reroute);
+	}
+
+	void Vehicle::reroute(string routeId, const vector<string> & edges) {
+		if (edges.empty()) {
+			// not an alternative, or not from the current edge
+			return;
+		}
+		reroutePending = true;
+		pendingRouteId = routeId;
+		pendingEdges = edges;
+		traci->ChangeVehicleEdges(id, edges, MakeCallback(&Vehicle::onRerouted, this));
+	}
+
+	void Vehicle::setRerouteCallback(Callback<void, string, bool> rerouted) {
+		this->rerouted = rerouted;
+	}
+
+	void Vehicle::onRerouted(bool applied) {
+		string routeId = pendingRouteId;
+		reroutePending = false;
+		if (applied) {
+			// the edges sent are those SUMO now has, no need to ask for them
+			setRoute(routeId, pendingEdges);
+		}
+		else {
 			cerr << "Cannot reroute vehicle " << id << " from " << routeId << ": " << endl;
 			cerr << currentRoute.printRoute();
 			cerr << "to:" << endl;
-			cerr << e.what() << endl;
+			for (vector<string>::const_iterator it = pendingEdges.begin(); it != pendingEdges.end(); ++it) {
+				cerr << *it << " ";
+			}
+			cerr << endl;
+		}
+		pendingEdges.clear();
+		if (!rerouted.IsNull()) {
+			rerouted(routeId, applied);
 		}
 	}
 
@@ -196,9 +227,11 @@ namespace ovnis {
 	map<string, double> Vehicle::getSumoCosts(string startEdgeId) {
 		map<string, double> sumoCosts;
 		string endEdgeId = getDestinationEdgeId();
-		for (map<string, Route>::iterator itRoutes = scenario.getAlternativeRoutes().begin(); itRoutes != scenario.getAlternativeRoutes().end(); ++itRoutes) {
-			for (vector<string>::iterator itEdges = itRoutes->second.getEdgeIds().begin(); itEdges != itRoutes->second.getEdgeIds().end(); ++itEdges) {
-				if (itRoutes->second.containsEdgeExcludedMargins(*itEdges, startEdgeId, endEdgeId)) {
+		StringId startEdge = intern(startEdgeId);
+		StringId endEdge = intern(endEdgeId);
+		for (map<string, Route>::const_iterator itRoutes = getAlternativeRoutes().begin(); itRoutes != getAlternativeRoutes().end(); ++itRoutes) {
+			for (vector<string>::const_iterator itEdges = itRoutes->second.getEdgeIds().begin(); itEdges != itRoutes->second.getEdgeIds().end(); ++itEdges) {
+				if (itRoutes->second.containsEdgeExcludedMargins(intern(*itEdges), startEdge, endEdge)) {
 					if (sumoCosts.find(*itEdges) == sumoCosts.end()) {
 						// add info about the edge
 						sumoCosts[*itEdges] = traci->GetEdgeTravelTime(*itEdges);
@@ -22,6 +22,7 @@
 #include <stdint.h>
 
 #include "ns3/ptr.h"
+#include "ns3/callback.h"
 
 #include "scenario.h"
 #include "route.h"
@@ -45,11 +46,14 @@ public:
 
     std::string getId();
 
-    Network & getScenario();
-    void setScenario(Network scenario);
+    const Network & getScenario();
+    /**
+     * @param scenario shared by the vehicles, see Network::share().
+     */
+    void setScenario(Ptr<const Network> scenario);
 
     ovnis::Itinerary & getItinerary();
-	std::map<std::string, Route> & getAlternativeRoutes();
+	const std::map<std::string, Route> & getAlternativeRoutes();
 	string getDestinationEdgeId();
 	string getOriginEdgeId();
 
@@ -69,7 +73,22 @@ public:
 
     std::vector<std::string> getEdgesAhead();
 
+    /**
+     * Queues the change of the route to the alternative routeId, from the current edge
+     * on. The change is sent to SUMO with those of the other vehicles just before the
+     * next simulation step, and the route is updated once SUMO applied it.
+     */
     void reroute(std::string routeId);
+    /**
+     * Queues the change of the route to edges, from the current edge on, as reroute()
+     * does. Nothing is queued when edges is empty.
+     */
+    void reroute(std::string routeId, const std::vector<std::string> & edges);
+    /**
+     * @param rerouted called with the id of the route and whether SUMO applied the
+     * change, for each reroute().
+     */
+    void setRerouteCallback(Callback<void, std::string, bool> rerouted);
 
 	double getEdgeTravelTime(std::string edgeId);
 	map<std::string, double> getSumoCosts(std::string startEdgeId);
@@ -83,12 +102,18 @@ protected:
     Position2D currentPosition;
     double currentSpeed;
     double start;
-    Network scenario;
+    Ptr<const Network> scenario;
     Route currentRoute ;
     Itinerary itinerary;
     void requestRoute(std::string routeId);
+    void setRoute(std::string routeId, const std::vector<std::string> & edges);
+    void onRerouted(bool applied);
 
 private:
+    bool reroutePending; // a reroute() not applied yet
+    std::string pendingRouteId;
+    std::vector<std::string> pendingEdges;
+    Callback<void, std::string, bool> rerouted;
 
 };
 
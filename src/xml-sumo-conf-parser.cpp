@@ -42,11 +42,35 @@ using namespace std;
 
 using namespace xercesc;
 
+namespace {
+
+/**
+ * @return the value of the attribute name, empty if it is not set.
+ */
+string getAttribute(const Attributes& attrs, const char * name)
+{
+	XMLCh* q = XMLString::transcode(name);
+	const XMLCh* value = attrs.getValue(q);
+	XMLString::release(&q);
+	if (value == 0)
+	{
+		return "";
+	}
+	char* b = XMLString::transcode(value);
+	string s(b);
+	XMLString::release(&b);
+	return s;
+}
+
+}
+
 XMLSumoConfParser::XMLSumoConfParser()
 {
 	is_net_file_name = false;
 	is_location = false;
 	is_port=false;
+	graph = 0;
+	edge = ovnis::RoadGraph::NOT_FOUND;
 }
 
 void
@@ -87,6 +111,24 @@ XMLSumoConfParser::startElement(const XMLCh* const uri, const XMLCh* const local
 		XMLString::release(&b);
 		XMLString::release(&q);
 	}
+	if (graph != 0 && "edge" == name)
+	{
+		edge = ovnis::RoadGraph::NOT_FOUND;
+		if (getAttribute(attrs, "function") != "internal")
+		{
+			edge = graph->addEdge(ovnis::intern(getAttribute(attrs, "id")),
+					ovnis::intern(getAttribute(attrs, "from")), ovnis::intern(getAttribute(attrs, "to")));
+		}
+	}
+	if (graph != 0 && "lane" == name && edge != ovnis::RoadGraph::NOT_FOUND)
+	{
+		graph->addLane(edge, atof(getAttribute(attrs, "length").c_str()), atof(getAttribute(attrs, "speed").c_str()));
+	}
+	if (graph != 0 && "junction" == name && getAttribute(attrs, "type") != "internal")
+	{
+		graph->addJunction(ovnis::intern(getAttribute(attrs, "id")),
+				atof(getAttribute(attrs, "x").c_str()), atof(getAttribute(attrs, "y").c_str()));
+	}
 	XMLString::release(&message);
 }
 
@@ -118,7 +160,7 @@ XMLSumoConfParser::characters(const XMLCh* const xMLCh, const unsigned int xMLSi
 }
 
 void
-XMLSumoConfParser::parseConfiguration(const string & filename, int * p, double* bound)
+XMLSumoConfParser::parseConfiguration(const string & filename, int * p, double* bound, ovnis::RoadGraph * graph)
 {
 
   string base = filename.substr(0, filename.find_last_of('/'));
@@ -143,6 +185,7 @@ XMLSumoConfParser::parseConfiguration(const string & filename, int * p, double*
   XMLSumoConfParser* defaultHandler = new XMLSumoConfParser();
   defaultHandler->port = p;
   defaultHandler->boundaries = bound;
+  defaultHandler->graph = graph;
   parser->setContentHandler(defaultHandler);
   parser->setErrorHandler(defaultHandler);
 
@@ -41,6 +41,8 @@
 
 #include<xercesc/sax2/Attributes.hpp>
 
+#include "roadGraph.h"
+
 using namespace std;
 using namespace xercesc;
 
@@ -67,13 +69,20 @@ public:
  //                                        ,const  XMLSize_t);
 
 
-  static void parseConfiguration(const string & filename, int * port, double* boundaries);
+  /**
+   * Reads the port and the boundaries from the configuration and its net file, and the
+   * junctions, edges and lanes of the net file into graph unless it is null. The
+   * internal edges of the junctions are left out.
+   */
+  static void parseConfiguration(const string & filename, int * port, double* boundaries, ovnis::RoadGraph * graph = 0);
 
 
 
   std::string net_file_name;
   int * port;
   double * boundaries;
+  ovnis::RoadGraph * graph;
+  uint32_t edge; // edge of the lanes being read, NOT_FOUND if internal
 
 bool is_location;
 bool is_net_file_name;
@@ -119,12 +119,8 @@ void DssApplication::StartApplication(void) {
 	// ns3
 	mobilityModel = GetNode()->GetObject<ConstantVelocityMobilityModel>();
 	ToggleNeighborDiscovery(true);
-	Ptr<SocketFactory> socketFactory = GetNode()->GetObject<UdpSocketFactory> ();
-	m_socket = socketFactory->CreateSocket();
-	m_socket->Connect(InetSocketAddress (Ipv4Address::GetBroadcast(), m_port));
-	m_socket->SetAllowBroadcast(true);
+	m_socket = CreateBroadcastSocket(m_port);
 	m_socket->SetRecvCallback(MakeCallback(&DssApplication::ReceivePacket, this));
-	m_socket->Bind(InetSocketAddress(Ipv4Address::GetAny(), m_port));
 
 	// start simualtion
 	running = true;
@@ -136,12 +132,10 @@ void DssApplication::StartApplication(void) {
 
 void DssApplication::ToggleNeighborDiscovery(bool on) {
 	if (on) {
-		std::ostringstream oss;
-		oss << "/NodeList/" << GetNode()->GetId() << "/DeviceList/*/$ns3::WifiNetDevice/Mac/$ns3::BeaconingAdhocWifiMac/NeighborLost";
-		Config::Connect(oss.str(), MakeCallback(&DssApplication::NeighborLost, this));
-		std::ostringstream oss2;
-		oss2 << "/NodeList/" << GetNode()->GetId() << "/DeviceList/*/$ns3::WifiNetDevice/Mac/$ns3::BeaconingAdhocWifiMac/NewNeighbor";
-		Config::Connect(oss2.str(), MakeCallback(&DssApplication::NewNeighborFound, this));
+		m_neighborTable = OvnisNeighborTable::Install(GetNode());
+	}
+	else {
+		m_neighborTable = 0;
 	}
 }
 
@@ -151,6 +145,7 @@ void DssApplication::StopApplication(void) {
 
 void DssApplication::DoDispose(void) {
 	running = false;
+	ToggleNeighborDiscovery(false);
 	double now = Simulator::Now().GetSeconds();
 	if (m_socket != NULL) {
 		m_socket->Close();
@@ -221,61 +216,4 @@ void DssApplication::ReceivePacket(Ptr<Socket> socket) {
 	}
 }
 
-/**
- * Neighborhood discovery
- */
-void DssApplication::NeighborLost(std::string context, Ptr<const Packet> packet, Mac48Address addr){
-	// Find the nodeId that has been called
-	size_t aux = context.find("/",10);
-	std::string strIndex = context.substr(10,aux-10);
-	// Convert the index to integer
-	int index = atoi (strIndex.c_str());
-	// Get the node (my node)
-	Ptr<Node> node = ns3::NodeList::GetNode(index);
-	//Get the application
-	Ptr <Application> app = node->GetApplication(0);
-	Ptr<DssApplication> myApp = DynamicCast<DssApplication>(app);
-
-	MacAddrMapIterator i = myApp->m_neighborList.find (addr);
-	if (i == myApp->m_neighborList.end ()){
-		// update the beacon index
-		NS_LOG_DEBUG("ERROR. Trying to delete an unexisting neighbor");
-	}
-	else {
-		myApp->m_neighborList.erase(i);
-	}
-
-	if (vehicle.getId() == "0.5") {
-		std::cout << vehicle.getId() << "," << " lost a neighbor: " << addr << ", power: " << " number of neighbors: " << m_neighborList.size() << ", context: " << context << std::endl;
-	}
-}
-
-/**
- * Neighborhood discovery
- */
-void DssApplication::NewNeighborFound(std::string context, Ptr<const Packet> packet, Mac48Address addr, double rxPwDbm) {
-	// Find the nodeId that has been called
-	size_t aux =context.find("/",10);
-	std::string strIndex = context.substr(10,aux-10);
-	// Convert the index to integer
-	int index = atoi (strIndex.c_str());
-	// Get the node
-	Ptr<Node> node = ns3::NodeList::GetNode(index);
-	//Get the application
-	Ptr <Application> app = node->GetApplication(0);
-	Ptr<DssApplication> myApp = DynamicCast<DssApplication>(app);
-	MacAddrMapIterator i = myApp->m_neighborList.find (addr);
-	if (i== myApp->m_neighborList.end ()) {
-		// include the reception power
-		myApp->m_neighborList[addr] = rxPwDbm;
-	}
-	else {
-		i->second= rxPwDbm;
-	}
-	if (vehicle.getId() == "0.5") {
-//		packet->Print(cout) ;
-		std::cout << vehicle.getId() << "," <<  " discovered a neighbor: " << addr << ", power: " << " number of neighbors: " << m_neighborList.size() << ", packet.size: " << packet->GetSize() << ", packet.serializedSize: " << packet->GetSerializedSize()<< std::endl;
-	}
-}
-
 }
@@ -66,6 +66,7 @@
 #include "ovnisPacket.h"
 #include "applications/trafficInformationSystem.h"
 #include "applications/dissemination/dissemination.h"
+#include "devices/wifi/ovnis-neighbor-table.h"
 
 using namespace std;
 
@@ -81,12 +82,6 @@ namespace ns3
     DssApplication();
     virtual ~DssApplication();
 
-    // neighborhood discovery
-    void NewNeighborFound(std::string context, Ptr<const Packet> packet, Mac48Address addr, double rxPwDbm);
-    void NeighborLost(std::string context, Ptr<const Packet> packet, Mac48Address addr);
-    typedef	std::map <Mac48Address,uint16_t> MacAddrMap;
-    typedef std::map<Mac48Address, uint16_t>::iterator MacAddrMapIterator;
-
   protected:
 
     virtual void DoDispose(void);
@@ -141,9 +136,10 @@ namespace ns3
     Vehicle vehicle;
 
     /**
-	 * Connects the callback for the neighbor discovery service
+	 * Gets the neighbor table shared by the node, see OvnisNeighborTable
 	 */
 	void ToggleNeighborDiscovery(bool on);
+	Ptr<OvnisNeighborTable> m_neighborTable;
 
     void InitializeScenario();
     /**
@@ -167,8 +163,6 @@ namespace ns3
 
     const std::vector<std::string> split(std::string sentence);
 
-    MacAddrMap m_neighborList;
-
     std::map<long,int> packets; // packets counter
 
   };
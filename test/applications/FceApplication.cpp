@@ -29,6 +29,7 @@
 #include <sstream>
 #include <iostream>
 #include <iterator>
+#include <algorithm>
 
 #include "ns3/application.h"
 #include "ns3/boolean.h"
@@ -57,6 +58,7 @@
 #include "ns3/tag-buffer.h"
 #include "ns3/udp-socket-factory.h"
 #include "ns3/inet-socket-address.h"
+#include "ns3/packet-socket-address.h"
 #include "ns3/wifi-net-device.h"
 #include "ns3/config.h"
 #include "ns3/integer.h"
@@ -95,88 +97,154 @@ FceApplication::FceApplication() {
 	startReroute = 0;
 	isVanet = true;
 	_neighborCount = 0;
-	m_params["vanetKnowlegePenetrationRate"] = "1"; // re rest uses global ideal knowledge;
-	m_params["vanetDisseminationPenetrationRate"] = "1"; // PENETRATION_RATE;
-	m_params["cheatersRatio"] = "0"; // CHEATER_RATE; // always shortest
-	m_params["accidentStartTime"] = "300"; // ACCIDENT_START_TIME;
-	m_params["accidentStopTime"] = "1300"; // ACCIDENT_END_TIME;
-	m_params["networkId"] = "Highway"; // "Kirchberg";
-	m_params["routingStrategies"] = "noRouting,shortest,probabilistic,hybrid";
-	m_params["routingStrategiesProbabilities"] = "0,1,0,0"; // no-routing - uninformed drivers,
-	m_params["costFunctions"] = "travelTime,congestionLength,delayTime";
-	m_params["costFunctionProbabilities"] = "1,0,0";
+	m_stateInBeacons = false;
 }
 
-void FceApplication::InitializeParams() {
-	for (map<string, string>::iterator i = _applicationParams.begin(); i != _applicationParams.end(); ++i) {
-		m_params[i->first] = i->second;
+FceApplication::Config::Config(const map<string,string> & applicationParams) : applicationParams(applicationParams) {
+	map<string,string> params;
+	map<string,string>::const_iterator network = applicationParams.find("networkId");
+	params["networkId"] = network != applicationParams.end() ? network->second : "Highway"; // "Kirchberg";
+	// routes of the original experiments, by their SUMO route id, and their capacities
+	if (params["networkId"] == "Highway") {
+		params["decisionEdge"] = "pre_2";
+		params["notificationEdge"] = "main_6 bypass_3";
+		params["routes"] = "main:pre_1 pre_2 main_1 main_2a main_2b main_3a main_3b main_4a main_4b main_5a main_5b main_6;"
+				"bypass:pre_1 pre_2 bypass_1 bypass_2 bypass_3";
+		params["routesCapacity"] = "900,1500";
+	}
+	else if (params["networkId"] == "Kirchberg") {
+		params["decisionEdge"] = "56640729#5";
+		params["notificationEdge"] = "53349130#1";
+		params["routes"] =
+				// kennedy
+				"routedist#0:56640729#0 56640729#1 56640729#2 56640729#3 56640729#4 56640729#5 56640728#0 56640728#1 56640728#2 56640728#3 56640728#4 56640728#5 56640728#6 56640728#7 56640728#8 55444662 23595095#0 23595095#1 53349130#0 53349130#1;"
+				// asenauer
+				"routedist#1:56640729#0 56640729#1 56640729#2 56640729#3 56640729#4 56640729#5 56640724#0 56640724#1 56640724#2 56640724#3 56640724#4 48977754#0 48977754#1 48977754#2 48977754#3 48977754#4 48977754#5 95511865#0 95511865#1 126603964 -149693909#2 -149693909#1 -149693909#0 -149693907 49248917#0 49248917#1 149693908 126603969 53349130#0 53349130#1;"
+				// thuengen
+				"routedist#2:56640729#0 56640729#1 56640729#2 56640729#3 56640729#4 56640729#5 95511899 95511885#0 95511885#1 95511885#2 95511885#3 95511885#4 95511885#5 -50649897 -37847306#1 56640728#8 55444662 23595095#0 23595095#1 53349130#0 53349130#1";
+		params["routesCapacity"] = "1000,600,800";
+	}
+	else {
+		params["decisionEdge"] = "";
+		params["notificationEdge"] = "";
+		params["routes"] = ""; // generated
+		params["routesCapacity"] = "";
+	}
+	params["stateInBeacons"] = "true"; // vehicle state piggybacked on the MAC beacons
+	params["vanetKnowlegePenetrationRate"] = "1"; // re rest uses global ideal knowledge;
+	params["vanetDisseminationPenetrationRate"] = "1"; // PENETRATION_RATE;
+	params["cheatersRatio"] = "0"; // CHEATER_RATE; // always shortest
+	params["accidentStartTime"] = "300"; // ACCIDENT_START_TIME;
+	params["accidentStopTime"] = "1300"; // ACCIDENT_END_TIME;
+	params["alternatives"] = "3"; // routes generated to each notification edge, for a network without routes
+	params["alternativesCapacity"] = "1000";
+	params["routingStrategies"] = "noRouting,shortest,probabilistic,hybrid,dynamic";
+	params["routingStrategiesProbabilities"] = "0,1,0,0,0"; // no-routing - uninformed drivers, dynamic - shortest path from the decision edge
+	params["costFunctions"] = "travelTime,congestionLength,delayTime";
+	params["costFunctionProbabilities"] = "1,0,0";
+	for (map<string, string>::const_iterator i = applicationParams.begin(); i != applicationParams.end(); ++i) {
+		params[i->first] = i->second;
 	}
 	Log::getInstance().getStream("scenarioSettings") << "--------------------------" << endl;
-	for (map<string, string>::iterator i = m_params.begin(); i != m_params.end(); ++i) {
+	for (map<string, string>::iterator i = params.begin(); i != params.end(); ++i) {
 		Log::getInstance().getStream("scenarioSettings") << i->first << "\t" << i->second << endl;
 	}
 
-	// select routing strategy
-	m_params["routingStrategy"] = "hybrid";
-	vector<string> routingStrategies = CommonHelper::split(m_params["routingStrategies"], ',');
-	vector<string> routingStrategiesProbabilities = CommonHelper::split(m_params["routingStrategiesProbabilities"], ',');
+	stateInBeacons = params["stateInBeacons"] == "true";
+	vanetKnowledgePenetrationRate = atof(params["vanetKnowlegePenetrationRate"].c_str());
+	vanetDisseminationPenetrationRate = atof(params["vanetDisseminationPenetrationRate"].c_str());
+	cheatersRatio = atof(params["cheatersRatio"].c_str());
+	accidentStartTime = atof(params["accidentStartTime"].c_str());
+	accidentStopTime = atof(params["accidentStopTime"].c_str());
+	networkId = params["networkId"];
+	decisionEdge = params["decisionEdge"];
+	notificationEdge = params["notificationEdge"];
+	alternatives = atoi(params["alternatives"].c_str());
+	alternativesCapacity = atof(params["alternativesCapacity"].c_str());
+	vector<string> routes = CommonHelper::split(params["routes"], ';');
+	vector<string> capacities = CommonHelper::split(params["routesCapacity"], ',');
+	for (size_t i = 0; i < routes.size(); ++i) {
+		size_t separator = routes[i].find(':');
+		routeIds.push_back(routes[i].substr(0, separator));
+		routeEdges.push_back(separator == string::npos ? "" : routes[i].substr(separator + 1));
+		routeCapacities.push_back(i < capacities.size() ? atof(capacities[i].c_str()) : alternativesCapacity);
+	}
+	costFunction = params["costFunction"];
+
+	vector<string> routingStrategies = CommonHelper::split(params["routingStrategies"], ',');
+	vector<string> probabilities = CommonHelper::split(params["routingStrategiesProbabilities"], ',');
 	int i = 0;
-	map<string, double> probabilities;
 	for (vector<string>::iterator it =  routingStrategies.begin(); it != routingStrategies.end(); ++it) {
-		probabilities[*it] = atof(routingStrategiesProbabilities[i].c_str());
+		routingStrategiesProbabilities[*it] = atof(probabilities[i].c_str());
 //		string routingStrategy = *it;
 //		probabilities[routingStrategy] = 1.0;
-		Log::getInstance().getStream("scenarioSettings") << " strategy: " << *it << ",probability: " << probabilities[*it] << "\t";
+		Log::getInstance().getStream("scenarioSettings") << " strategy: " << *it << ",probability: " << routingStrategiesProbabilities[*it] << "\t";
 		++i;
 	}
-	m_params["routingStrategy"] = TIS::getInstance().getEvent(probabilities);
-	Log::getInstance().getStream("scenarioSettings") << "\nSelected routing strategy " << m_params["routingStrategy"] << endl;
-	Log::getInstance().getStream("selectedStrategies") << m_params["routingStrategy"] << endl;
-	SetNetwork(m_params["networkId"]);
+	Log::getInstance().getStream("scenarioSettings") << endl;
 }
 
-/**
- * TODO read from an external config file
- */
-void FceApplication::SetNetwork(string networkId) {
-	string decisionEdge = "";
-	string notificationEdge = "";
-	map<string, Route> alternativeRoutes = map<string, Route>();
-	vector<string> route_ids = vector<string>();
-	vector<double> route_capacities = vector<double>();
-	vector<string> route_strategies = vector<string>();
-	if (networkId == "Highway") {
-		alternativeRoutes["bypass"] = Route("bypass", "");
-		decisionEdge = "pre_2";
-		notificationEdge = "main_6 bypass_3";
-		route_ids.push_back("main");
-		route_ids.push_back("bypass");
-		route_capacities.push_back(900);
-		route_capacities.push_back(1500);
-		route_strategies.push_back("pre_1 pre_2 main_1 main_2a main_2b main_3a main_3b main_4a main_4b main_5a main_5b main_6");
-		route_strategies.push_back("pre_1 pre_2 bypass_1 bypass_2 bypass_3");
-	}
-	else if (networkId == "Kirchberg") {
-		decisionEdge = "56640729#5";
-		notificationEdge = "53349130#1";
-		route_ids.push_back("routedist#0"); // kennedy
-		route_ids.push_back("routedist#1"); // asenauer
-		route_ids.push_back("routedist#2"); // thuengen
-		route_capacities.push_back(1000);
-		route_capacities.push_back(600);
-		route_capacities.push_back(800);
-		route_strategies.push_back("56640729#0 56640729#1 56640729#2 56640729#3 56640729#4 56640729#5 56640728#0 56640728#1 56640728#2 56640728#3 56640728#4 56640728#5 56640728#6 56640728#7 56640728#8 55444662 23595095#0 23595095#1 53349130#0 53349130#1");
-		route_strategies.push_back("56640729#0 56640729#1 56640729#2 56640729#3 56640729#4 56640729#5 56640724#0 56640724#1 56640724#2 56640724#3 56640724#4 48977754#0 48977754#1 48977754#2 48977754#3 48977754#4 48977754#5 95511865#0 95511865#1 126603964 -149693909#2 -149693909#1 -149693909#0 -149693907 49248917#0 49248917#1 149693908 126603969 53349130#0 53349130#1");
-		route_strategies.push_back("56640729#0 56640729#1 56640729#2 56640729#3 56640729#4 56640729#5 95511899 95511885#0 95511885#1 95511885#2 95511885#3 95511885#4 95511885#5 -50649897 -37847306#1 56640728#8 55444662 23595095#0 23595095#1 53349130#0 53349130#1");
+Ptr<const FceApplication::Config> FceApplication::GetConfig(const map<string,string> & applicationParams) {
+	static Ptr<const Config> config; // the params are those of the run, the same for all the vehicles
+	if (config == 0 || config->applicationParams != applicationParams) {
+		config = Create<Config>(applicationParams);
 	}
-	int i = 0;
-	for (vector<string>::iterator it = route_ids.begin(); it < route_ids.end(); ++it, ++i) {
-		alternativeRoutes[*it] = Route(*it, route_strategies[i]);
-		alternativeRoutes[*it].setCapacity(route_capacities[i]);
+	return config;
+}
+
+void FceApplication::InitializeParams() {
+	m_config = GetConfig(_applicationParams);
+
+	// select routing strategy
+	m_routingStrategy = TIS::getInstance().getEvent(m_config->routingStrategiesProbabilities);
+	Log::getInstance().getStream("scenarioSettings") << "Selected routing strategy " << m_routingStrategy << endl;
+	Log::getInstance().getStream("selectedStrategies") << m_routingStrategy << endl;
+}
+
+Ptr<const Network> FceApplication::GetNetwork(const Config & config) {
+	const string & networkId = config.networkId;
+	Ptr<const Network> shared = Network::find(networkId);
+	if (shared != 0) {
+		return shared;
+	}
+	map<string, Route> alternativeRoutes = map<string, Route>();
+	vector<string> targets = CommonHelper::split(config.notificationEdge, ' ');
+	for (size_t i = 0; i < config.routeIds.size(); ++i) {
+		Route & route = alternativeRoutes[config.routeIds[i]] = Route(config.routeIds[i], config.routeEdges[i]);
+		route.setCapacity(config.routeCapacities[i]);
+	}
+	if (alternativeRoutes.empty()) {
+		GenerateAlternativeRoutes(config, targets, alternativeRoutes);
+	}
+	Ptr<Network> network = Create<Network>();
+	network->setDecisionEdges(CommonHelper::split(config.decisionEdge, ' '));
+	network->setNotificationEdges(targets);
+	network->setAlternativeRoutes(alternativeRoutes);
+	return Network::share(networkId, network);
+}
+
+void FceApplication::GenerateAlternativeRoutes(const Config & config, const vector<string> & targets, map<string, Route> & alternativeRoutes) {
+	const RoutingEngine & engine = TIS::getInstance().getRoutingEngine();
+	const RoadGraph & graph = engine.getGraph();
+	// on the static costs, the travel times heard being weighed at each decision
+	vector<double> staticCosts;
+	graph.getStaticCosts(staticCosts);
+	uint32_t source = graph.getEdge(intern(config.decisionEdge));
+	for (vector<string>::const_iterator it = targets.begin(); it != targets.end(); ++it) {
+		uint32_t target = graph.getEdge(intern(*it));
+		if (source == RoadGraph::NOT_FOUND || target == RoadGraph::NOT_FOUND) {
+			cerr << "#Error: no edge " << config.decisionEdge << " or " << *it << " in the network of " << config.networkId << endl;
+			continue;
+		}
+		vector<RoutingEngine::Path> alternatives;
+		engine.getAlternatives(staticCosts, source, target, config.alternatives, alternatives);
+		for (size_t i = 0; i < alternatives.size(); ++i) {
+			stringstream routeId;
+			routeId << config.networkId << "#" << alternativeRoutes.size();
+			Route & route = alternativeRoutes[routeId.str()] = Route(routeId.str(), engine.toString(alternatives[i]));
+			route.setCapacity(config.alternativesCapacity);
+		}
 	}
-	network.setDecisionEdges(CommonHelper::split(decisionEdge, ' '));
-	network.setNotificationEdges(CommonHelper::split(notificationEdge, ' '));
-	network.setAlternativeRoutes(alternativeRoutes);
 }
 
 FceApplication::~FceApplication() {
@@ -193,7 +261,8 @@ void FceApplication::StartApplication(void) {
 	string vehicleId = Names::FindName(GetNode());
 	vehicle.initialize(vehicleId, Simulator::Now().GetSeconds());
 	Log::getInstance().getStream("scenarioSettings") << "vehicleId\t" << vehicle.getId() << endl;
-	vehicle.setScenario(network);
+	vehicle.setScenario(GetNetwork(*m_config));
+	vehicle.setRerouteCallback(MakeCallback(&FceApplication::OnRerouted, this));
 
 	// add to the centralised Traffic Information System vehicle's routes (edges) of interest
 	TIS::getInstance().initializeStaticTravelTimes(vehicle.getScenario().getAlternativeRoutes());
@@ -201,12 +270,8 @@ void FceApplication::StartApplication(void) {
 	// ns3
 	mobilityModel = GetNode()->GetObject<ConstantVelocityMobilityModel>();
 	ToggleNeighborDiscovery(true);
-	Ptr<SocketFactory> socketFactory = GetNode()->GetObject<UdpSocketFactory> ();
-	m_socket = socketFactory->CreateSocket();
-	m_socket->Connect(InetSocketAddress (Ipv4Address::GetBroadcast(), m_port));
-	m_socket->SetAllowBroadcast(true);
+	m_socket = CreateBroadcastSocket(m_port);
 	m_socket->SetRecvCallback(MakeCallback(&FceApplication::ReceivePacket, this));
-	m_socket->Bind(InetSocketAddress(Ipv4Address::GetAny(), m_port));
 
 	// start simualtion
 	running = true;
@@ -214,19 +279,24 @@ void FceApplication::StartApplication(void) {
 	double r2 = (double)(rand()%RAND_MAX)/(double)RAND_MAX * TRAFFIC_INFORMATION_SENDING_INTERVAL;
 //	cout << "r " << r << " r2 " << r2 << endl;
 //	m_trafficInformationEvent = Simulator::Schedule(Seconds(0), &FceApplication::SendTrafficInformation, this);
-	m_neighborInformationEvent = Simulator::Schedule(Seconds(r<r2?r:r2), &FceApplication::SendNeighborInformation, this);
+	Ptr<BeaconingAdhocWifiMac> mac = GetBeaconingMac();
+	m_stateInBeacons = m_config->stateInBeacons && mac != 0;
+	if (m_stateInBeacons) {
+		mac->RegisterBeaconPayload(MakeCallback(&FceApplication::FillBeaconPayload, this), MakeCallback(&FceApplication::ReceiveBeaconPayload, this));
+	}
+	else {
+		m_neighborInformationEvent = Simulator::Schedule(Seconds(r<r2?r:r2), &FceApplication::SendNeighborInformation, this);
+	}
 	m_simulationEvent = Simulator::Schedule(Seconds(r<r2?r2:r), &FceApplication::SimulationRun, this);
 
 }
 
 void FceApplication::ToggleNeighborDiscovery(bool on) {
 	if (on) {
-		std::ostringstream oss;
-		oss << "/NodeList/" << GetNode()->GetId() << "/DeviceList/*/$ns3::WifiNetDevice/Mac/$ns3::BeaconingAdhocWifiMac/NeighborLost";
-		Config::Connect(oss.str(), MakeCallback(&FceApplication::NeighborLost, this));
-		std::ostringstream oss2;
-		oss2 << "/NodeList/" << GetNode()->GetId() << "/DeviceList/*/$ns3::WifiNetDevice/Mac/$ns3::BeaconingAdhocWifiMac/NewNeighbor";
-		Config::Connect(oss2.str(), MakeCallback(&FceApplication::NewNeighborFound, this));
+		m_neighborTable = OvnisNeighborTable::Install(GetNode());
+	}
+	else {
+		m_neighborTable = 0;
 	}
 }
 
@@ -236,6 +306,13 @@ void FceApplication::StopApplication(void) {
 
 void FceApplication::DoDispose(void) {
 	running = false;
+	ToggleNeighborDiscovery(false);
+	if (m_stateInBeacons) {
+		Ptr<BeaconingAdhocWifiMac> mac = GetBeaconingMac();
+		if (mac != 0) {
+			mac->UnregisterBeaconPayload();
+		}
+	}
 	double now = Simulator::Now().GetSeconds();
 	if (m_socket != NULL) {
 		m_socket->Close();
@@ -245,23 +322,20 @@ void FceApplication::DoDispose(void) {
 	OvnisApplication::DoDispose();
 }
 
-FceApplication::MacAddrMap FceApplication::getNeighborList() {
+Ptr<OvnisNeighborTable> FceApplication::getNeighborList() {
+	m_neighborTable->Purge();
 	if (vehicle.getId() == "1.7" || vehicle.getId() == "0.2") {
-//		cout << Simulator::Now().GetSeconds() << " vehicle " << vehicle.getId() << " has " << m_neighborList.size() << " neighbors and received ovnis packets: " << _neighborCount << endl;
 		cout << Simulator::Now().GetSeconds() << " vehicle " << vehicle.getId() << " has " << _neighborCount << " neighbors: ";
-		for (map<string,neighbor>::iterator i = _neighbors.begin(); i != _neighbors.end (); ++i) {
-//			std::cout << i->first << ":" << i->second.id << "," << i->second.speed << "\t";
-			std::cout << i->first << "\t";
+		Time since = Simulator::Now() - Seconds(SIMULATION_STEP_INTERVAL);
+		for (OvnisNeighborTable::Iterator i = m_neighborTable->Begin(); i != m_neighborTable->End(); ++i) {
+			if (i->lastHeard >= since) {
+				std::cout << lookup(i->vehicleId) << "\t";
+			}
 		}
 		cout << endl;
 	}
-	_neighbors = map<string,neighbor>();
 	_neighborCount = 0;
-//	for (MacAddrMapIterator i = m_neighborList.begin(); i != m_neighborList.end (); ++i) {
-//		std::cout << i->first << "," << i->second << "\t";
-//	}
-//	cout << endl;
-	return m_neighborList;
+	return m_neighborTable;
 }
 
 void FceApplication::SimulationRun(void) {
@@ -281,17 +355,20 @@ void FceApplication::SimulationRun(void) {
 			if (isDecisionPoint && !decisionTaken) {
 				isDense = false;
 				isCongested = false;
-				map<string, double> cost = EstimateTravelCostBasedOnCentralised(now, currentEdgeId);
-				// vanets
-				double vanetKnowledgeRatio = atof(m_params["vanetKnowlegePenetrationRate"].c_str());
-				double r = (double)(rand()%RAND_MAX)/(double)RAND_MAX;
-				isVanet =  r < vanetKnowledgeRatio;
-				if (isVanet) {
-					cost = EstimateTravelCostBasedOnVanets(now, currentEdgeId, m_params["costFunction"]);
+				if (m_routingStrategy == "dynamic") {
+					RouteDynamically(now, currentEdgeId);
+				}
+				else {
+					map<string, double> cost = EstimateTravelCostBasedOnCentralised(now, currentEdgeId);
+					// vanets
+					double r = (double)(rand()%RAND_MAX)/(double)RAND_MAX;
+					isVanet =  r < m_config->vanetKnowledgePenetrationRate;
+					if (isVanet) {
+						cost = EstimateTravelCostBasedOnVanets(now, currentEdgeId, m_config->costFunction);
+					}
+					routeChoice = ChooseRoute(now, currentEdgeId, cost, m_routingStrategy, m_config->cheatersRatio);
+					vehicle.reroute(routeChoice);
 				}
-				double cheatersRatio = atof(m_params["cheatersRatio"].c_str());
-				routeChoice = ChooseRoute(now, currentEdgeId, cost, m_params["routingStrategy"], cheatersRatio);
-				vehicle.reroute(routeChoice);
 			}
 
 			// if approaching the point that we want to evaluate
@@ -308,6 +385,13 @@ void FceApplication::SimulationRun(void) {
 	}
 }
 
+/**
+ * SUMO applied, or not, the route chosen, just before the simulation step following the decision.
+ */
+void FceApplication::OnRerouted(string routeId, bool applied) {
+	Log::getInstance().getStream("rerouting") << Simulator::Now().GetSeconds() << "\t" << vehicle.getId() << "\t" << routeId << "\t" << (applied ? "applied" : "failed") << endl;
+}
+
 /**
  * The vehicle is entering a new edge it has already traced the time on its itinerary.
  * Broadcast information about it and about travel time on the last edge
@@ -336,11 +420,11 @@ map<string, double> FceApplication::EstimateTravelCostBasedOnVanets(double now,
 	string endEdgeId = vehicle.getDestinationEdgeId();
 	// for shortest we need to reset (do dynamic value)
 	map<string,double> routeTTL;
-	for (map<string,Route>::iterator it = vehicle.getScenario().getAlternativeRoutes().begin(); it != vehicle.getScenario().getAlternativeRoutes().end(); ++it) {
+	for (map<string,Route>::const_iterator it = vehicle.getScenario().getAlternativeRoutes().begin(); it != vehicle.getScenario().getAlternativeRoutes().end(); ++it) {
 		routeTTL[it->first] = PACKET_TTL;
 	}
-	if (m_params["routingStrategy"] == "shortest") {
-		for (map<string,Route>::iterator it = vehicle.getScenario().getAlternativeRoutes().begin(); it != vehicle.getScenario().getAlternativeRoutes().end(); ++it) {
+	if (m_routingStrategy == "shortest") {
+		for (map<string,Route>::const_iterator it = vehicle.getScenario().getAlternativeRoutes().begin(); it != vehicle.getScenario().getAlternativeRoutes().end(); ++it) {
 			routeTTL[it->first] = TIS::getInstance().computeStaticCostExcludingMargins(it->first, currentEdgeId, endEdgeId) * (1+ CONGESTION_THRESHOLD);
 //			routeTTL[it->first] = TIS::getInstance().computeStaticCostExcludingMargins(it->first, currentEdge, endEdgeId);
 //			routeTTL[it->first] = 120;
@@ -379,7 +463,7 @@ string FceApplication::ChooseRoute(double now, string currentEdgeId, map<string,
 	bool needProbabilistic = isCongested;
 	//	needProbabilistic = isCongested || isDense;
 	//	needProbabilistic = vanetsKnowledge.getSumDelay() > 0;
-	//	bool isAccident = now > m_params["accidentStartTime"] && now < m_params["accidentStopTime"];
+	//	bool isAccident = now > m_config->accidentStartTime && now < m_config->accidentStopTime;
 	//	needProbabilistic = isAccident;
 	TIS::getInstance().setCongestion(needProbabilistic, isDense, isCongested);
 
@@ -440,6 +524,65 @@ string FceApplication::ChooseRoute(double now, string currentEdgeId, map<string,
 	return routeChoice;
 }
 
+void FceApplication::RouteDynamically(double now, string currentEdgeId) {
+	double r = (double)(rand()%RAND_MAX)/(double)RAND_MAX;
+	isVanet =  r < m_config->vanetKnowledgePenetrationRate;
+	// customized with the travel times reported to the TIS at most every ROUTING_CUSTOMIZATION_INTERVAL
+	const RoutingEngine & engine = TIS::getInstance().getRoutingEngine();
+	const RoadGraph & graph = engine.getGraph();
+	uint32_t source = graph.getEdge(intern(currentEdgeId));
+	uint32_t target = graph.getEdge(intern(vehicle.getDestinationEdgeId()));
+	RoutingEngine::Path path;
+	bool found = false;
+	if (source != RoadGraph::NOT_FOUND && target != RoadGraph::NOT_FOUND) {
+		if (isVanet) {
+			// the hierarchy is shared, the travel times heard by the vehicle are searched directly
+			vector<double> weights;
+			vanetsKnowledge.getEdgeWeights(graph, weights);
+			found = engine.astar(weights, source, target, path);
+		}
+		else {
+			found = engine.query(source, target, path);
+		}
+	}
+
+	startReroute = now;
+	decisionEdgeId = currentEdgeId;
+	decisionTaken = true;
+	isCheater = false;
+	if (!found) {
+		cerr << "#Error: no route for vehicle " << vehicle.getId() << " from " << currentEdgeId << " to " << vehicle.getDestinationEdgeId() << endl;
+		routeChoice = vehicle.getItinerary().getId();
+		return;
+	}
+	vector<string> edges;
+	for (vector<uint32_t>::const_iterator it = path.edges.begin(); it != path.edges.end(); ++it) {
+		edges.push_back(lookup(graph.getEdgeId(*it)));
+	}
+	routeChoice = FindAlternativeRoute(edges);
+	selfishExpectedTravelTime = path.cost;
+	expectedTravelTime = path.cost;
+
+	Log::getInstance().getStream("scenarioSettings") << "chosen routingStrategy\t" << m_routingStrategy << endl;
+	Log::getInstance().getStream("scenarioSettings") << "routeChoice\t" << routeChoice << "\t" << engine.toString(path) << endl;
+	TIS::getInstance().reportStartingRoute(vehicle.getId(), currentEdgeId, vehicle.getItinerary().getId(), currentEdgeId,
+			routeChoice, vehicle.getOriginEdgeId(), vehicle.getDestinationEdgeId(), isCheater,
+			false, expectedTravelTime, selfishExpectedTravelTime);
+	vehicle.reroute(routeChoice, edges);
+}
+
+string FceApplication::FindAlternativeRoute(const vector<string> & edges) {
+	const map<string, Route> & routes = vehicle.getScenario().getAlternativeRoutes();
+	for (map<string, Route>::const_iterator it = routes.begin(); it != routes.end(); ++it) {
+		const vector<string> & routeEdges = it->second.getEdgeIds();
+		vector<string>::const_iterator first = find(routeEdges.begin(), routeEdges.end(), edges.front());
+		if (routeEdges.end() - first == (long) edges.size() && equal(first, routeEdges.end(), edges.begin())) {
+			return it->first;
+		}
+	}
+	return "dynamic";
+}
+
 /**
  * Report to TIS the total travel time on the route between the decision edge and the current edge
  */
@@ -457,7 +600,7 @@ void FceApplication::OnReporting(double now, string currentEdgeId) {
 				<< vehicle.getItinerary().computeStaticCostExcludingMargins(vehicle.getItinerary().getEdgeIds()[0], currentEdgeId) << "\t" << vehicle.getItinerary().computeLength() << "[m]" << endl;
 		TIS::getInstance().reportEndingRoute(vehicle.getId(), routeId, decisionEdgeId, currentEdgeId,
 				startReroute, travelTime, isCheater, selfishExpectedTravelTime, expectedTravelTime, neededProbabilistic,
-				m_params["routingStrategy"], vehicle.getStart());
+				m_routingStrategy, vehicle.getStart(), vehicle.getItinerary().computeStaticCostExcludingMargins(decisionEdgeId, currentEdgeId));
 		notificationSent = true;
 	}
 }
@@ -533,10 +676,63 @@ void FceApplication::SendNeighborInformation(void) {
 //		}
 		Ptr<Packet> p = OvnisPacket::BuildPacket(Simulator::Now().GetSeconds(), vehicle.getId(), position.x, position.y, STATE_PACKET_ID, vehicle.getItinerary().getCurrentEdge().getId(), vehicle.getCurrentSpeed());
 		SendPacket(p);
-		m_neighborInformationEvent = Simulator::Schedule(Seconds(NEIGHBOR_INFORMATION_SENDING_INTERVAL), &FceApplication::SendNeighborInformation, this);
+		m_neighborInformationEvent = Simulator::Schedule(Seconds(NEIGHBOR_INFORMATION_SENDING_INTERVAL * GetDccIntervalFactor()), &FceApplication::SendNeighborInformation, this);
+	}
+}
+
+double FceApplication::GetDccIntervalFactor() {
+	Ptr<OvnisDcc> dcc = GetNode()->GetObject<OvnisDcc>();
+	return dcc == 0 ? 1 : dcc->GetIntervalFactor();
+}
+
+Ptr<BeaconingAdhocWifiMac> FceApplication::GetBeaconingMac() {
+	if (GetNode() == 0 || GetNode()->GetNDevices() == 0) {
+		return 0;
+	}
+	Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice>(GetNode()->GetDevice(0));
+	if (device == 0) {
+		return 0;
+	}
+	return DynamicCast<BeaconingAdhocWifiMac>(device->GetMac());
+}
+
+void FceApplication::FillBeaconPayload(BeaconPayloadHeader & payload) {
+	if (running == true) {
+		Vector position = mobilityModel->GetPosition();
+		payload.SetSenderId(vehicle.getId());
+		payload.SetPosition(position.x, position.y);
+		payload.SetEdgeId(vehicle.getItinerary().getCurrentEdge().getId());
+		payload.SetSpeed(vehicle.getCurrentSpeed());
+		// counted as the STATE_PACKET_ID packet it replaces
+		Log::getInstance().packetSent();
+		Log::getInstance().nextPacketId();
 	}
 }
 
+void FceApplication::ReceiveBeaconPayload(Mac48Address from, const BeaconPayloadHeader & payload, const OvnisRxContext & context) {
+	if (payload.GetSenderId().empty()) {
+		return;
+	}
+	Vector position = mobilityModel->GetPosition();
+	double dx = payload.GetX() - position.x;
+	double dy = payload.GetY() - position.y;
+	const vector<BeaconPayloadHeader::Record> & records = payload.GetRecords();
+	for (vector<BeaconPayloadHeader::Record>::const_iterator it = records.begin(); it != records.end(); ++it) {
+		Data data;
+		data.edgeId = intern(it->edgeId);
+		data.travelTime = it->travelTime;
+		data.date = it->date;
+		vanetsKnowledge.record(data);
+	}
+	string senderId = payload.GetSenderId();
+	_neighborCount ++;
+	if (m_neighborTable != 0) {
+		m_neighborTable->UpdateVehicle(from, intern(senderId), Vector(payload.GetX(), payload.GetY(), 0), payload.GetSpeed());
+	}
+	Log::getInstance().packetReceived();
+	Log::getInstance().addDistance(sqrt(dx * dx + dy * dy));
+}
+
 void FceApplication::SendTrafficInformation(void) {
 	if (running == true) {
 		Vector position = mobilityModel->GetPosition();
@@ -548,7 +744,7 @@ void FceApplication::SendTrafficInformation(void) {
 //			}
 			SendPacket(p);
 		}
-		m_trafficInformationEvent = Simulator::Schedule(Seconds(TRAFFIC_INFORMATION_SENDING_INTERVAL), &FceApplication::SendTrafficInformation, this);
+		m_trafficInformationEvent = Simulator::Schedule(Seconds(TRAFFIC_INFORMATION_SENDING_INTERVAL * GetDccIntervalFactor()), &FceApplication::SendTrafficInformation, this);
 	}
 }
 
@@ -595,7 +791,7 @@ void FceApplication::ReceivePacket(Ptr<Socket> socket) {
 			double numberOfVehiclesOnTheCurrentEdge = vanetsKnowledge.addNumberOfVehicles(currentEdge);
 			Data data;
 			data.date = packetDate;
-			data.edgeId = lastEdge;
+			data.edgeId = intern(lastEdge);
 			data.travelTime = travelTime;
 			vanetsKnowledge.record(data);
 
@@ -606,8 +802,24 @@ void FceApplication::ReceivePacket(Ptr<Socket> socket) {
 		}
 
 		_neighborCount ++;
-		_neighbors[senderId].id = senderId;
-		_neighbors[senderId].speed = 1.0;
+		if (m_neighborTable != 0) {
+			StringId sender = intern(senderId);
+			const OvnisNeighborTable::Entry * known = m_neighborTable->Find(sender);
+			double speed = known != 0 ? known->speed : 0;
+			if (ovnisPacket.getPacketType() == STATE_PACKET_ID) {
+				ovnisPacket.readString(); // edge id
+				speed = ovnisPacket.readDouble();
+			}
+			Position2D senderPosition = ovnisPacket.getPosition();
+			if (PacketSocketAddress::IsMatchingType(neighborMacAddress)) {
+				// received without the internet stack, the sender address is known
+				Mac48Address from = Mac48Address::ConvertFrom(PacketSocketAddress::ConvertFrom(neighborMacAddress).GetPhysicalAddress());
+				m_neighborTable->UpdateVehicle(from, sender, Vector(senderPosition.x, senderPosition.y, 0), speed);
+			}
+			else {
+				m_neighborTable->UpdateVehicle(sender, Vector(senderPosition.x, senderPosition.y, 0), speed);
+			}
+		}
 		Log::getInstance().packetReceived();
 		Log::getInstance().addDistance(distance);
     }
@@ -616,61 +828,4 @@ void FceApplication::ReceivePacket(Ptr<Socket> socket) {
 	}
 }
 
-/**
- * Neighborhood discovery
- */
-void FceApplication::NeighborLost(std::string context, Ptr<const Packet> packet, Mac48Address addr){
-	// Find the nodeId that has been called
-	size_t aux = context.find("/",10);
-	std::string strIndex = context.substr(10,aux-10);
-	// Convert the index to integer
-	int index = atoi (strIndex.c_str());
-	// Get the node (my node)
-	Ptr<Node> node = ns3::NodeList::GetNode(index);
-	//Get the application
-	Ptr <Application> app = node->GetApplication(0);
-	Ptr<FceApplication> myApp = DynamicCast<FceApplication>(app);
-
-	MacAddrMapIterator i = myApp->m_neighborList.find (addr);
-	if (i == myApp->m_neighborList.end ()){
-		// update the beacon index
-		NS_LOG_DEBUG("ERROR. Trying to delete an unexisting neighbor");
-	}
-	else {
-		myApp->m_neighborList.erase(i);
-	}
-
-//	if (vehicle.getId() == "0.5") {
-//		std::cout << vehicle.getId() << "," << " lost a neighbor: " << addr << ", power: " << " number of neighbors: " << m_neighborList.size() << ", context: " << context << std::endl;
-//	}
-}
-
-/**
- * Neighborhood discovery
- */
-void FceApplication::NewNeighborFound(std::string context, Ptr<const Packet> packet, Mac48Address addr, double rxPwDbm) {
-	// Find the nodeId that has been called
-	size_t aux =context.find("/",10);
-	std::string strIndex = context.substr(10,aux-10);
-	// Convert the index to integer
-	int index = atoi (strIndex.c_str());
-	// Get the node
-	Ptr<Node> node = ns3::NodeList::GetNode(index);
-	//Get the application
-	Ptr <Application> app = node->GetApplication(0);
-	Ptr<FceApplication> myApp = DynamicCast<FceApplication>(app);
-	MacAddrMapIterator i = myApp->m_neighborList.find (addr);
-	if (i== myApp->m_neighborList.end ()) {
-		// include the reception power
-		myApp->m_neighborList[addr] = rxPwDbm;
-	}
-	else {
-		i->second= rxPwDbm;
-	}
-//	if (vehicle.getId() == "0.5") {
-//	packet->Print(cout) ;
-//	std::cout << vehicle.getId() << "," <<  " discovered a neighbor: " << addr << ", power: " << " number of neighbors: " << m_neighborList.size() << ", packet.size: " << packet->GetSize() << ", packet.serializedSize: " << packet->GetSerializedSize()<< std::endl;
-//	}
-}
-
 }
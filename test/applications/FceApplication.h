@@ -66,6 +66,10 @@
 #include "ovnisPacket.h"
 #include "applications/trafficInformationSystem.h"
 #include "applications/dissemination/dissemination.h"
+#include "devices/wifi/beaconing-adhoc-wifi-mac.h"
+#include "devices/wifi/ovnis-dcc.h"
+#include "devices/wifi/ovnis-neighbor-table.h"
+#include "common/beaconPayload-header.h"
 
 using namespace std;
 
@@ -82,24 +86,14 @@ namespace ns3
     virtual ~FceApplication();
 
     // neighborhood discovery
-    void NewNeighborFound(std::string context, Ptr<const Packet> packet, Mac48Address addr, double rxPwDbm);
-    void NeighborLost(std::string context, Ptr<const Packet> packet, Mac48Address addr);
-    typedef	std::map <Mac48Address,uint16_t> MacAddrMap;
-    typedef std::map<Mac48Address, uint16_t>::iterator MacAddrMapIterator;
-    MacAddrMap getNeighborList();
-
-    typedef struct n {
-      string id;
-      double speed;
-    } neighbor;
+    Ptr<OvnisNeighborTable> getNeighborList();
 
   protected:
 
     virtual void DoDispose(void);
 
   private:
-    int _neighborCount;
-    std::map<std::string, neighbor> _neighbors;
+    int _neighborCount; // packets received from neighbors since the last simulation step
 
     /**
      * Inherited from Application base class.
@@ -122,6 +116,19 @@ namespace ns3
 
     void SendNeighborInformation(void);
 
+    /**
+     * Vehicle state carried by the MAC beacons (see BeaconingAdhocWifiMac::RegisterBeaconPayload)
+     * instead of STATE_PACKET_ID packets, when the "stateInBeacons" parameter is "true".
+     */
+    bool m_stateInBeacons;
+    Ptr<BeaconingAdhocWifiMac> GetBeaconingMac();
+    /**
+     * Factor applied to the sending intervals by the ns3::OvnisDcc of the node, 1 without.
+     */
+    double GetDccIntervalFactor();
+    void FillBeaconPayload(BeaconPayloadHeader & payload);
+    void ReceiveBeaconPayload(Mac48Address from, const BeaconPayloadHeader & payload, const OvnisRxContext & context);
+
     /**
      * Specifies an algorithm for data dissemination.
      * Criteria for:
@@ -141,8 +148,8 @@ namespace ns3
     /**
 	 * Neighbour discovery
 	 */
-	void ToggleNeighborDiscovery(bool on); // Connects the callback for the neighbor discovery service
-    MacAddrMap m_neighborList;
+	void ToggleNeighborDiscovery(bool on); // Gets the neighbor table shared by the node
+	Ptr<OvnisNeighborTable> m_neighborTable;
 
     /**
      * Physical information about a vehicle, such as position, current speed. It's connected to SUMO with TraCi in both way (reading and writing).
@@ -153,18 +160,53 @@ namespace ns3
     Vehicle vehicle;
 
 	/**
-	 * Scenario settings
+	 * Scenario settings, parsed once per run from the application params
+	 */
+	struct Config : public SimpleRefCount<Config> {
+		Config(const map<string,string> & applicationParams);
+
+		map<string,string> applicationParams; // as given
+		bool stateInBeacons; // vehicle state piggybacked on the MAC beacons
+		double vanetKnowledgePenetrationRate; // the rest uses global ideal knowledge
+		double vanetDisseminationPenetrationRate;
+		double cheatersRatio; // always shortest
+		double accidentStartTime;
+		double accidentStopTime;
+		string networkId;
+		string decisionEdge; // where the routes of the network start
+		string notificationEdge; // where they end, one or several edges
+		vector<string> routeIds; // of the routes of the network, by their SUMO route id, none if generated
+		vector<string> routeEdges; // of each route
+		vector<double> routeCapacities; // of each route
+		int alternatives; // routes generated to each notification edge
+		double alternativesCapacity; // of each route generated
+		string costFunction;
+		map<string,double> routingStrategiesProbabilities;
+	};
+	/**
+	 * @return the settings of applicationParams, parsed and logged at the first call.
 	 */
-	map<string,string> m_params;
+	static Ptr<const Config> GetConfig(const map<string,string> & applicationParams);
+	Ptr<const Config> m_config;
+	string m_routingStrategy; // drawn for each vehicle
     void InitializeParams();
     /**
      * Abstraction of a single network from a GPS advice.
      * Contains a set of alternative routes between two points, called decision edges and notification edges.
      * All routes have information about maximum speed, capacity, length.
      * To initialize a vehicle with the scenario.
+     *
+     * The routes of a network are those of its config, as the SUMO routes of the original
+     * experiments, or else generated by GenerateAlternativeRoutes().
+     *
+     * @return the network of config, built at the first call and shared by the vehicles.
+     */
+    static Ptr<const Network> GetNetwork(const Config & config);
+    /**
+     * Adds to alternativeRoutes the alternatives found by the routing engine of the TIS, on
+     * the static costs, from the decision edge of config to each of targets.
      */
-    Network network;
-    void SetNetwork(std::string networkId);
+    static void GenerateAlternativeRoutes(const Config & config, const vector<string> & targets, map<string, Route> & alternativeRoutes);
 
     /**
      * Routing settings
@@ -186,9 +228,21 @@ namespace ns3
 	string decisionEdgeId;
 	void CalculateError(string currentEdgeId);
 	void OnEdgeChanged(double now, string currentEdgeId);
+	void OnRerouted(string routeId, bool applied);
 	map<string, double> EstimateTravelCostBasedOnCentralised(double now, string currentEdgeId);
 	map<string, double> EstimateTravelCostBasedOnVanets(double now, string currentEdgeId, string costFunction);
 	string ChooseRoute(double now, string currentEdgeId, map<string, double> routeCost, string routingStrategy, double cheatersRatio);
+	/**
+	 * Routes the vehicle from currentEdgeId to its destination by the shortest path of
+	 * the routing engine, for the travel times reported to the TIS, or those heard by the
+	 * vehicle if it uses the VANET knowledge.
+	 */
+	void RouteDynamically(double now, string currentEdgeId);
+	/**
+	 * @return the alternative route of the scenario that follows edges from their first
+	 * edge on, "dynamic" if none does.
+	 */
+	string FindAlternativeRoute(const vector<string> & edges);
 	map<string, double> AnalyseRouteCorrelation();
 	void OnReporting(double now, string currentEdgeId);
 
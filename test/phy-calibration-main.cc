@@ -0,0 +1,207 @@
+/**
+ *
+ *
+ * Copyright (c) 2010-2011 University of Luxembourg
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *
+ * @file phy-calibration-main.cc
+ *
+ * Calibration of the link level phy (ns3::OvnisLinkWifiPhy) against the full
+ * phy (ns3::OvnisWifiPhy). A sender broadcasts frames to receivers placed
+ * every distanceStep meters on a line, optionally disturbed by an interferer.
+ * The same scenario is run with both phys and the packet delivery ratio of
+ * each distance is printed with the difference between the two models.
+ *
+ */
+
+//
+// ----- Global includes
+#include <iostream>
+#include <vector>
+#include <cmath>
+
+//
+// ----- NS-3 related includes
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/command-line.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/wifi-phy.h"
+#include "ns3/wifi-mode.h"
+#include "ns3/error-rate-model.h"
+//
+// ----- application related includes
+#include "helper/ovnis-wifi-helper.h"
+#include "devices/wifi/ovnis-wifi-channel.h"
+#include "devices/wifi/ovnis-wifi-phy.h"
+#include "ovnis-constants.h"
+
+using namespace ns3;
+using namespace std;
+
+NS_LOG_COMPONENT_DEFINE("PhyCalibration");
+
+class PdrCounter {
+public:
+	PdrCounter(uint32_t size) : frameSize(size), received(0) {}
+	void ReceiveOk(Ptr<Packet> packet, double snr, WifiMode mode, enum WifiPreamble preamble) {
+		// frames of the interferer have another size
+		if (packet->GetSize() == frameSize) {
+			++received;
+		}
+	}
+	uint32_t frameSize;
+	uint32_t received;
+};
+
+struct CalibrationSettings {
+	string lossModel;
+	string errorRateModel;
+	double distanceStep;
+	double maxDistance;
+	double interfererDistance;
+	uint32_t frames;
+	uint32_t frameSize;
+	double interval;
+};
+
+static Ptr<OvnisWifiPhy> CreatePhy(Ptr<OvnisWifiChannel> channel, string phyType, string errorRateModel, Vector position) {
+	ObjectFactory phyFactory;
+	phyFactory.SetTypeId(phyType);
+	phyFactory.Set("TxPowerStart", DoubleValue(TX_POWER_START));
+	phyFactory.Set("TxPowerEnd", DoubleValue(TX_POWER_END));
+	phyFactory.Set("TxGain", DoubleValue(TX_GAIN));
+	phyFactory.Set("RxGain", DoubleValue(RX_GAIN));
+	phyFactory.Set("EnergyDetectionThreshold", DoubleValue(ENERGY_DETECTION_THRESHOLD));
+	phyFactory.Set("CcaMode1Threshold", DoubleValue(CCA_MODEL_THRESHOLD));
+	Ptr<OvnisWifiPhy> phy = phyFactory.Create<OvnisWifiPhy>();
+	ObjectFactory errorFactory;
+	errorFactory.SetTypeId(errorRateModel);
+	phy->SetErrorRateModel(errorFactory.Create<ErrorRateModel>());
+	Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel>();
+	mobility->SetPosition(position);
+	phy->SetMobility(mobility);
+	phy->ConfigureStandard(WIFI_PHY_STANDARD);
+	phy->SetChannel(channel);
+	return phy;
+}
+
+static void SendFrame(Ptr<OvnisWifiPhy> phy, uint32_t size, WifiMode mode) {
+	if (phy->IsStateTx() || phy->IsStateSwitching()) {
+		return;
+	}
+	WifiTxVector txVector;
+	txVector.SetMode(mode);
+	txVector.SetTxPowerLevel(0);
+	phy->SendPacket(Create<Packet>(size), mode, WIFI_PREAMBLE_LONG, txVector);
+}
+
+/**
+ * Runs the scenario with one kind of phy.
+ * @return the packet delivery ratio of each receiver, the closest first.
+ */
+static vector<double> RunScenario(string phyType, const CalibrationSettings & settings) {
+	OvnisWifiChannelHelper channelHelper = OvnisWifiChannelHelper::Default();
+	channelHelper.AddPropagationLoss(settings.lossModel);
+	channelHelper.SetPropagationDelay(PROPAGATION_DELAY_MODEL);
+	Ptr<OvnisWifiChannel> channel = channelHelper.Create();
+	// no interference cutoff, the full model should see every signal
+	channel->SetAttribute("InterferenceCutoff", DoubleValue(-1000));
+	// a single row of cells, wide enough for all receivers to be neighbors of the sender
+	channel->updateArea(settings.maxDistance + 1, 1, settings.maxDistance);
+
+	WifiMode mode = WifiMode(PHY_MODE);
+	Ptr<OvnisWifiPhy> sender = CreatePhy(channel, phyType, settings.errorRateModel, Vector(0, 0, 0));
+	vector<Ptr<OvnisWifiPhy> > receivers;
+	vector<PdrCounter *> counters;
+	for (double d = settings.distanceStep; d <= settings.maxDistance; d += settings.distanceStep) {
+		Ptr<OvnisWifiPhy> receiver = CreatePhy(channel, phyType, settings.errorRateModel, Vector(d, 0, 0));
+		PdrCounter * counter = new PdrCounter(settings.frameSize);
+		receiver->SetReceiveOkCallback(MakeCallback(&PdrCounter::ReceiveOk, counter));
+		receivers.push_back(receiver);
+		counters.push_back(counter);
+	}
+
+	UniformVariable jitter;
+	for (uint32_t i = 0; i < settings.frames; ++i) {
+		Time at = Seconds(i * settings.interval);
+		Simulator::Schedule(at, &SendFrame, sender, settings.frameSize, mode);
+	}
+	if (settings.interfererDistance > 0) {
+		Ptr<OvnisWifiPhy> interferer = CreatePhy(channel, phyType, settings.errorRateModel, Vector(settings.interfererDistance, 0, 0));
+		for (uint32_t i = 0; i < settings.frames; ++i) {
+			Time at = Seconds(i * settings.interval + jitter.GetValue(0, settings.interval));
+			Simulator::Schedule(at, &SendFrame, interferer, settings.frameSize + 1, mode);
+		}
+	}
+	Simulator::Stop(Seconds(settings.frames * settings.interval + 1));
+	Simulator::Run();
+	Simulator::Destroy();
+
+	vector<double> pdr;
+	for (vector<PdrCounter *>::iterator it = counters.begin(); it != counters.end(); ++it) {
+		pdr.push_back((double) (*it)->received / settings.frames);
+		delete *it;
+	}
+	return pdr;
+}
+
+int main(int argc, char ** argv) {
+
+	CalibrationSettings settings;
+	settings.lossModel = PROPAGATION_LOSS_MODEL;
+	settings.errorRateModel = "ns3::NistErrorRateModel";
+	settings.distanceStep = 25;
+	settings.maxDistance = 1000;
+	settings.interfererDistance = 0;
+	settings.frames = 1000;
+	settings.frameSize = 200;
+	settings.interval = 0.1;
+	double tolerance = 0.05;
+
+	CommandLine cmd;
+	cmd.AddValue("lossModel", "Propagation loss model of the channel", settings.lossModel);
+	cmd.AddValue("errorRateModel", "Error rate model of the phys", settings.errorRateModel);
+	cmd.AddValue("distanceStep", "Distance between two receivers (Meters)", settings.distanceStep);
+	cmd.AddValue("maxDistance", "Distance of the farthest receiver (Meters)", settings.maxDistance);
+	cmd.AddValue("interfererDistance", "Position of an interfering sender on the line, 0 for none (Meters)", settings.interfererDistance);
+	cmd.AddValue("frames", "Number of frames sent", settings.frames);
+	cmd.AddValue("frameSize", "Size of the frames (Bytes)", settings.frameSize);
+	cmd.AddValue("interval", "Interval between two frames (Seconds)", settings.interval);
+	cmd.AddValue("tolerance", "Largest PDR difference accepted between the two models", tolerance);
+	cmd.Parse(argc, argv);
+
+	vector<double> full = RunScenario("ns3::OvnisWifiPhy", settings);
+	vector<double> link = RunScenario("ns3::OvnisLinkWifiPhy", settings);
+
+	double maxDifference = 0;
+	double sumDifference = 0;
+	cout << "distance\tpdr full\tpdr link\tdifference" << endl;
+	for (size_t i = 0; i < full.size(); ++i) {
+		double difference = link[i] - full[i];
+		maxDifference = max(maxDifference, fabs(difference));
+		sumDifference += fabs(difference);
+		cout << (i + 1) * settings.distanceStep << "\t" << full[i] << "\t" << link[i] << "\t" << difference << endl;
+	}
+	cout << "max difference\t" << maxDifference << endl;
+	cout << "mean difference\t" << (full.empty() ? 0 : sumDifference / full.size()) << endl;
+	if (maxDifference > tolerance) {
+		cout << "link level model out of tolerance (" << tolerance << ")" << endl;
+		return 1;
+	}
+	return 0;
+}
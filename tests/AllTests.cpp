@@ -1,5 +1,17 @@
 #include "gtest/gtest.h"
 #include "TraciClientTest.cpp"
+#include "NakagamiLossModelTest.cpp"
+#include "ObstacleShadowingLossModelTest.cpp"
+#include "NeighborTableTest.cpp"
+#include "InterferenceTrackerTest.cpp"
+#include "DccTest.cpp"
+#include "StringInternerTest.cpp"
+#include "KnowledgeStoreTest.cpp"
+#include "KnowledgeTest.cpp"
+#include "RouteIndexTest.cpp"
+#include "RouteChangesTest.cpp"
+#include "RoutingEngineTest.cpp"
+#include "AllocationTest.cpp"
 
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
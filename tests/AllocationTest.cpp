@@ -0,0 +1,157 @@
+#include <cstdlib>
+#include <new>
+#include "gtest/gtest.h"
+#include "knowledgeStore.h"
+#include "routeIndex.h"
+
+/*
+ * Counts the allocations made by the whole test binary, so that the reads done at
+ * each routing decision can be checked not to allocate once the structures are built.
+ * Every form of the global operators is replaced, so that each allocation is released
+ * by the function matching the one that made it. The deletes are not inlined in the
+ * callers, where the compiler would see a free() of the result of a new.
+ */
+#if defined(__GNUC__)
+#define ALLOCATION_TEST_NOINLINE __attribute__((noinline))
+#else
+#define ALLOCATION_TEST_NOINLINE
+#endif
+
+namespace {
+  size_t numberOfAllocations = 0;
+
+  void * allocate(std::size_t size) {
+    ++numberOfAllocations;
+    return std::malloc(size == 0 ? 1 : size);
+  }
+}
+
+#if __cplusplus < 201103L
+void * operator new(std::size_t size) throw(std::bad_alloc) {
+#else
+void * operator new(std::size_t size) {
+#endif
+  void * p = allocate(size);
+  if (p == 0) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+#if __cplusplus < 201103L
+void * operator new[](std::size_t size) throw(std::bad_alloc) {
+#else
+void * operator new[](std::size_t size) {
+#endif
+  void * p = allocate(size);
+  if (p == 0) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void * operator new(std::size_t size, const std::nothrow_t &) throw() {
+  return allocate(size);
+}
+
+void * operator new[](std::size_t size, const std::nothrow_t &) throw() {
+  return allocate(size);
+}
+
+ALLOCATION_TEST_NOINLINE void operator delete(void * p) throw() {
+  std::free(p);
+}
+
+ALLOCATION_TEST_NOINLINE void operator delete[](void * p) throw() {
+  std::free(p);
+}
+
+ALLOCATION_TEST_NOINLINE void operator delete(void * p, const std::nothrow_t &) throw() {
+  std::free(p);
+}
+
+ALLOCATION_TEST_NOINLINE void operator delete[](void * p, const std::nothrow_t &) throw() {
+  std::free(p);
+}
+
+// sized, as called by the code compiled for C++14 even when this file is not
+ALLOCATION_TEST_NOINLINE void operator delete(void * p, std::size_t) throw() {
+  std::free(p);
+}
+
+ALLOCATION_TEST_NOINLINE void operator delete[](void * p, std::size_t) throw() {
+  std::free(p);
+}
+
+using namespace ovnis;
+namespace {
+
+  /**
+   * Allocations made since construction.
+   */
+  class AllocationCounter {
+  public:
+    AllocationCounter() : start(numberOfAllocations) {
+    }
+    size_t get() const {
+      return numberOfAllocations - start;
+    }
+  private:
+    size_t start;
+  };
+
+  TEST(AllocationTest, Counter) {
+    AllocationCounter counter;
+    std::vector<int> * v = new std::vector<int>(10);
+    delete v;
+    EXPECT_EQ(2u, counter.get());
+  }
+
+  TEST(AllocationTest, KnowledgeReads) {
+    KnowledgeStore store;
+    StringId a = intern("allocation.edge.a");
+    StringId b = intern("allocation.edge.b");
+    store[a].add(0, NO_STRING_ID, 10, 42);
+    const KnowledgeStore & records = store;
+
+    AllocationCounter counter;
+    double sum = 0;
+    for (int i = 0; i < 100; ++i) {
+      const RecordEntry * entry = records.find(a);
+      sum += entry->getLatestValue() + entry->getLatestTime();
+      EXPECT_TRUE(records.find(b) == 0);
+    }
+    EXPECT_EQ(0u, counter.get());
+    EXPECT_DOUBLE_EQ(5200, sum);
+  }
+
+  TEST(AllocationTest, RouteCosts) {
+    RouteIndex index;
+    std::vector<StringId> main;
+    std::vector<StringId> bypass;
+    main.push_back(intern("allocation.a"));
+    main.push_back(intern("allocation.b"));
+    main.push_back(intern("allocation.c"));
+    bypass.push_back(intern("allocation.a"));
+    bypass.push_back(intern("allocation.x"));
+    bypass.push_back(intern("allocation.c"));
+    index.addRoute("allocation.main", main);
+    index.addRoute("allocation.bypass", bypass);
+    RouteIndex::Selection selection;
+    index.select(intern("allocation.a"), intern("allocation.c"), selection);
+    std::vector<double> edgeCosts(index.getNumberOfColumns(), 1);
+    std::vector<double> routeCosts;
+    index.multiply(selection, edgeCosts, routeCosts);
+
+    // the result vector is reused from one decision to the next
+    AllocationCounter counter;
+    for (int i = 0; i < 100; ++i) {
+      edgeCosts[index.getColumn(intern("allocation.x"))] = i;
+      index.multiply(selection, edgeCosts, routeCosts);
+      EXPECT_DOUBLE_EQ(1, routeCosts[0]);
+      EXPECT_DOUBLE_EQ(i, routeCosts[1]);
+      EXPECT_EQ(1u, index.count(selection, 1, index.getColumn(intern("allocation.x"))));
+    }
+    EXPECT_EQ(0u, counter.get());
+  }
+}
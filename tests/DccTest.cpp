@@ -0,0 +1,71 @@
+#include <vector>
+#include "gtest/gtest.h"
+#include "ns3/core-module.h"
+#include "devices/wifi/ovnis-dcc.h"
+
+using namespace ns3;
+namespace {
+
+  std::vector<double> cbrs;
+
+  void RecordCbr(double cbr) {
+    cbrs.push_back(cbr);
+  }
+
+  class DccTest : public ::testing::Test {
+
+  protected:
+    Ptr<OvnisDcc> dcc;
+
+    virtual void SetUp() {
+      cbrs.clear();
+      dcc = CreateObject<OvnisDcc>();
+      dcc->TraceConnectWithoutContext("ChannelBusyRatio", MakeCallback(&RecordCbr));
+      dcc->Start();
+    }
+
+    virtual void TearDown() {
+      dcc->Stop();
+      Simulator::Destroy();
+    }
+
+    void Busy(double reported, double start, double duration, WifiPhy::State state) {
+      Simulator::Schedule(Seconds(reported), &OvnisDcc::NotifyPhyState, dcc, Seconds(start), Seconds(duration), state);
+    }
+
+    void RunUntil(double time) {
+      Simulator::Stop(Seconds(time));
+      Simulator::Run();
+    }
+  };
+
+  TEST_F(DccTest, ChannelBusyRatio) {
+    Busy(0.5, 0.2, 0.3, WifiPhy::RX);
+    Busy(0.6, 0.4, 0.15, WifiPhy::CCA_BUSY); // overlaps the reception
+    RunUntil(1.5);
+    ASSERT_EQ(1u, cbrs.size());
+    EXPECT_NEAR(0.35, cbrs[0], 1e-9);
+    EXPECT_NEAR(0.35, dcc->GetChannelBusyRatio(), 1e-9);
+    EXPECT_EQ(OvnisDcc::ACTIVE, dcc->GetState());
+  }
+
+  TEST_F(DccTest, PeriodReportedAfterTheWindow) {
+    // a reception reported at its end, across the end of the first window
+    Busy(1.5, 0.8, 0.7, WifiPhy::RX);
+    RunUntil(2.5);
+    ASSERT_EQ(2u, cbrs.size());
+    EXPECT_NEAR(0, cbrs[0], 1e-9);
+    // the part before the end of the first window is counted late, not lost
+    EXPECT_NEAR(0.7, cbrs[1], 1e-9);
+  }
+
+  TEST_F(DccTest, PeriodReportedAtItsStart) {
+    // a transmission reported at its start, across the end of the first window
+    Busy(0.9, 0.9, 0.2, WifiPhy::TX);
+    RunUntil(2.5);
+    ASSERT_EQ(2u, cbrs.size());
+    EXPECT_NEAR(0.1, cbrs[0], 1e-9);
+    EXPECT_NEAR(0.1, cbrs[1], 1e-9);
+  }
+
+}
@@ -0,0 +1,88 @@
+#include "gtest/gtest.h"
+#include "ns3/core-module.h"
+#include "ns3/wifi-phy.h"
+#include "ns3/nist-error-rate-model.h"
+#include "devices/wifi/ovnis-interference-tracker.h"
+
+using namespace ns3;
+namespace {
+
+  class InterferenceTrackerTest : public ::testing::Test {
+
+  protected:
+    OvnisInterferenceTracker tracker;
+    WifiMode mode;
+
+    virtual void SetUp() {
+      mode = WifiPhy::GetOfdmRate6MbpsBW10MHz();
+      tracker.SetErrorRateModel(CreateObject<NistErrorRateModel>());
+    }
+
+    virtual void TearDown() {
+      tracker.EraseEvents();
+      Simulator::Destroy();
+    }
+
+    Ptr<OvnisInterferenceTracker::Event> Add(Time duration, double powerW) {
+      return tracker.Add(100, mode, WIFI_PREAMBLE_LONG, duration, powerW, WifiTxVector());
+    }
+
+    void AdvanceTo(Time time) {
+      Simulator::Stop(time - Simulator::Now());
+      Simulator::Run();
+    }
+  };
+
+  TEST_F(InterferenceTrackerTest, EnergyDuration) {
+    Add(MicroSeconds(300), 1e-9);
+    Add(MicroSeconds(100), 2e-9);
+    Add(MicroSeconds(200), 4e-9);
+    EXPECT_NEAR(7e-9, tracker.GetEnergyW(), 1e-18);
+    EXPECT_EQ(MicroSeconds(0), tracker.GetEnergyDuration(8e-9));
+    EXPECT_EQ(MicroSeconds(100), tracker.GetEnergyDuration(6e-9));
+    EXPECT_EQ(MicroSeconds(200), tracker.GetEnergyDuration(4e-9));
+    EXPECT_EQ(MicroSeconds(300), tracker.GetEnergyDuration(1e-9));
+
+    AdvanceTo(MicroSeconds(150));
+    EXPECT_NEAR(5e-9, tracker.GetEnergyW(), 1e-18);
+    EXPECT_EQ(MicroSeconds(50), tracker.GetEnergyDuration(4e-9));
+  }
+
+  TEST_F(InterferenceTrackerTest, PrunesExpiredSignals) {
+    for (int i = 0; i < 100; ++i) {
+      Add(MicroSeconds(50), 1e-9);
+      AdvanceTo(MicroSeconds(100 * (i + 1)));
+    }
+    EXPECT_EQ(0u, tracker.GetNEvents());
+    EXPECT_DOUBLE_EQ(0, tracker.GetEnergyW());
+  }
+
+  TEST_F(InterferenceTrackerTest, KeepsSignalsOfReception) {
+    Ptr<OvnisInterferenceTracker::Event> frame = Add(MicroSeconds(1000), 1e-9);
+    tracker.NotifyRxStart();
+    AdvanceTo(MicroSeconds(200));
+    Add(MicroSeconds(100), 1e-9);
+    AdvanceTo(MicroSeconds(500));
+    // over but overlapping the frame
+    EXPECT_EQ(2u, tracker.GetNEvents());
+    AdvanceTo(MicroSeconds(1000));
+
+    OvnisInterferenceTracker::SinrChunks chunks;
+    tracker.GetSinrChunks(frame, chunks);
+    ASSERT_EQ(3u, chunks.size());
+    EXPECT_EQ(MicroSeconds(200), chunks[0].end);
+    EXPECT_EQ(MicroSeconds(300), chunks[1].end);
+    EXPECT_EQ(MicroSeconds(1000), chunks[2].end);
+    EXPECT_GT(chunks[0].sinr, 1e3);
+    EXPECT_LT(chunks[1].sinr, 1.0);
+    EXPECT_DOUBLE_EQ(chunks[0].sinr, chunks[2].sinr);
+
+    OvnisInterferenceTracker::SnrPer snrPer = tracker.CalculateSnrPer(frame);
+    EXPECT_DOUBLE_EQ(chunks[0].sinr, snrPer.snr);
+    EXPECT_GT(snrPer.per, 0.9);
+
+    tracker.NotifyRxEnd();
+    EXPECT_EQ(0u, tracker.GetNEvents());
+  }
+
+}
@@ -0,0 +1,116 @@
+#include "gtest/gtest.h"
+#include "knowledgeStore.h"
+
+using namespace ovnis;
+namespace {
+
+  TEST(KnowledgeStoreTest, PackedRecords) {
+    EXPECT_EQ(16u, sizeof(RecordEntry::Record));
+  }
+
+  TEST(KnowledgeStoreTest, LazyAllocation) {
+    KnowledgeStore store;
+    StringId edge = intern("store.edge.0");
+    EXPECT_TRUE(store.find(edge) == 0);
+    EXPECT_TRUE(store.find(intern("store.edge.1")) == 0);
+    EXPECT_TRUE(store.empty());
+
+    store[edge].add(0, NO_STRING_ID, 10, 42);
+    ASSERT_TRUE(store.find(edge) != 0);
+    EXPECT_TRUE(store.find(intern("store.edge.1")) == 0);
+    EXPECT_EQ(1u, store.size());
+    EXPECT_DOUBLE_EQ(42, store.find(edge)->getLatestValue());
+    EXPECT_DOUBLE_EQ(10, store.find(edge)->getLatestTime());
+  }
+
+  TEST(KnowledgeStoreTest, EdgesByHandle) {
+    StringId a = intern("store.edge.a");
+    StringId b = intern("store.edge.b");
+    StringId c = intern("store.edge.c");
+    KnowledgeStore store;
+    RecordEntry & first = store[c];
+    store[a];
+    store[b];
+    ASSERT_EQ(3u, store.getEdges().size());
+    EXPECT_EQ(a, store.getEdges()[0]);
+    EXPECT_EQ(b, store.getEdges()[1]);
+    EXPECT_EQ(c, store.getEdges()[2]);
+    // entries do not move as the store grows
+    EXPECT_EQ(&first, store.find(c));
+  }
+
+  TEST(KnowledgeStoreTest, Ring) {
+    RecordEntry entry;
+    EXPECT_DOUBLE_EQ(0, entry.getLatestTime());
+    for (int i = 1; i <= LOCAL_MEMORY_SIZE + 5; ++i) {
+      entry.add(i, intern("sender"), i, 2 * i);
+    }
+    EXPECT_DOUBLE_EQ(LOCAL_MEMORY_SIZE + 5, entry.getLatestTime());
+    EXPECT_DOUBLE_EQ(2 * (LOCAL_MEMORY_SIZE + 5), entry.getLatestValue());
+    EXPECT_EQ(LOCAL_MEMORY_SIZE + 5, entry.getLatestPacketId());
+    EXPECT_EQ("sender", entry.getLatestSenderId());
+    // the average is over the last LOCAL_MEMORY_SIZE values
+    EXPECT_DOUBLE_EQ(LOCAL_MEMORY_SIZE + 11, entry.getAverageValue());
+    // -1 repeats the latest value
+    entry.add(0, NO_STRING_ID, 100, -1);
+    EXPECT_DOUBLE_EQ(2 * (LOCAL_MEMORY_SIZE + 5), entry.getLatestValue());
+    EXPECT_DOUBLE_EQ(0.5, entry.setCapacity(LOCAL_MEMORY_SIZE + 5));
+  }
+
+  TEST(KnowledgeStoreTest, StoredTime) {
+    RecordEntry entry;
+    double date = 3600.1;
+    entry.add(0, NO_STRING_ID, date, 1);
+    EXPECT_NEAR(date, entry.getLatestTime(), 1e-3);
+    EXPECT_FALSE(entry.getLatestTime() < RecordEntry::toStoredTime(date));
+  }
+
+  TEST(KnowledgeStoreTest, CompactionSharesEntries) {
+    StringId a = intern("shared.edge.a");
+    StringId b = intern("shared.edge.b");
+    KnowledgeStore first, second, third;
+    first.share();
+    second.share();
+    third.share();
+    first[a].add(0, NO_STRING_ID, 10, 42);
+    second[a].add(0, NO_STRING_ID, 10, 42);
+    third[a].add(0, NO_STRING_ID, 11, 43);
+    first[b].add(0, NO_STRING_ID, 10, 7);
+
+    uint32_t version = KnowledgeStore::getBaselineVersion();
+    EXPECT_EQ(1u, KnowledgeStore::compact(0.5));
+    EXPECT_EQ(version + 1, KnowledgeStore::getBaselineVersion());
+    const KnowledgeStore & firstRecords = first;
+    const KnowledgeStore & secondRecords = second;
+    EXPECT_EQ(firstRecords.find(a), secondRecords.find(a));
+    EXPECT_NE(firstRecords.find(a), third.find(a));
+    EXPECT_DOUBLE_EQ(43, third.find(a)->getLatestValue());
+    // a store does not see what it has not recorded
+    EXPECT_TRUE(secondRecords.find(b) == 0);
+    EXPECT_EQ(1u, second.size());
+    EXPECT_DOUBLE_EQ(7, firstRecords.find(b)->getLatestValue());
+  }
+
+  TEST(KnowledgeStoreTest, CopyOnWrite) {
+    StringId a = intern("shared.edge.a");
+    KnowledgeStore first, second;
+    first.share();
+    second.share();
+    first[a].add(0, NO_STRING_ID, 10, 42);
+    second[a].add(0, NO_STRING_ID, 10, 42);
+    KnowledgeStore::compact(1);
+
+    first[a].add(0, NO_STRING_ID, 20, 50);
+    const KnowledgeStore & secondRecords = second;
+    EXPECT_DOUBLE_EQ(50, first.find(a)->getLatestValue());
+    EXPECT_DOUBLE_EQ(42, secondRecords.find(a)->getLatestValue());
+    EXPECT_DOUBLE_EQ(10, secondRecords.find(a)->getLatestTime());
+
+    // a copy keeps what it was given
+    KnowledgeStore copy = second;
+    KnowledgeStore::compact(1);
+    EXPECT_DOUBLE_EQ(42, copy.find(a)->getLatestValue());
+    EXPECT_DOUBLE_EQ(50, first.find(a)->getLatestValue());
+  }
+
+}
@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "ns3/core-module.h"
+#include "knowledge.h"
+#include "log.h"
+
+using namespace ns3;
+using namespace ovnis;
+namespace {
+
+  class TestedKnowledge : public Knowledge {
+
+  public:
+    double getMaxInformationAge() const {
+      return maxInformationAge;
+    }
+
+    int getNumberOfUpdatedEdges(const std::string & routeId) {
+      return numberOfUpdatedEdges[routeId];
+    }
+  };
+
+  /**
+   * What analyseLocalDatabase should find on a route, recomputed from the records.
+   */
+  struct Expected {
+    int fresh;
+    double length;
+    double travelTime;
+    double delay;
+    double congestedLength;
+    double denseLength;
+  };
+
+  class KnowledgeTest : public ::testing::Test {
+
+  protected:
+    std::map<std::string, double> lengths;
+    std::map<std::string, double> maxSpeeds;
+    std::map<std::string, Route> routes;
+    TestedKnowledge * knowledge;
+
+    virtual void SetUp() {
+      Log::getInstance().setOutputFolder(".");
+      const char * edges[] = {"kt_start", "kt_a", "kt_b", "kt_c", "kt_d", "kt_e", "kt_f", "kt_end", "kt_elsewhere"};
+      for (size_t i = 0; i < sizeof(edges) / sizeof(edges[0]); ++i) {
+        lengths[edges[i]] = 100 + 50 * i;
+        maxSpeeds[edges[i]] = 10 + 5 * (i % 3);
+      }
+      // overlapping routes, one of them going twice through kt_b
+      AddRoute("kt_0", "kt_start kt_a kt_b kt_c kt_end");
+      AddRoute("kt_1", "kt_start kt_a kt_d kt_c kt_end");
+      AddRoute("kt_2", "kt_start kt_e kt_b kt_d kt_end");
+      AddRoute("kt_3", "kt_start kt_a kt_b kt_f kt_b kt_c kt_end");
+      TIS::getInstance().initializeStaticTravelTimes(routes);
+      knowledge = new TestedKnowledge();
+    }
+
+    virtual void TearDown() {
+      delete knowledge;
+      Simulator::Destroy();
+    }
+
+    void AddRoute(const std::string & id, const std::string & edges) {
+      Route & route = routes[id] = Route(id, edges);
+      for (std::vector<EdgeInfo>::iterator it = route.getEdgeInfos().begin(); it != route.getEdgeInfos().end(); ++it) {
+        it->setLength(lengths[it->getId()]);
+        it->setMaxSpeed(maxSpeeds[it->getId()]);
+      }
+    }
+
+    double GetStaticCost(const std::string & edgeId) {
+      return lengths[edgeId] / maxSpeeds[edgeId];
+    }
+
+    void RunFor(Time delay) {
+      Simulator::Stop(delay);
+      Simulator::Run();
+    }
+
+    void Record(const std::string & edgeId, double travelTime, double date) {
+      Data data;
+      data.edgeId = intern(edgeId);
+      data.travelTime = travelTime;
+      data.date = date;
+      knowledge->record(data);
+    }
+
+    void Analyse() {
+      knowledge->analyseLocalDatabase(routes, "kt_start", "kt_end", std::map<std::string, double>(), false);
+    }
+
+    /**
+     * Sums over the edges of the route between kt_start and kt_end, from the latest record
+     * of each edge.
+     */
+    Expected Recompute(Route & route) {
+      Expected expected = {0, 0, 0, 0, 0, 0};
+      std::map<std::string, int> counts; // times through each edge
+      const std::vector<std::string> & edges = route.getEdgeIds();
+      for (size_t i = 1; i + 1 < edges.size(); ++i) {
+        ++counts[edges[i]];
+        expected.travelTime += GetStaticCost(edges[i]);
+      }
+      double now = Simulator::Now().GetSeconds();
+      double costDelta = 0;
+      for (std::map<std::string, int>::iterator it = counts.begin(); it != counts.end(); ++it) {
+        const RecordEntry * entry = knowledge->getRecords().find(intern(it->first));
+        if (entry == 0) {
+          continue;
+        }
+        expected.length += lengths[it->first];
+        double travelTime = entry->getLatestValue();
+        double packetAge = entry->getLatestTime() == 0 ? 0 : now - entry->getLatestTime();
+        if (travelTime <= 0 || packetAge >= knowledge->getMaxInformationAge()) {
+          continue;
+        }
+        double staticCost = GetStaticCost(it->first);
+        ++expected.fresh;
+        costDelta += it->second * (travelTime - staticCost);
+        if (travelTime > staticCost) {
+          expected.delay += travelTime - staticCost;
+        }
+        double capacity = staticCost / travelTime;
+        if (capacity < CONGESTION_THRESHOLD) {
+          expected.congestedLength += lengths[it->first];
+        }
+        if (capacity > CONGESTION_THRESHOLD && capacity < DENSITY_THRESHOLD) {
+          expected.denseLength += lengths[it->first];
+        }
+      }
+      if (expected.fresh > 0) {
+        expected.travelTime += costDelta;
+      }
+      return expected;
+    }
+
+    void ExpectRecomputed() {
+      Analyse();
+      double sumLength = 0;
+      for (std::map<std::string, Route>::iterator it = routes.begin(); it != routes.end(); ++it) {
+        Expected expected = Recompute(it->second);
+        sumLength += expected.length;
+        EXPECT_EQ(expected.fresh, knowledge->getNumberOfUpdatedEdges(it->first)) << it->first;
+        EXPECT_NEAR(expected.travelTime, knowledge->getTravelTimesOnRoutes().find(it->first)->second, 1e-6) << it->first;
+        EXPECT_NEAR(expected.delay, knowledge->getDelayOnRoutes().find(it->first)->second, 1e-6) << it->first;
+        EXPECT_NEAR(expected.congestedLength, knowledge->getCongestedLengthOnRoutes().find(it->first)->second, 1e-6) << it->first;
+        EXPECT_NEAR(expected.denseLength, knowledge->getDenseLengthOnRoutes().find(it->first)->second, 1e-6) << it->first;
+      }
+      EXPECT_NEAR(sumLength, knowledge->getSumLength(), 1e-6);
+    }
+  };
+
+  TEST_F(KnowledgeTest, AggregatesMatchTheRecords) {
+    const char * edges[] = {"kt_start", "kt_a", "kt_b", "kt_c", "kt_d", "kt_e", "kt_f", "kt_end", "kt_elsewhere"};
+    size_t numberOfEdges = sizeof(edges) / sizeof(edges[0]);
+    srand(42);
+    Analyse(); // the aggregates are then updated on each record
+    for (int i = 0; i < 300; ++i) {
+      RunFor(Seconds(rand() % 20));
+      std::string edgeId = edges[rand() % numberOfEdges];
+      // from much faster to much slower than the static cost, heard up to after it expired
+      double travelTime = GetStaticCost(edgeId) * (0.5 + (rand() % 250) / 100.);
+      double date = std::max(1., Simulator::Now().GetSeconds() - rand() % 150);
+      Record(edgeId, travelTime, date);
+      ExpectRecomputed();
+      if (HasFailure()) {
+        FAIL() << "after record " << i << " on " << edgeId << " at " << Simulator::Now().GetSeconds();
+      }
+    }
+  }
+
+  TEST_F(KnowledgeTest, ContributionExpiresAtMaxInformationAge) {
+    Analyse();
+    RunFor(Seconds(10));
+    Record("kt_a", 2 * GetStaticCost("kt_a"), 10);
+    RunFor(Seconds(knowledge->getMaxInformationAge()) - NanoSeconds(1));
+    Analyse();
+    EXPECT_EQ(1, knowledge->getNumberOfUpdatedEdges("kt_0"));
+    EXPECT_NEAR(GetStaticCost("kt_a"), knowledge->getDelayOnRoutes().find("kt_0")->second, 1e-6);
+    ExpectRecomputed();
+
+    RunFor(NanoSeconds(1));
+    EXPECT_EQ(10 + knowledge->getMaxInformationAge(), Simulator::Now().GetSeconds());
+    Analyse();
+    EXPECT_EQ(0, knowledge->getNumberOfUpdatedEdges("kt_0"));
+    EXPECT_EQ(0, knowledge->getDelayOnRoutes().find("kt_0")->second);
+    ExpectRecomputed();
+  }
+
+}
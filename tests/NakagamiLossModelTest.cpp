@@ -0,0 +1,108 @@
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include "gtest/gtest.h"
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "devices/wifi/ovnis-nakagami-propagation-loss-model.h"
+
+using namespace ns3;
+namespace {
+
+  /**
+   * Draws linear gains from the pooled Nakagami model and compares them with the
+   * Gamma(m, 1/m) distribution: first two moments and Kolmogorov-Smirnov distance.
+   */
+  class NakagamiLossModelTest : public ::testing::Test {
+
+  protected:
+    static const int SAMPLES = 20000;
+
+    std::vector<double> Draw(double m, double distance) {
+      Ptr<OvnisNakagamiPropagationLossModel> model = CreateObject<OvnisNakagamiPropagationLossModel>();
+      model->SetAttribute("m0", DoubleValue(m));
+      model->SetAttribute("m1", DoubleValue(m));
+      model->SetAttribute("m2", DoubleValue(m));
+      model->AssignStreams(1);
+      Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel>();
+      Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel>();
+      b->SetPosition(Vector(distance, 0, 0));
+      std::vector<double> gains;
+      for (int i = 0; i < SAMPLES; ++i) {
+        gains.push_back(std::pow(10.0, model->CalcRxPower(0, a, b) / 10.0));
+      }
+      return gains;
+    }
+
+    // regularized lower incomplete gamma function P(a, x), by its series
+    static double GammaP(double a, double x) {
+      if (x <= 0) {
+        return 0;
+      }
+      double term = 1.0 / a;
+      double sum = term;
+      for (int n = 1; n < 500; ++n) {
+        term *= x / (a + n);
+        sum += term;
+        if (term < sum * 1e-12) {
+          break;
+        }
+      }
+      return std::min(1.0, sum * std::exp(-x + a * std::log(x) - lgamma(a)));
+    }
+
+    void CheckDistribution(double m, double distance) {
+      std::vector<double> gains = Draw(m, distance);
+      double mean = 0;
+      for (size_t i = 0; i < gains.size(); ++i) {
+        mean += gains[i];
+      }
+      mean /= gains.size();
+      double variance = 0;
+      for (size_t i = 0; i < gains.size(); ++i) {
+        variance += (gains[i] - mean) * (gains[i] - mean);
+      }
+      variance /= gains.size();
+      EXPECT_NEAR(1.0, mean, 0.05);
+      EXPECT_NEAR(1.0 / m, variance, 0.1 / m);
+
+      // Kolmogorov-Smirnov, critical value at 1% is 1.63 / sqrt(n)
+      std::sort(gains.begin(), gains.end());
+      double ks = 0;
+      for (size_t i = 0; i < gains.size(); ++i) {
+        double cdf = GammaP(m, m * gains[i]);
+        ks = std::max(ks, std::max(cdf - (double) i / gains.size(), (double) (i + 1) / gains.size() - cdf));
+      }
+      EXPECT_LT(ks, 1.63 / std::sqrt((double) gains.size()));
+    }
+  };
+
+  TEST_F(NakagamiLossModelTest, IntegerM) {
+    CheckDistribution(1, 50);
+    CheckDistribution(3, 50);
+  }
+
+  TEST_F(NakagamiLossModelTest, RealM) {
+    CheckDistribution(0.75, 300);
+    CheckDistribution(1.5, 50);
+  }
+
+  TEST_F(NakagamiLossModelTest, DistanceFields) {
+    // the three fields must draw from their own m, not from a shared pool
+    Ptr<OvnisNakagamiPropagationLossModel> model = CreateObject<OvnisNakagamiPropagationLossModel>();
+    model->SetAttribute("m0", DoubleValue(20));
+    model->SetAttribute("m2", DoubleValue(0.5));
+    Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel>();
+    Ptr<MobilityModel> near = CreateObject<ConstantPositionMobilityModel>();
+    Ptr<MobilityModel> far = CreateObject<ConstantPositionMobilityModel>();
+    near->SetPosition(Vector(10, 0, 0));
+    far->SetPosition(Vector(500, 0, 0));
+    double nearSpread = 0, farSpread = 0;
+    for (int i = 0; i < 2000; ++i) {
+      nearSpread += std::fabs(model->CalcRxPower(0, a, near));
+      farSpread += std::fabs(model->CalcRxPower(0, a, far));
+    }
+    EXPECT_LT(nearSpread, farSpread);
+  }
+
+}
@@ -0,0 +1,95 @@
+#include "gtest/gtest.h"
+#include "ns3/core-module.h"
+#include "devices/wifi/ovnis-neighbor-table.h"
+#include "stringInterner.h"
+
+using namespace ns3;
+using ovnis::intern;
+namespace {
+
+  class NeighborTableTest : public ::testing::Test {
+
+  protected:
+    Ptr<OvnisNeighborTable> table;
+
+    virtual void SetUp() {
+      table = CreateObject<OvnisNeighborTable>();
+    }
+
+    virtual void TearDown() {
+      Simulator::Destroy();
+    }
+  };
+
+  TEST_F(NeighborTableTest, MacThenApplication) {
+    Mac48Address a("00:00:00:00:00:01");
+    table->NotifyHeard(a, -80);
+    table->UpdateVehicle(a, intern("0.1"), Vector(10, 20, 0), 13.5);
+    ASSERT_EQ(1u, table->GetNNeighbors());
+    const OvnisNeighborTable::Entry * entry = table->Find(intern("0.1"));
+    ASSERT_TRUE(entry != 0);
+    EXPECT_EQ(entry, table->Find(a));
+    EXPECT_DOUBLE_EQ(-80, entry->rxPowerDbm);
+    EXPECT_DOUBLE_EQ(20, entry->position.y);
+    EXPECT_DOUBLE_EQ(13.5, entry->speed);
+  }
+
+  TEST_F(NeighborTableTest, MergesEntries) {
+    // heard by the MAC and by a packet before a beacon payload relates them
+    Mac48Address a("00:00:00:00:00:01");
+    Mac48Address b("00:00:00:00:00:02");
+    table->UpdateVehicle(intern("0.2"), Vector(1, 1, 0), 5);
+    table->NotifyHeard(b, -70);
+    table->NotifyHeard(a, -90);
+    table->UpdateVehicle(intern("0.3"), Vector(2, 2, 0), 6);
+    table->UpdateVehicle(a, intern("0.2"), Vector(3, 3, 0), 7);
+    ASSERT_EQ(3u, table->GetNNeighbors());
+    EXPECT_EQ(table->Find(a), table->Find(intern("0.2")));
+    EXPECT_DOUBLE_EQ(-90, table->Find(intern("0.2"))->rxPowerDbm);
+    EXPECT_DOUBLE_EQ(-70, table->Find(b)->rxPowerDbm);
+    EXPECT_DOUBLE_EQ(6, table->Find(intern("0.3"))->speed);
+
+    table->NotifyLost(a);
+    ASSERT_EQ(2u, table->GetNNeighbors());
+    EXPECT_TRUE(table->Find(intern("0.2")) == 0);
+    EXPECT_TRUE(table->Find(b) != 0);
+    EXPECT_TRUE(table->Find(intern("0.3")) != 0);
+    uint32_t n = 0;
+    for (OvnisNeighborTable::Iterator i = table->Begin(); i != table->End(); ++i) {
+      n++;
+    }
+    EXPECT_EQ(2u, n);
+  }
+
+  TEST_F(NeighborTableTest, IndexedByAddressAndVehicle) {
+    // removing an entry moves the last one, both indices must follow it
+    Mac48Address a("00:00:00:00:00:01");
+    Mac48Address b("00:00:00:00:00:02");
+    table->UpdateVehicle(a, intern("0.5"), Vector(0, 0, 0), 1);
+    table->UpdateVehicle(b, intern("0.6"), Vector(0, 0, 0), 2);
+    table->NotifyLost(a);
+    ASSERT_EQ(1u, table->GetNNeighbors());
+    const OvnisNeighborTable::Entry * entry = table->Find(b);
+    ASSERT_TRUE(entry != 0);
+    EXPECT_EQ(entry, table->Find(intern("0.6")));
+    EXPECT_EQ(intern("0.6"), entry->vehicleId);
+    EXPECT_TRUE(table->Find(intern("0.5")) == 0);
+    EXPECT_TRUE(table->Find(ovnis::NO_STRING_ID) == 0);
+  }
+
+  TEST_F(NeighborTableTest, PurgesApplicationNeighbors) {
+    Mac48Address a("00:00:00:00:00:01");
+    table->SetAttribute("Timeout", TimeValue(Seconds(2)));
+    table->NotifyHeard(a, -80);
+    table->UpdateVehicle(intern("0.4"), Vector(0, 0, 0), 0);
+    Simulator::Schedule(Seconds(1), &OvnisNeighborTable::Purge, table);
+    Simulator::Run();
+    EXPECT_EQ(2u, table->GetNNeighbors());
+    Simulator::Schedule(Seconds(3), &OvnisNeighborTable::Purge, table);
+    Simulator::Run();
+    // only the MAC removes the neighbors it has heard
+    ASSERT_EQ(1u, table->GetNNeighbors());
+    EXPECT_TRUE(table->Find(a) != 0);
+  }
+
+}
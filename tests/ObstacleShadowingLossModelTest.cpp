@@ -0,0 +1,70 @@
+#include <vector>
+#include "gtest/gtest.h"
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "devices/wifi/ovnis-obstacle-shadowing-loss-model.h"
+
+using namespace ns3;
+namespace {
+
+  /**
+   * A 20m x 10m building centered on (50, 0), default attenuation of 9 dB per wall
+   * and 0.4 dB/m inside.
+   */
+  class ObstacleShadowingLossModelTest : public ::testing::Test {
+
+  protected:
+    virtual void SetUp() {
+      model = CreateObject<OvnisObstacleShadowingLossModel>();
+      model->SetAttribute("GridResolution", DoubleValue(7));
+      std::vector<Vector> building;
+      building.push_back(Vector(40, -5, 0));
+      building.push_back(Vector(60, -5, 0));
+      building.push_back(Vector(60, 5, 0));
+      building.push_back(Vector(40, 5, 0));
+      model->AddObstacle(building);
+    }
+
+    Ptr<OvnisObstacleShadowingLossModel> model;
+  };
+
+  TEST_F(ObstacleShadowingLossModelTest, LineOfSight) {
+    EXPECT_DOUBLE_EQ(0, model->GetObstacleLoss(Vector(0, 10, 0), Vector(100, 10, 0)));
+    EXPECT_DOUBLE_EQ(0, model->GetObstacleLoss(Vector(0, 0, 0), Vector(30, 0, 0)));
+    EXPECT_DOUBLE_EQ(0, model->GetObstacleLoss(Vector(-100, -100, 0), Vector(-10, 200, 0)));
+  }
+
+  TEST_F(ObstacleShadowingLossModelTest, Walls) {
+    EXPECT_NEAR(2 * 9 + 20 * 0.4, model->GetObstacleLoss(Vector(0, 0, 0), Vector(100, 0, 0)), 1e-9);
+    EXPECT_NEAR(2 * 9 + 20 * 0.4, model->GetObstacleLoss(Vector(100, 0, 0), Vector(0, 0, 0)), 1e-9);
+    EXPECT_NEAR(2 * 9 + 10 * 0.4, model->GetObstacleLoss(Vector(50, -50, 0), Vector(50, 50, 0)), 1e-9);
+  }
+
+  TEST_F(ObstacleShadowingLossModelTest, Cache) {
+    // results are cached for endpoints within the grid, spread it with two small obstacles
+    std::vector<Vector> corner;
+    corner.push_back(Vector(0, -30, 0));
+    corner.push_back(Vector(1, -30, 0));
+    corner.push_back(Vector(1, -29, 0));
+    model->AddObstacle(corner);
+    for (size_t i = 0; i < corner.size(); ++i) {
+      corner[i].x += 100;
+      corner[i].y += 60;
+    }
+    model->AddObstacle(corner);
+
+    Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel>();
+    Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel>();
+    a->SetPosition(Vector(41, -20, 0));
+    b->SetPosition(Vector(59, 20, 0));
+    double rx = model->CalcRxPower(0, a, b);
+    EXPECT_EQ(0u, model->GetNCacheHits());
+    EXPECT_DOUBLE_EQ(rx, model->CalcRxPower(0, b, a));
+    EXPECT_EQ(1u, model->GetNCacheHits());
+    EXPECT_DOUBLE_EQ(-model->GetObstacleLoss(a->GetPosition(), b->GetPosition()), rx);
+
+    b->SetPosition(Vector(59, -20, 0));
+    EXPECT_DOUBLE_EQ(0, model->CalcRxPower(0, a, b));
+  }
+
+}
@@ -0,0 +1,226 @@
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "gtest/gtest.h"
+#include "ns3/core-module.h"
+#include "traci/storage.h"
+#include "traci/routeChangeQueue.h"
+#include "traci/query/routeChangesQuery.h"
+
+using namespace ns3;
+using namespace ovnis;
+namespace {
+
+  std::vector<std::pair<std::string, bool> > reported;
+  RouteChangeQueue * cancelling = 0;
+  std::string cancelled;
+
+  void Rerouted(std::string vehicleId, bool applied) {
+    reported.push_back(std::make_pair(vehicleId, applied));
+  }
+
+  void ReroutedAndCancel(std::string vehicleId, bool applied) {
+    Rerouted(vehicleId, applied);
+    cancelling->Cancel(cancelled);
+  }
+
+  class RouteChangesTest : public ::testing::Test {
+
+  protected:
+    RouteChangeQueue queue;
+
+    virtual void SetUp() {
+      reported.clear();
+      cancelling = &queue;
+    }
+
+    void Add(const std::string & vehicleId, const std::string & edges) {
+      queue.Add(vehicleId, Split(edges), MakeBoundCallback(&Rerouted, vehicleId));
+    }
+
+    static std::vector<std::string> Split(const std::string & edges) {
+      std::vector<std::string> split;
+      std::stringstream ss(edges);
+      std::string edge;
+      while (ss >> edge) {
+        split.push_back(edge);
+      }
+      return split;
+    }
+
+    /**
+     * The command SUMO expects for a change of the route of vehicleId.
+     */
+    static void WriteChange(tcpip::Storage & request, const std::string & vehicleId, const std::string & edges) {
+      std::vector<std::string> split = Split(edges);
+      int size = COMMAND_HEADER_EXTENDED_SIZE + 1 + 4 + vehicleId.size() + 1 + 4;
+      for (size_t i = 0; i < split.size(); ++i) {
+        size += 4 + split[i].size();
+      }
+      request.writeUnsignedByte(0);
+      request.writeInt(size);
+      request.writeUnsignedByte(CMD_SET_VEHICLE_VARIABLE);
+      request.writeUnsignedByte(VAR_ROUTE);
+      request.writeString(vehicleId);
+      request.writeUnsignedByte(TYPE_STRINGLIST);
+      request.writeStringList(split);
+    }
+
+    static void WriteStatus(tcpip::Storage & response, int commandId, int status, const std::string & description) {
+      response.writeUnsignedByte(1 + 1 + 1 + 4 + description.size());
+      response.writeUnsignedByte(commandId);
+      response.writeUnsignedByte(status);
+      response.writeString(description);
+    }
+
+    static std::vector<unsigned char> Bytes(const tcpip::Storage & storage) {
+      return std::vector<unsigned char>(storage.begin(), storage.end());
+    }
+  };
+
+  TEST_F(RouteChangesTest, OneCommandPerVehicle) {
+    Add("v2", "b c");
+    Add("v1", "a b");
+    RouteChangesQuery query(0);
+    EXPECT_EQ(2u, queue.Take(query));
+    EXPECT_TRUE(queue.IsEmpty());
+    tcpip::Storage request;
+    query.WriteChanges(request);
+    tcpip::Storage expected;
+    WriteChange(expected, "v1", "a b");
+    WriteChange(expected, "v2", "b c");
+    EXPECT_EQ(Bytes(expected), Bytes(request));
+  }
+
+  TEST_F(RouteChangesTest, LatestChangeOfAVehicle) {
+    Add("v1", "a b");
+    queue.Add("v1", Split("a c"), MakeBoundCallback(&Rerouted, std::string("v1 again")));
+    RouteChangesQuery query(0);
+    EXPECT_EQ(1u, queue.Take(query));
+    tcpip::Storage request;
+    query.WriteChanges(request);
+    tcpip::Storage expected;
+    WriteChange(expected, "v1", "a c");
+    EXPECT_EQ(Bytes(expected), Bytes(request));
+    tcpip::Storage response;
+    WriteStatus(response, CMD_SET_VEHICLE_VARIABLE, RTYPE_OK, "");
+    query.ReadStatuses(response);
+    queue.Report(query);
+    // the superseded change is not reported
+    ASSERT_EQ(1u, reported.size());
+    EXPECT_EQ(std::make_pair(std::string("v1 again"), true), reported[0]);
+  }
+
+  TEST_F(RouteChangesTest, CancelledChange) {
+    Add("v1", "a b");
+    Add("v2", "b c");
+    queue.Cancel("v1");
+    RouteChangesQuery query(0);
+    EXPECT_EQ(1u, queue.Take(query));
+    tcpip::Storage response;
+    WriteStatus(response, CMD_SET_VEHICLE_VARIABLE, RTYPE_OK, "");
+    query.ReadStatuses(response);
+    queue.Report(query);
+    ASSERT_EQ(1u, reported.size());
+    EXPECT_EQ(std::make_pair(std::string("v2"), true), reported[0]);
+  }
+
+  TEST_F(RouteChangesTest, CancelledWhileReporting) {
+    // as a vehicle destroyed by the callback of another one
+    cancelled = "v2";
+    queue.Add("v1", Split("a b"), MakeBoundCallback(&ReroutedAndCancel, std::string("v1")));
+    Add("v2", "b c");
+    RouteChangesQuery query(0);
+    queue.Take(query);
+    tcpip::Storage response;
+    WriteStatus(response, CMD_SET_VEHICLE_VARIABLE, RTYPE_OK, "");
+    WriteStatus(response, CMD_SET_VEHICLE_VARIABLE, RTYPE_OK, "");
+    query.ReadStatuses(response);
+    queue.Report(query);
+    ASSERT_EQ(1u, reported.size());
+    EXPECT_EQ(std::make_pair(std::string("v1"), true), reported[0]);
+  }
+
+  TEST_F(RouteChangesTest, ErrorInTheMiddle) {
+    Add("v1", "a b");
+    Add("v2", "b c");
+    Add("v3", "c d");
+    RouteChangesQuery query(0);
+    queue.Take(query);
+    tcpip::Storage response;
+    WriteStatus(response, CMD_SET_VEHICLE_VARIABLE, RTYPE_OK, "");
+    WriteStatus(response, CMD_SET_VEHICLE_VARIABLE, RTYPE_ERR, "Route replacement failed for v2");
+    WriteStatus(response, CMD_SET_VEHICLE_VARIABLE, RTYPE_OK, "");
+    query.ReadStatuses(response);
+    EXPECT_TRUE(query.IsApplied(0));
+    EXPECT_FALSE(query.IsApplied(1));
+    EXPECT_TRUE(query.IsApplied(2));
+    queue.Report(query);
+    ASSERT_EQ(3u, reported.size());
+    EXPECT_EQ(std::make_pair(std::string("v1"), true), reported[0]);
+    EXPECT_EQ(std::make_pair(std::string("v2"), false), reported[1]);
+    EXPECT_EQ(std::make_pair(std::string("v3"), true), reported[2]);
+  }
+
+  TEST_F(RouteChangesTest, StatusOfAnotherCommand) {
+    Add("v1", "a b");
+    Add("v2", "b c");
+    RouteChangesQuery query(0);
+    queue.Take(query);
+    tcpip::Storage response;
+    WriteStatus(response, CMD_GET_VEHICLE_VARIABLE, RTYPE_OK, "");
+    WriteStatus(response, CMD_SET_VEHICLE_VARIABLE, RTYPE_OK, "");
+    query.ReadStatuses(response);
+    EXPECT_FALSE(query.IsApplied(0));
+    EXPECT_TRUE(query.IsApplied(1));
+  }
+
+  TEST_F(RouteChangesTest, MissingStatus) {
+    Add("v1", "a b");
+    Add("v2", "b c");
+    Add("v3", "c d");
+    RouteChangesQuery query(0);
+    queue.Take(query);
+    // which change has no status cannot be told, none is applied
+    tcpip::Storage response;
+    WriteStatus(response, CMD_SET_VEHICLE_VARIABLE, RTYPE_OK, "");
+    WriteStatus(response, CMD_SET_VEHICLE_VARIABLE, RTYPE_OK, "");
+    query.ReadStatuses(response);
+    queue.Report(query);
+    ASSERT_EQ(3u, reported.size());
+    EXPECT_EQ(std::make_pair(std::string("v1"), false), reported[0]);
+    EXPECT_EQ(std::make_pair(std::string("v2"), false), reported[1]);
+    EXPECT_EQ(std::make_pair(std::string("v3"), false), reported[2]);
+  }
+
+  TEST_F(RouteChangesTest, TruncatedStatus) {
+    Add("v1", "a b");
+    Add("v2", "b c");
+    RouteChangesQuery query(0);
+    queue.Take(query);
+    tcpip::Storage response;
+    WriteStatus(response, CMD_SET_VEHICLE_VARIABLE, RTYPE_OK, "");
+    response.writeUnsignedByte(7);
+    response.writeUnsignedByte(CMD_SET_VEHICLE_VARIABLE);
+    query.ReadStatuses(response);
+    EXPECT_TRUE(query.IsApplied(0));
+    EXPECT_FALSE(query.IsApplied(1));
+  }
+
+  TEST_F(RouteChangesTest, ChangesQueuedWhileSending) {
+    Add("v1", "a b");
+    RouteChangesQuery query(0);
+    queue.Take(query);
+    Add("v1", "a c"); // for the next step
+    tcpip::Storage response;
+    WriteStatus(response, CMD_SET_VEHICLE_VARIABLE, RTYPE_OK, "");
+    query.ReadStatuses(response);
+    queue.Report(query);
+    EXPECT_EQ(1u, reported.size());
+    EXPECT_FALSE(queue.IsEmpty());
+    RouteChangesQuery next(0);
+    EXPECT_EQ(1u, queue.Take(next));
+  }
+
+}
@@ -0,0 +1,101 @@
+#include <sstream>
+#include "gtest/gtest.h"
+#include "routeIndex.h"
+
+using namespace ovnis;
+namespace {
+
+  class RouteIndexTest : public ::testing::Test {
+
+  protected:
+    RouteIndex index;
+    std::vector<std::vector<StringId> > routes;
+
+    virtual void SetUp() {
+      // main and bypass share their margins, loop goes twice through b
+      AddRoute("main", "a b c d e");
+      AddRoute("bypass", "a b x y e");
+      AddRoute("loop", "a b c b d");
+    }
+
+    void AddRoute(const std::string & id, const std::string & edges) {
+      std::vector<StringId> route;
+      std::stringstream ss(edges);
+      std::string edge;
+      while (ss >> edge) {
+        route.push_back(intern("index." + edge));
+      }
+      EXPECT_EQ(routes.size(), index.addRoute(id, route));
+      routes.push_back(route);
+    }
+
+    // as Route::containsEdgeExcludedMargins
+    static bool Contains(const std::vector<StringId> & route, StringId edge, StringId start, StringId end) {
+      bool isMonitored = false;
+      for (size_t i = 0; i < route.size(); ++i) {
+        if (route[i] == end) {
+          isMonitored = false;
+        }
+        if (isMonitored && route[i] == edge) {
+          return true;
+        }
+        if (route[i] == start) {
+          isMonitored = true;
+        }
+      }
+      return false;
+    }
+  };
+
+  TEST_F(RouteIndexTest, Rows) {
+    EXPECT_EQ(3u, index.getNumberOfRows());
+    EXPECT_EQ(7u, index.getNumberOfColumns());
+    EXPECT_EQ(1u, index.addRoute("bypass", routes[0]));
+    EXPECT_EQ(1u, index.getRow("bypass"));
+    EXPECT_EQ(RouteIndex::NOT_FOUND, index.getRow("unknown"));
+    EXPECT_EQ(RouteIndex::NOT_FOUND, index.getColumn(intern("index.unknown")));
+    EXPECT_EQ(5u, index.getLength(2));
+    EXPECT_EQ(index.getColumn(intern("index.b")), index.getColumnAt(2, 3));
+  }
+
+  TEST_F(RouteIndexTest, SelectionAsRouteScan) {
+    const char * names[] = {"a", "b", "c", "d", "e", "x", "y", "unknown"};
+    for (int s = 0; s < 8; ++s) {
+      for (int e = 0; e < 8; ++e) {
+        StringId start = intern(std::string("index.") + names[s]);
+        StringId end = intern(std::string("index.") + names[e]);
+        RouteIndex::Selection selection;
+        index.select(start, end, selection);
+        for (uint32_t row = 0; row < routes.size(); ++row) {
+          for (int k = 0; k < 7; ++k) {
+            StringId edge = intern(std::string("index.") + names[k]);
+            EXPECT_EQ(Contains(routes[row], edge, start, end), index.contains(selection, row, index.getColumn(edge)))
+                << names[s] << "-" << names[e] << " " << names[k] << " on " << row;
+          }
+          std::vector<uint32_t> columns;
+          index.getColumns(selection, row, columns);
+          for (size_t i = 0; i < columns.size(); ++i) {
+            EXPECT_TRUE(Contains(routes[row], index.getEdge(columns[i]), start, end));
+          }
+          EXPECT_EQ(columns.size(), index.count(selection, row));
+        }
+      }
+    }
+  }
+
+  TEST_F(RouteIndexTest, Costs) {
+    RouteIndex::Selection selection;
+    index.select(intern("index.a"), intern("index.e"), selection);
+    std::vector<double> edgeCosts(index.getNumberOfColumns(), 1);
+    std::vector<double> routeCosts;
+    index.multiply(selection, edgeCosts, routeCosts);
+    ASSERT_EQ(3u, routeCosts.size());
+    EXPECT_DOUBLE_EQ(3, routeCosts[0]);
+    EXPECT_DOUBLE_EQ(3, routeCosts[1]);
+    // no end edge, up to the end of the route
+    EXPECT_DOUBLE_EQ(4, routeCosts[2]);
+    EXPECT_EQ(2u, index.count(selection, 2, index.getColumn(intern("index.b"))));
+    EXPECT_EQ(0u, index.count(selection, 2, index.getColumn(intern("index.a"))));
+  }
+
+}
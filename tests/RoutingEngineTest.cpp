@@ -0,0 +1,197 @@
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <sstream>
+#include "gtest/gtest.h"
+#include "roadGraph.h"
+#include "routingEngine.h"
+
+using namespace ovnis;
+namespace {
+
+  /*
+   * A grid of side junctions 100 m apart, with an edge each way between neighbours,
+   * named "routing.x.y-x.y".
+   */
+  class RoutingEngineTest : public ::testing::Test {
+
+  protected:
+    static const uint32_t side = 30;
+    RoadGraph graph;
+
+    virtual void SetUp() {
+      srand(42);
+      for (uint32_t x = 0; x < side; ++x) {
+        for (uint32_t y = 0; y < side; ++y) {
+          graph.addJunction(intern(Junction(x, y)), 100.0 * x, 100.0 * y);
+          if (x > 0) {
+            AddRoad(x - 1, y, x, y);
+          }
+          if (y > 0) {
+            AddRoad(x, y - 1, x, y);
+          }
+        }
+      }
+    }
+
+    static std::string Junction(uint32_t x, uint32_t y) {
+      std::stringstream ss;
+      ss << "routing." << x << "." << y;
+      return ss.str();
+    }
+
+    void AddRoad(uint32_t x1, uint32_t y1, uint32_t x2, uint32_t y2) {
+      StringId a = intern(Junction(x1, y1));
+      StringId b = intern(Junction(x2, y2));
+      double speed = 10 + rand() % 30;
+      graph.addLane(graph.addEdge(intern(lookup(a) + "-" + lookup(b)), a, b), 100, speed);
+      graph.addLane(graph.addEdge(intern(lookup(b) + "-" + lookup(a)), b, a), 100, speed);
+    }
+
+    uint32_t Edge(uint32_t x1, uint32_t y1, uint32_t x2, uint32_t y2) const {
+      return graph.getEdge(intern(Junction(x1, y1) + "-" + Junction(x2, y2)));
+    }
+
+    // travel times at least the static costs, as reported in a jam
+    void JamWeights(std::vector<double> & weights) const {
+      graph.getStaticCosts(weights);
+      for (size_t edge = 0; edge < weights.size(); ++edge) {
+        if (rand() % 4 == 0) {
+          weights[edge] *= 1 + rand() % 10;
+        }
+      }
+    }
+
+    uint32_t RandomEdge() const {
+      return rand() % graph.getNumberOfEdges();
+    }
+
+    void ExpectValid(const std::vector<double> & weights, uint32_t source, uint32_t target, const RoutingEngine::Path & path) const {
+      ASSERT_FALSE(path.edges.empty());
+      EXPECT_EQ(source, path.edges.front());
+      EXPECT_EQ(target, path.edges.back());
+      double cost = 0;
+      for (size_t i = 0; i < path.edges.size(); ++i) {
+        cost += weights[path.edges[i]];
+        if (i > 0) {
+          EXPECT_EQ(graph.getTo(path.edges[i - 1]), graph.getFrom(path.edges[i]));
+        }
+      }
+      EXPECT_NEAR(cost, path.cost, 1e-6);
+    }
+  };
+
+  TEST_F(RoutingEngineTest, Graph) {
+    EXPECT_EQ(side * side, graph.getNumberOfJunctions());
+    EXPECT_EQ(4 * side * (side - 1), graph.getNumberOfEdges());
+    EXPECT_TRUE(graph.isLocated());
+    uint32_t edge = Edge(0, 0, 1, 0);
+    ASSERT_NE(RoadGraph::NOT_FOUND, edge);
+    EXPECT_EQ(edge, graph.addEdge(graph.getEdgeId(edge), NO_STRING_ID, NO_STRING_ID));
+    EXPECT_EQ(graph.getJunction(intern(Junction(1, 0))), graph.getTo(edge));
+    EXPECT_DOUBLE_EQ(100 / graph.getMaxSpeed(edge), graph.getStaticCost(edge));
+    EXPECT_EQ(RoadGraph::NOT_FOUND, graph.getEdge(intern("routing.unknown")));
+  }
+
+  TEST_F(RoutingEngineTest, ShortestPaths) {
+    RoutingEngine engine(graph);
+    std::vector<double> weights;
+    for (int metric = 0; metric < 3; ++metric) {
+      JamWeights(weights);
+      engine.customize(weights);
+      for (int i = 0; i < 200; ++i) {
+        uint32_t source = RandomEdge();
+        uint32_t target = RandomEdge();
+        RoutingEngine::Path dijkstra;
+        RoutingEngine::Path astar;
+        RoutingEngine::Path query;
+        ASSERT_TRUE(engine.dijkstra(weights, source, target, dijkstra));
+        ASSERT_TRUE(engine.astar(weights, source, target, astar));
+        ASSERT_TRUE(engine.query(source, target, query));
+        ExpectValid(weights, source, target, dijkstra);
+        ExpectValid(weights, source, target, astar);
+        ExpectValid(weights, source, target, query);
+        EXPECT_NEAR(dijkstra.cost, astar.cost, 1e-6);
+        EXPECT_NEAR(dijkstra.cost, query.cost, 1e-6);
+      }
+    }
+  }
+
+  TEST_F(RoutingEngineTest, Ends) {
+    RoutingEngine engine(graph);
+    RoutingEngine::Path path;
+    uint32_t edge = Edge(0, 0, 1, 0);
+    ASSERT_TRUE(engine.query(edge, edge, path));
+    EXPECT_EQ(1u, path.edges.size());
+    uint32_t next = Edge(1, 0, 2, 0);
+    ASSERT_TRUE(engine.query(edge, next, path));
+    EXPECT_EQ(2u, path.edges.size());
+    EXPECT_DOUBLE_EQ(graph.getStaticCost(edge) + graph.getStaticCost(next), path.cost);
+
+    // a junction without a way out
+    StringId deadEnd = intern("routing.deadEnd");
+    graph.addJunction(deadEnd, -100, 0);
+    uint32_t into = graph.addEdge(intern("routing.into"), intern(Junction(0, 0)), deadEnd);
+    graph.addLane(into, 100, 10);
+    RoutingEngine other(graph);
+    EXPECT_FALSE(other.query(into, edge, path));
+    std::vector<double> weights;
+    graph.getStaticCosts(weights);
+    EXPECT_FALSE(other.dijkstra(weights, into, edge, path));
+    ASSERT_TRUE(other.query(edge, into, path));
+    EXPECT_EQ(3u, path.edges.size());
+    EXPECT_TRUE(other.astar(weights, Edge(1, 0, 0, 0), into, path));
+    EXPECT_EQ("routing.1.0-routing.0.0 routing.into", other.toString(path));
+  }
+
+  TEST_F(RoutingEngineTest, Alternatives) {
+    RoutingEngine engine(graph);
+    std::vector<double> weights;
+    graph.getStaticCosts(weights);
+    uint32_t source = Edge(0, 0, 1, 0);
+    uint32_t target = Edge(side - 2, side - 1, side - 1, side - 1);
+    std::vector<RoutingEngine::Path> routes;
+    engine.getAlternatives(weights, source, target, 3, routes);
+    ASSERT_EQ(3u, routes.size());
+    RoutingEngine::Path shortest;
+    ASSERT_TRUE(engine.dijkstra(weights, source, target, shortest));
+    EXPECT_NEAR(shortest.cost, routes[0].cost, 1e-6);
+    for (size_t i = 0; i < routes.size(); ++i) {
+      ExpectValid(weights, source, target, routes[i]);
+      EXPECT_LE(routes[i].cost, 1.5 * routes[0].cost);
+      for (size_t j = 0; j < i; ++j) {
+        EXPECT_NE(routes[j].edges, routes[i].edges);
+      }
+    }
+    engine.getAlternatives(weights, source, source, 3, routes);
+    EXPECT_EQ(1u, routes.size());
+  }
+
+  /*
+   * Reroutes of the vehicles of a city between random edges, on a hierarchy
+   * customized with the travel times of the TIS. Only the queries are timed; the
+   * rate is reported as a property of the test and does not decide the result.
+   */
+  TEST_F(RoutingEngineTest, Throughput) {
+    RoutingEngine engine(graph);
+    std::vector<double> weights;
+    JamWeights(weights);
+    const int queries = 5000;
+    std::vector<uint32_t> ends;
+    for (int i = 0; i < 2 * queries; ++i) {
+      ends.push_back(RandomEdge());
+    }
+    engine.customize(weights);
+    RoutingEngine::Path path;
+    int found = 0;
+    clock_t start = clock();
+    for (int i = 0; i < queries; ++i) {
+      found += engine.query(ends[2 * i], ends[2 * i + 1], path) ? 1 : 0;
+    }
+    double seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+    EXPECT_EQ(queries, found);
+    RecordProperty("junctions", graph.getNumberOfJunctions());
+    RecordProperty("shortcuts", engine.getNumberOfShortcuts());
+    RecordProperty("reroutesPerSecond", (int) (queries / std::max(seconds, 1e-6)));
+  }
+}
@@ -0,0 +1,44 @@
+#include <sstream>
+#include "gtest/gtest.h"
+#include "stringInterner.h"
+
+using namespace ovnis;
+namespace {
+
+  TEST(StringInternerTest, SameStringSameHandle) {
+    StringId a = intern("56640728#1");
+    StringId b = intern("56640729#0");
+    EXPECT_NE(a, b);
+    EXPECT_EQ(a, intern(std::string("56640728#1")));
+    EXPECT_EQ("56640728#1", lookup(a));
+    EXPECT_EQ("56640729#0", lookup(b));
+  }
+
+  TEST(StringInternerTest, EmptyString) {
+    EXPECT_EQ(NO_STRING_ID, intern(""));
+    EXPECT_EQ("", lookup(NO_STRING_ID));
+  }
+
+  TEST(StringInternerTest, FindDoesNotIntern) {
+    StringInterner & interner = StringInterner::getInstance();
+    uint32_t size = interner.size();
+    StringId id;
+    EXPECT_FALSE(interner.find("never.interned", id));
+    EXPECT_EQ(size, interner.size());
+    StringId interned = intern("never.interned");
+    ASSERT_TRUE(interner.find("never.interned", id));
+    EXPECT_EQ(interned, id);
+  }
+
+  TEST(StringInternerTest, LookupsStayValid) {
+    // references must survive the growth of the table
+    const std::string & first = lookup(intern("0.0"));
+    for (int i = 0; i < 10000; ++i) {
+      std::ostringstream id;
+      id << "1." << i;
+      intern(id.str());
+    }
+    EXPECT_EQ("0.0", first);
+  }
+
+}